@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "coordinate.h"
+#include "ship_registry.h"
+
+using std::runtime_error;
+using std::vector;
+
+namespace battleships {
+
+    /**
+     * @brief Journal of the attacks made at a field since its checkpoints which allows to roll those back.
+     *
+     * An attack changes the field by discovering cells, which also removes them from the field's free cells,
+     * and by hitting a ship, so only those and the number of the alive ship cells at the checkpoints are recorded.
+     * Nothing is recorded while there are no checkpoints and the journal keeps its memory once rolled back
+     * so that it stops allocating once it has grown to the deepest search.
+     */
+    class AttackJournal {
+
+        struct Change {
+            Coordinate coordinate;
+            /**
+             * @brief Position of the discovered cell in the field's free cells or the id of the hit ship
+             */
+            uint32_t value;
+            bool hit;
+        };
+
+        struct Checkpoint {
+            size_t change_count;
+            size_t ship_cells_alive;
+        };
+
+        vector<Change> changes_;
+
+        vector<Checkpoint> checkpoints_;
+
+    public:
+
+        [[nodiscard]] inline bool is_recording() const noexcept {
+            return !checkpoints_.empty();
+        }
+
+        [[nodiscard]] inline size_t checkpoint_count() const noexcept {
+            return checkpoints_.size();
+        }
+
+        /**
+         * @brief Checks that the field may be changed by something other than attacks.
+         *
+         * @throws runtime_error if there are checkpoints which the change could not be rolled back to
+         */
+        inline void check_not_recording() const {
+            if (is_recording()) throw runtime_error("Ships cannot be placed while a checkpoint is pushed");
+        }
+
+        inline void push_checkpoint(const size_t &ship_cells_alive) {
+            checkpoints_.push_back({changes_.size(), ship_cells_alive});
+        }
+
+        /**
+         * @brief Records the discovery of the cell.
+         *
+         * @param coordinate coordinate of the discovered cell
+         * @param free_position position which the cell has been removed from in the field's free cells if it has any
+         */
+        inline void record_discovery(const Coordinate &coordinate, const uint32_t &free_position = 0) {
+            if (is_recording()) changes_.push_back({coordinate, free_position, false});
+        }
+
+        inline void record_hit(const ShipRegistry::Id &ship_id) {
+            if (is_recording()) changes_.push_back({Coordinate(0, 0), ship_id, true});
+        }
+
+        /**
+         * @brief Undoes the changes made since the last checkpoint in the reverse order and pops it.
+         *
+         * @param ships registry of the field's ships
+         * @param undiscover function making the cell at the given coordinate not discovered
+         * and returning it to the field's free cells at the given position
+         * @return number of the alive ship cells at the checkpoint
+         * @throws runtime_error if there are no checkpoints
+         */
+        template<typename U>
+        size_t rollback(ShipRegistry &ships, U &&undiscover) {
+            if (checkpoints_.empty()) throw runtime_error("There is no checkpoint to roll back to");
+
+            const auto checkpoint = checkpoints_.back();
+            checkpoints_.pop_back();
+            while (changes_.size() > checkpoint.change_count) {
+                const auto &change = changes_.back();
+                if (change.hit) ships.unhit(ShipRegistry::Id(change.value));
+                else undiscover(change.coordinate, change.value);
+                changes_.pop_back();
+            }
+
+            return checkpoint.ship_cells_alive;
+        }
+
+        /**
+         * @brief Drops all the checkpoints and the recorded changes.
+         */
+        inline void clear() noexcept {
+            changes_.clear();
+            checkpoints_.clear();
+        }
+    };
+}
@@ -0,0 +1,320 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "coordinate.h"
+
+using std::vector;
+
+namespace battleships {
+
+    /**
+     * @brief Packed set of field cells.
+     *
+     * Cells are stored row by row with a stride of {@code width + 1} bits,
+     * the extra guard column being always clear (once masked by {@link #mask_with})
+     * so that horizontal shifts never leak into the neighbouring row.
+     * A 10x10 field takes 110 bits, which is a single 128-bit pair of words.
+     */
+    class Bitboard {
+
+        size_t width_, height_, stride_;
+
+        vector<uint64_t> words_;
+
+    public:
+
+        Bitboard() : width_(0), height_(0), stride_(1) {}
+
+        Bitboard(const size_t &width, const size_t &height) :
+                width_(width), height_(height), stride_(width + 1),
+                words_((height * (width + 1) + 63) / 64, 0) {}
+
+        /**
+         * @brief Creates a bitboard with all the cells of the field set.
+         */
+        [[nodiscard]] static Bitboard full(const size_t &width, const size_t &height) {
+            Bitboard bitboard(width, height);
+            for (size_t y = 0; y < height; ++y) bitboard.set_run(bitboard.index_of(0, y), width);
+
+            return bitboard;
+        }
+
+        [[nodiscard]] inline size_t width() const noexcept {
+            return width_;
+        }
+
+        [[nodiscard]] inline size_t height() const noexcept {
+            return height_;
+        }
+
+        [[nodiscard]] inline size_t stride() const noexcept {
+            return stride_;
+        }
+
+        [[nodiscard]] inline size_t word_count() const noexcept {
+            return words_.size();
+        }
+
+        [[nodiscard]] inline const uint64_t *words() const noexcept {
+            return words_.data();
+        }
+
+        [[nodiscard]] inline uint64_t *words() noexcept {
+            return words_.data();
+        }
+
+        [[nodiscard]] inline size_t index_of(const size_t &x, const size_t &y) const noexcept {
+            return y * stride_ + x;
+        }
+
+        [[nodiscard]] inline size_t index_of(const Coordinate &coordinate) const noexcept {
+            return index_of(size_t(coordinate.x), size_t(coordinate.y));
+        }
+
+        [[nodiscard]] inline Coordinate coordinate_of(const size_t &index) const noexcept {
+            return Coordinate(int(index % stride_), int(index / stride_));
+        }
+
+        /*
+         * Single bit access
+         */
+
+        [[nodiscard]] inline bool test(const size_t &index) const noexcept {
+            return (words_[index >> 6u] >> (index & 63u)) & 1u;
+        }
+
+        [[nodiscard]] inline bool test(const size_t &x, const size_t &y) const noexcept {
+            return test(index_of(x, y));
+        }
+
+        inline void set(const size_t &index) noexcept {
+            words_[index >> 6u] |= uint64_t(1) << (index & 63u);
+        }
+
+        inline void set(const size_t &x, const size_t &y) noexcept {
+            set(index_of(x, y));
+        }
+
+        inline void reset(const size_t &index) noexcept {
+            words_[index >> 6u] &= ~(uint64_t(1) << (index & 63u));
+        }
+
+        /**
+         * @brief Sets the run of consecutive bits.
+         * @param from index of the first bit of the run
+         * @param count number of bits in the run
+         */
+        inline void set_run(const size_t &from, const size_t &count) noexcept {
+            auto index = from;
+            const auto end = from + count;
+            while (index < end) {
+                const auto bit = index & 63u, length = std::min<size_t>(64 - bit, end - index);
+                words_[index >> 6u] |= (length == 64 ? ~uint64_t(0) : (uint64_t(1) << length) - 1) << bit;
+                index += length;
+            }
+        }
+
+        /*
+         * Bulk operations
+         */
+
+        inline void clear() noexcept {
+            std::fill(words_.begin(), words_.end(), 0);
+        }
+
+        [[nodiscard]] inline bool any() const noexcept {
+            for (const auto word : words_) if (word) return true;
+            return false;
+        }
+
+        [[nodiscard]] inline bool none() const noexcept {
+            return !any();
+        }
+
+        [[nodiscard]] inline size_t count() const noexcept {
+            size_t count = 0;
+            for (const auto word : words_) count += std::popcount(word);
+
+            return count;
+        }
+
+        [[nodiscard]] inline bool intersects(const Bitboard &other) const noexcept {
+            for (size_t i = 0; i < words_.size(); ++i) if (words_[i] & other.words_[i]) return true;
+            return false;
+        }
+
+        inline Bitboard &operator|=(const Bitboard &other) noexcept {
+            for (size_t i = 0; i < words_.size(); ++i) words_[i] |= other.words_[i];
+            return *this;
+        }
+
+        inline Bitboard &operator&=(const Bitboard &other) noexcept {
+            for (size_t i = 0; i < words_.size(); ++i) words_[i] &= other.words_[i];
+            return *this;
+        }
+
+        inline void mask_with(const Bitboard &mask) noexcept {
+            *this &= mask;
+        }
+
+        inline void subtract(const Bitboard &other) noexcept {
+            for (size_t i = 0; i < words_.size(); ++i) words_[i] &= ~other.words_[i];
+        }
+
+        /**
+         * @brief Shifts all bits towards higher indices.
+         * @param shift number of bits to shift by
+         */
+        inline void shift_up(const size_t &shift) noexcept {
+            const auto size = words_.size();
+            const auto word_shift = shift >> 6u, bit_shift = shift & 63u;
+            for (size_t i = size; i-- > 0;) {
+                uint64_t word = 0;
+                if (i >= word_shift) {
+                    word = words_[i - word_shift] << bit_shift;
+                    if (bit_shift && i > word_shift) word |= words_[i - word_shift - 1] >> (64 - bit_shift);
+                }
+                words_[i] = word;
+            }
+        }
+
+        /**
+         * @brief Shifts all bits towards lower indices.
+         * @param shift number of bits to shift by
+         */
+        inline void shift_down(const size_t &shift) noexcept {
+            const auto size = words_.size();
+            const auto word_shift = shift >> 6u, bit_shift = shift & 63u;
+            for (size_t i = 0; i < size; ++i) {
+                uint64_t word = 0;
+                if (i + word_shift < size) {
+                    word = words_[i + word_shift] >> bit_shift;
+                    if (bit_shift && i + word_shift + 1 < size) word |= words_[i + word_shift + 1] << (64 - bit_shift);
+                }
+                words_[i] = word;
+            }
+        }
+
+        /**
+         * @brief Writes the 8-neighbourhood closure of this bitboard (i.e. the cells themselves with their halo)
+         * into the target bitboard.
+         *
+         * @param target bitboard to store the result in, should have the same dimensions
+         * @param scratch bitboard used for intermediate values, should have the same dimensions
+         * @param valid bitboard of all cells of the field used to clear guard bits
+         */
+        inline void dilate_into(Bitboard &target, Bitboard &scratch, const Bitboard &valid) const noexcept {
+            target.words_ = words_;
+            // closure of the row (`x - 1` and `x + 1`) followed by the closure of the column (`y - 1` and `y + 1`)
+            for (const auto shift : {size_t(1), stride_}) {
+                scratch.words_ = target.words_;
+                scratch.shift_up(shift);
+                target |= scratch;
+                // shifting the union back also restores the bits lost above
+                scratch.words_ = target.words_;
+                scratch.shift_down(shift);
+                target |= scratch;
+            }
+            target.mask_with(valid);
+        }
+
+        /**
+         * @brief Finds the first set bit at or after the given index.
+         * @param from index to start the lookup from
+         * @return index of the found bit or {@code npos} if there is none
+         */
+        [[nodiscard]] inline size_t find_next(const size_t &from) const noexcept {
+            return find_next_word(from, [this](const size_t &i) { return words_[i]; });
+        }
+
+        /**
+         * @brief Finds the first bit set in this bitboard but not in the other one at or after the given index.
+         * @param other bitboard whose bits are excluded
+         * @param from index to start the lookup from
+         * @return index of the found bit or {@code npos} if there is none
+         */
+        [[nodiscard]] inline size_t find_next_without(const Bitboard &other, const size_t &from) const noexcept {
+            return find_next_word(from, [this, &other](const size_t &i) { return words_[i] & ~other.words_[i]; });
+        }
+
+        /**
+         * @brief Finds the last set bit at or before the given index.
+         * @param from index to start the lookup from
+         * @return index of the found bit or {@code npos} if there is none
+         */
+        [[nodiscard]] inline size_t find_previous(const size_t &from) const noexcept {
+            return find_previous_word(from, [this](const size_t &i) { return words_[i]; });
+        }
+
+        /**
+         * @brief Finds the last bit set in this bitboard but not in the other one at or before the given index.
+         * @param other bitboard whose bits are excluded
+         * @param from index to start the lookup from
+         * @return index of the found bit or {@code npos} if there is none
+         */
+        [[nodiscard]] inline size_t find_previous_without(const Bitboard &other, const size_t &from) const noexcept {
+            return find_previous_word(from, [this, &other](const size_t &i) { return words_[i] & ~other.words_[i]; });
+        }
+
+        /**
+         * @brief Finds the set bit with the given ordinal.
+         * @param ordinal number of set bits preceding the found one
+         * @return index of the found bit or {@code npos} if there are not enough set bits
+         */
+        [[nodiscard]] inline size_t find_nth(size_t ordinal) const noexcept {
+            for (size_t word_index = 0; word_index < words_.size(); ++word_index) {
+                auto word = words_[word_index];
+                const auto word_count = size_t(std::popcount(word));
+                if (ordinal >= word_count) {
+                    ordinal -= word_count;
+                    continue;
+                }
+
+                while (ordinal-- != 0) word &= word - 1; // drop the lowest set bits
+                return (word_index << 6u) + std::countr_zero(word);
+            }
+
+            return npos;
+        }
+
+        constexpr static size_t npos = size_t(-1);
+
+    private:
+
+        template<typename W>
+        [[nodiscard]] inline size_t find_next_word(const size_t &from, const W &word_at) const noexcept {
+            auto word_index = from >> 6u;
+            if (word_index >= words_.size()) return npos;
+
+            auto word = word_at(word_index) & (~uint64_t(0) << (from & 63u));
+            while (true) {
+                if (word) return (word_index << 6u) + std::countr_zero(word);
+                if (++word_index == words_.size()) return npos;
+                word = word_at(word_index);
+            }
+        }
+
+        template<typename W>
+        [[nodiscard]] inline size_t find_previous_word(const size_t &from, const W &word_at) const noexcept {
+            if (words_.empty()) return npos;
+
+            auto word_index = from >> 6u;
+            uint64_t word;
+            if (word_index >= words_.size()) word = word_at(word_index = words_.size() - 1);
+            else {
+                word = word_at(word_index);
+                if ((from & 63u) != 63u) word &= (uint64_t(2) << (from & 63u)) - 1;
+            }
+            while (true) {
+                if (word) return (word_index << 6u) + 63 - std::countl_zero(word);
+                if (word_index-- == 0) return npos;
+                word = word_at(word_index);
+            }
+        }
+    };
+}
@@ -0,0 +1,227 @@
+#include "bitboard_game_field.h"
+
+#include "instrumentation.h"
+
+namespace battleships {
+
+    /*
+     * Construction and deconstruction
+     */
+
+    BitboardGameField::BitboardGameField(const GameConfiguration &configuration)
+            : configuration_(configuration),
+              valid_(Bitboard::full(configuration.field_width, configuration.field_height)),
+              ships_(configuration.field_width, configuration.field_height),
+              discovered_(configuration.field_width, configuration.field_height),
+              blocked_(configuration.field_width, configuration.field_height),
+              ship_ids_(configuration.field_height * valid_.stride(), ShipRegistry::NO_SHIP),
+              not_visited_(configuration.field_width, configuration.field_height),
+              ship_scratch_(configuration.field_width, configuration.field_height),
+              halo_scratch_(configuration.field_width, configuration.field_height),
+              shift_scratch_(configuration.field_width, configuration.field_height) {}
+
+    /*
+     * Data access
+     */
+
+    GameConfiguration BitboardGameField::get_configuration() const noexcept {
+        return configuration_;
+    }
+
+    /*
+     * Internal methods
+     */
+
+    void BitboardGameField::surround_destroyed_ship() {
+        ship_scratch_.dilate_into(halo_scratch_, shift_scratch_, valid_);
+        for (auto index = halo_scratch_.find_next_without(discovered_, 0); index != Bitboard::npos;
+             index = halo_scratch_.find_next_without(discovered_, index + 1)) {
+            const auto coordinate = valid_.coordinate_of(index);
+            journal_.record_discovery(coordinate, not_visited_.remove(coordinate));
+        }
+        discovered_ |= halo_scratch_;
+    }
+
+    bool BitboardGameField::attempt_destroy_ship(const size_t &index) {
+        const auto ship_id = ship_ids_[index];
+        journal_.record_hit(ship_id);
+        if (!registry_.hit(ship_id)) return false; // the ship is not yet fully destroyed
+
+        const auto &ship = registry_[ship_id];
+        ship_scratch_.clear();
+        for (size_t i = 0; i < ship.size; ++i) ship_scratch_.set(ships_.index_of(ship.cell(i)));
+
+        surround_destroyed_ship();
+
+        return true;
+    }
+
+    /*
+     * Game logic
+     */
+
+    GameField::AttackStatus BitboardGameField::attack_in_bounds(const Coordinate &coordinate) {
+        const auto index = discovered_.index_of(coordinate);
+        const auto ship = ships_.test(index);
+
+        if (discovered_.test(index)) return ship ? SHIP_ALREADY_ATTACKED : EMPTY_ALREADY_ATTACKED;
+        discovered_.set(index);
+        journal_.record_discovery(coordinate, not_visited_.remove(coordinate));
+
+        if (!ship) return MISS;
+
+        --ship_cells_alive_;
+
+        return attempt_destroy_ship(index) ? ship_cells_alive_ == 0 ? WIN : DESTROY_SHIP : DAMAGE_SHIP;
+    }
+
+    GameField::AttackStatus BitboardGameField::attack(const Coordinate &coordinate) {
+        BATTLESHIPS_INSTRUMENT(FIELD_ATTACK);
+        check_bounds(coordinate);
+
+        return attack_in_bounds(coordinate);
+    }
+
+    void BitboardGameField::attack_batch(const span<const Coordinate> coordinates, const span<AttackStatus> statuses) {
+        BATTLESHIPS_INSTRUMENT(FIELD_ATTACK_BATCH);
+        check_batch_size(coordinates, statuses);
+        for (const auto &coordinate : coordinates) check_bounds(coordinate);
+
+        for (size_t i = 0; i < coordinates.size(); ++i) statuses[i] = attack_in_bounds(coordinates[i]);
+    }
+
+    bool BitboardGameField::is_discovered(const Coordinate &coordinate) const {
+        check_bounds(coordinate);
+
+        return discovered_.test(discovered_.index_of(coordinate));
+    }
+
+    bool BitboardGameField::can_be_attacked(const Coordinate &coordinate) const {
+        return !is_out_of_bounds(coordinate) && !discovered_.test(discovered_.index_of(coordinate));
+    }
+
+    bool BitboardGameField::try_emplace_ship(const Coordinate &base_coordinate,
+                                             const Direction &direction, const size_t &size) {
+        BATTLESHIPS_INSTRUMENT(FIELD_TRY_EMPLACE_SHIP);
+        check_bounds(base_coordinate);
+        journal_.check_not_recording();
+
+        if (size != 1 && is_out_of_bounds(base_coordinate.move(direction, size - 1))) return false;
+
+        ship_scratch_.clear();
+        for (size_t i = 0; i < size; ++i) ship_scratch_.set(ships_.index_of(base_coordinate.move(direction, i)));
+
+        if (ship_scratch_.intersects(blocked_)) return false;
+
+        const auto ship_id = registry_.add(base_coordinate, direction, size);
+        for (size_t i = 0; i < size; ++i) ship_ids_[ships_.index_of(base_coordinate.move(direction, i))] = ship_id;
+
+        ships_ |= ship_scratch_;
+        ship_scratch_.dilate_into(halo_scratch_, shift_scratch_, valid_);
+        blocked_ |= halo_scratch_;
+        ship_cells_alive_ += size;
+
+        return true;
+    }
+
+    /*
+     * Misc
+     */
+
+    void BitboardGameField::draw_to(ConsoleFrame &frame) const {
+        const auto width = configuration_.field_width, height = configuration_.field_height;
+        string line;
+        // draw upper border
+        {
+            line = ' ';
+            auto letter = 'A';
+            for (size_t i = 0; i < width * 2 + 1; i++) line += i % 2 == 0 ? '|' : letter++;
+        }
+        frame.write(0, 0, line);
+
+        for (size_t y = 0; y < height; y++) {
+            line = to_string(y) + '|';
+            for (size_t x = 0; x < width; x++) (line += (ships_.test(x, y) ? '#' : '~')) += '|';
+            frame.write(0, y + 1, line);
+        }
+
+        // draw lower border
+        line = ' ';
+        for (size_t i = 0; i < width * 2 + 1; i++) line += "¯";
+        frame.write(0, height + 1, line);
+    }
+
+    char BitboardGameField::get_public_icon_at(const Coordinate &coordinate) const {
+        check_bounds(coordinate);
+
+        const auto index = discovered_.index_of(coordinate);
+
+        return discovered_.test(index) ? ships_.test(index) ? '#' : '~' : '.';
+    }
+
+    void BitboardGameField::get_public_icons(string &icons) const {
+        icons.resize(configuration_.field_width * configuration_.field_height);
+        for (size_t y = 0; y < configuration_.field_height; y++) for (size_t x = 0; x < configuration_.field_width; x++) {
+            const auto index = discovered_.index_of(x, y);
+            icons[y * configuration_.field_width + x] = discovered_.test(index) ? ships_.test(index) ? '#' : '~' : '.';
+        }
+    }
+
+    void BitboardGameField::locate_not_visited_spot(Coordinate &coordinate, Direction /* direction */,
+                                                    const bool &clockwise) const {
+        BATTLESHIPS_INSTRUMENT(FIELD_LOCATE_NOT_VISITED_SPOT);
+        if (!is_discovered(coordinate)) return;
+
+        // undiscovered cells of the field are the valid ones without the discovered ones
+        const auto start = valid_.index_of(coordinate);
+        auto index = clockwise
+                ? valid_.find_next_without(discovered_, start) : valid_.find_previous_without(discovered_, start);
+        if (index == Bitboard::npos) index = clockwise
+                ? valid_.find_next_without(discovered_, 0) : valid_.find_previous_without(discovered_, Bitboard::npos);
+        if (index == Bitboard::npos) throw runtime_error("The game has no free spots");
+
+        coordinate = valid_.coordinate_of(index);
+    }
+
+    void BitboardGameField::reset() noexcept {
+        ships_.clear();
+        discovered_.clear();
+        blocked_.clear();
+        // ids of the cells are only read for ship cells so those get overwritten by the next placements
+        registry_.clear();
+        not_visited_.reset();
+        ship_cells_alive_ = 0;
+        journal_.clear();
+    }
+
+    void BitboardGameField::push_checkpoint() {
+        journal_.push_checkpoint(ship_cells_alive_);
+    }
+
+    void BitboardGameField::rollback() {
+        ship_cells_alive_ = journal_.rollback(registry_, [this](const Coordinate &coordinate,
+                                                                const uint32_t &position) {
+            discovered_.reset(discovered_.index_of(coordinate));
+            not_visited_.restore(coordinate, position);
+        });
+    }
+
+    bool BitboardGameField::can_place_near(const Coordinate &coordinate) const {
+        return is_out_of_bounds(coordinate) || !ships_.test(ships_.index_of(coordinate));
+    }
+
+    bool BitboardGameField::can_place_at(const Coordinate &coordinate) const {
+        BATTLESHIPS_INSTRUMENT(FIELD_CAN_PLACE_AT);
+        check_bounds(coordinate);
+
+        return !blocked_.test(blocked_.index_of(coordinate));
+    }
+
+    size_t BitboardGameField::count_not_visited() const noexcept {
+        return not_visited_.size();
+    }
+
+    Coordinate BitboardGameField::random_not_visited_spot(RandomEngine &random) const {
+        return not_visited_.random(random);
+    }
+}
\ No newline at end of file
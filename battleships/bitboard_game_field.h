@@ -0,0 +1,182 @@
+#pragma once
+
+#include <string>
+
+#include "game_field.h"
+#include "game_configuration.h"
+#include "attack_journal.h"
+#include "coordinate.h"
+#include "bitboard.h"
+#include "ship_registry.h"
+#include "free_cell_index.h"
+
+using std::string;
+using std::to_string;
+
+namespace battleships {
+
+    /**
+     * @brief Game field storing its state as packed bitmasks.
+     *
+     * Unlike {@link SimpleGameField} this does not allocate an object per cell,
+     * so that all checks are performed as plain bit tests and neighbourhood updates are shift/mask operations.
+     */
+    class BitboardGameField final : public GameField {
+
+    protected:
+
+        const GameConfiguration configuration_;
+
+        /**
+         * @brief All cells of the field, used to clear the guard bits
+         */
+        const Bitboard valid_;
+
+        /**
+         * @brief Cells occupied by ships
+         */
+        Bitboard ships_;
+
+        /**
+         * @brief Cells which have been discovered
+         */
+        Bitboard discovered_;
+
+        /**
+         * @brief Cells at which no ship can be placed as those are occupied by ships or neighbour them
+         */
+        Bitboard blocked_;
+
+        /**
+         * @brief Ships placed at the field
+         */
+        ShipRegistry registry_;
+
+        /**
+         * @brief Ids of the ships occupying the cells by the cells' indices
+         */
+        vector<ShipRegistry::Id> ship_ids_;
+
+        /**
+         * @brief Cells which have not been discovered yet
+         */
+        FreeCellIndex not_visited_;
+
+        /**
+         * @brief Bitboards used for intermediate computations
+         */
+        Bitboard ship_scratch_, halo_scratch_, shift_scratch_;
+
+        size_t ship_cells_alive_ = 0;
+
+        AttackJournal journal_;
+
+        inline void check_bounds(const Coordinate &coordinate) const noexcept(false) {
+            if (is_out_of_bounds(coordinate))
+                throw out_of_range(
+                        "Coordinate (" + to_string(coordinate.x)
+                        + ":" + to_string(coordinate.y) + ") is out of its range"
+                );
+        }
+
+        /**
+         * @brief Discovers the halo of the ship currently stored in {@code ship_scratch_}.
+         */
+        inline void surround_destroyed_ship();
+
+        /**
+         * @brief Counts the hit of the ship cell with the given index destroying the ship if it has no cells left.
+         * @param index index of the cell attacked
+         * @return {@code true} if the ship was fully destroyed by the attack and {@code false} otherwise
+         */
+        inline bool attempt_destroy_ship(const size_t &index);
+
+        /**
+         * @brief Attacks the cell which is known to be in bounds.
+         *
+         * @param coordinate coordinate of the attacked cell
+         * @return result of the attack
+         */
+        inline AttackStatus attack_in_bounds(const Coordinate &coordinate);
+
+    public:
+
+        /*
+         * Construction and deconstruction
+         */
+
+        explicit BitboardGameField(const GameConfiguration &configuration);
+
+        /*
+         * Data access
+         */
+
+        [[nodiscard]] GameConfiguration get_configuration() const noexcept override;
+
+        /*
+         * Game logic
+         */
+
+        [[nodiscard]] bool is_discovered(const Coordinate &coordinate) const override;
+
+        [[nodiscard]] bool can_be_attacked(const Coordinate &coordinate) const override;
+
+        [[nodiscard]] bool can_place_near(const Coordinate &coordinate) const override;
+
+        bool try_emplace_ship(const Coordinate &base_coordinate,
+                              const Direction &direction, const size_t &size) override;
+
+        AttackStatus attack(const Coordinate &coordinate) override;
+
+        void attack_batch(span<const Coordinate> coordinates, span<AttackStatus> statuses) override;
+
+        /*
+         * Misc
+         */
+
+        void draw_to(ConsoleFrame &frame) const override;
+
+        [[nodiscard]] char get_public_icon_at(const Coordinate &coordinate) const override;
+
+        void get_public_icons(string &icons) const override;
+
+        [[nodiscard]] inline bool is_in_bounds(const Coordinate &coordinate) const noexcept override {
+            return (0 <= coordinate.x && coordinate.x < configuration_.field_width)
+                   && (0 <= coordinate.y && coordinate.y < configuration_.field_height);
+        }
+
+        [[nodiscard]] inline bool is_out_of_bounds(const Coordinate &coordinate) const noexcept override {
+            return (coordinate.x < 0 || configuration_.field_width <= coordinate.x)
+                   || (coordinate.y < 0 || configuration_.field_height <= coordinate.y);
+        }
+
+        void reset() noexcept override;
+
+        void push_checkpoint() override;
+
+        void rollback() override;
+
+        [[nodiscard]] bool can_place_at(const Coordinate &coordinate) const override;
+
+        /**
+         * @brief Locates the closest undiscovered cell by scanning the field row by row.
+         *
+         * @param coordinate coordinate to start the lookup from which will be updated to the located one
+         * @param direction ignored as the scan is performed by whole words
+         * @param clockwise {@code true} to scan forwards and {@code false} to scan backwards
+         */
+        void locate_not_visited_spot(Coordinate &coordinate, Direction direction, const bool &clockwise) const override;
+
+        [[nodiscard]] size_t count_not_visited() const noexcept override;
+
+        [[nodiscard]] Coordinate random_not_visited_spot(RandomEngine &random) const override;
+
+        [[nodiscard]] const ShipRegistry &get_ships() const noexcept override {
+            return registry_;
+        }
+
+        [[nodiscard]] GameField *clone() const override {
+            return new BitboardGameField(*this);
+        }
+    };
+}
@@ -0,0 +1,82 @@
+#include "bot_scheduler.h"
+
+#include <stdexcept>
+#include <string>
+
+using std::out_of_range;
+using std::runtime_error;
+
+namespace battleships {
+
+    size_t BotScheduler::add_game(CoroutineRivalBot &first, GameField *const first_rival_field,
+                                  CoroutineRivalBot &second, GameField *const second_rival_field,
+                                  const size_t &turn_limit,
+                                  RivalBot::AttackCallback *const first_observer,
+                                  RivalBot::AttackCallback *const second_observer) {
+        auto &game = games_.emplace_back();
+        game.bots[0] = &first;
+        game.bots[1] = &second;
+        game.rival_fields[0] = first_rival_field;
+        game.rival_fields[1] = second_rival_field;
+        game.observers[0] = RivalBot::EmptyAttackCallback::or_empty(first_observer);
+        game.observers[1] = RivalBot::EmptyAttackCallback::or_empty(second_observer);
+        game.turn_limit = turn_limit;
+
+        return games_.size() - 1;
+    }
+
+    void BotScheduler::play_shot(ScheduledGame &game) {
+        if (game.turn >= game.turn_limit)
+            throw runtime_error("Game has not finished in " + std::to_string(game.turn_limit) + " turns");
+
+        const auto bot = game.turn % 2;
+        auto &shots = game.shots[bot];
+        if (!shots) shots.emplace(game.bots[bot]->shots());
+        if (shots->done()) throw runtime_error("Bot has ended without winning");
+
+        const auto attacked_coordinate = shots->target();
+        const auto attack_status = game.rival_fields[bot]->attack(attacked_coordinate);
+        ++game.shot_counts[bot];
+        game.observers[bot]->on_attack(attacked_coordinate, attack_status);
+
+        switch (attack_status) {
+            case GameField::MISS: {
+                ++game.turn;
+                break;
+            }
+            case GameField::WIN: {
+                game.result = SelfPlayResult{bot == 0, game.shot_counts[0], game.shot_counts[1]};
+                // the coroutines are not needed once the game is over
+                game.shots[0].reset();
+                game.shots[1].reset();
+                return;
+            }
+            default: break;
+        }
+
+        shots->resolve(attack_status);
+    }
+
+    void BotScheduler::run() {
+        bool unfinished = true;
+        while (unfinished) {
+            unfinished = false;
+            for (auto &game : games_) {
+                if (game.result) continue;
+
+                play_shot(game);
+                unfinished |= !game.result;
+            }
+        }
+    }
+
+    const optional<SelfPlayResult> &BotScheduler::result(const size_t &game) const {
+        if (game >= games_.size()) throw out_of_range("There is no game #" + std::to_string(game));
+
+        return games_[game].result;
+    }
+
+    void BotScheduler::clear() noexcept {
+        games_.clear();
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "coroutine_rival_bot.h"
+#include "game_field.h"
+#include "self_play.h"
+#include "shot_stream.h"
+
+using std::optional;
+using std::vector;
+
+namespace battleships {
+
+    /**
+     * @brief Scheduler playing many games of the coroutine bots at once on the calling thread.
+     *
+     * The games are interleaved shot by shot: each sweep over the games resolves a single shot of the bot
+     * whose turn it is in every unfinished game, so the bots waiting for their results stay suspended
+     * instead of each game occupying a thread until it ends. The scheduler is not thread-safe
+     * and a separate one should be used by each thread.
+     */
+    class BotScheduler {
+
+        /**
+         * @brief Game played by the scheduler
+         */
+        struct ScheduledGame {
+
+            CoroutineRivalBot *bots[2];
+
+            /**
+             * @brief Fields attacked by the bots of the same indices
+             */
+            GameField *rival_fields[2];
+
+            RivalBot::AttackCallback *observers[2];
+
+            /**
+             * @brief Shots of the bots started by their first shots
+             */
+            optional<ShotStream> shots[2];
+
+            size_t shot_counts[2] = {0, 0};
+
+            size_t turn = 0, turn_limit;
+
+            optional<SelfPlayResult> result;
+        };
+
+        vector<ScheduledGame> games_;
+
+        /**
+         * @brief Resolves the next shot of the game.
+         *
+         * @param game unfinished game
+         * @throws runtime_error if the game has reached its turn limit or if its bot has ended before winning
+         */
+        static void play_shot(ScheduledGame &game);
+
+    public:
+
+        /**
+         * @brief Adds a game between the two bots whose ships are expected to be already placed.
+         * The first bot makes the first turn. The bots, the fields and the observers should outlive the game.
+         *
+         * @param first bot playing first
+         * @param first_rival_field field attacked by the first bot
+         * @param second bot playing second
+         * @param second_rival_field field attacked by the second bot
+         * @param turn_limit maximal number of turns after which the game is considered broken
+         * @param first_observer optional callback notified on attacks of the first bot
+         * @param second_observer optional callback notified on attacks of the second bot
+         * @return index of the added game
+         */
+        size_t add_game(CoroutineRivalBot &first, GameField *first_rival_field,
+                        CoroutineRivalBot &second, GameField *second_rival_field, const size_t &turn_limit,
+                        RivalBot::AttackCallback *first_observer = nullptr,
+                        RivalBot::AttackCallback *second_observer = nullptr);
+
+        /**
+         * @brief Plays all of the added games until those end.
+         *
+         * @throws runtime_error if any of the games has not finished in its turn limit
+         * or if any of the bots has ended before winning
+         */
+        void run();
+
+        /**
+         * @brief Gets the result of the game.
+         *
+         * @param game index of the game
+         * @return result of the game or an empty optional if the game has not ended yet
+         * @throws out_of_range if there is no game with the given index
+         */
+        [[nodiscard]] const optional<SelfPlayResult> &result(const size_t &game) const;
+
+        [[nodiscard]] size_t size() const noexcept {
+            return games_.size();
+        }
+
+        /**
+         * @brief Removes all of the games destroying the coroutines of the bots.
+         */
+        void clear() noexcept;
+    };
+}
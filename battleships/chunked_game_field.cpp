@@ -0,0 +1,299 @@
+#include "chunked_game_field.h"
+
+#include <algorithm>
+#include <bit>
+#include <random>
+
+#include "instrumentation.h"
+
+using std::uniform_int_distribution;
+
+namespace battleships {
+
+    /*
+     * Construction and deconstruction
+     */
+
+    ChunkedGameField::ChunkedGameField(const GameConfiguration &configuration)
+            : configuration_(configuration),
+              chunk_columns_((configuration.field_width + CHUNK_SIZE - 1) / CHUNK_SIZE),
+              chunk_rows_((configuration.field_height + CHUNK_SIZE - 1) / CHUNK_SIZE) {}
+
+    /*
+     * Data access
+     */
+
+    GameConfiguration ChunkedGameField::get_configuration() const noexcept {
+        return configuration_;
+    }
+
+    /*
+     * Internal methods
+     */
+
+    void ChunkedGameField::try_make_discovered(const Coordinate &coordinate) {
+        if (is_out_of_bounds(coordinate)) return;
+
+        auto &chunk = get_chunk(coordinate);
+        const auto row = row_of(coordinate), bit = bit_of(coordinate);
+        if ((chunk.ships[row] | chunk.discovered[row]) & bit) return;
+
+        chunk.discovered[row] |= bit;
+        ++discovered_count_;
+        journal_.record_discovery(coordinate);
+    }
+
+    bool ChunkedGameField::attempt_destroy_ship(const Coordinate &coordinate) {
+        const auto ship_id = ship_ids_.at(cell_number_of(coordinate));
+        journal_.record_hit(ship_id);
+        if (!registry_.hit(ship_id)) return false; // the ship is not yet fully destroyed
+
+        // all the cells of the ship have already been discovered by the attacks
+        const auto &ship = registry_[ship_id];
+        for (size_t i = 0; i < ship.size; ++i) {
+            const auto cell = ship.cell(i);
+            for (const auto &direction : ALL_DIRECTIONS) {
+                const auto neighbour = cell.move(direction, 1);
+                try_make_discovered(neighbour);
+                try_make_discovered(neighbour.move(rotate_direction_clockwise(direction), 1));
+            }
+        }
+
+        return true;
+    }
+
+    Coordinate ChunkedGameField::nth_not_visited(size_t index) const {
+        const auto width = configuration_.field_width, height = configuration_.field_height;
+        for (uint64_t number = 0; number < chunk_rows_ * chunk_columns_; ++number) {
+            const auto left = number % chunk_columns_ * CHUNK_SIZE, top = number / chunk_columns_ * CHUNK_SIZE;
+            const auto chunk_width = std::min(CHUNK_SIZE, width - left),
+                    chunk_height = std::min(CHUNK_SIZE, height - top);
+
+            const auto chunk = chunks_.find(number);
+            if (chunk == chunks_.end()) {
+                if (index < chunk_width * chunk_height)
+                    return Coordinate(int(left + index % chunk_width), int(top + index / chunk_width));
+                index -= chunk_width * chunk_height;
+                continue;
+            }
+
+            const auto row_mask = chunk_width == CHUNK_SIZE ? ~uint64_t(0) : (uint64_t(1) << chunk_width) - 1;
+            for (size_t row = 0; row < chunk_height; ++row) {
+                auto free = ~chunk->second.discovered[row] & row_mask;
+                const auto free_count = size_t(std::popcount(free));
+                if (index >= free_count) {
+                    index -= free_count;
+                    continue;
+                }
+
+                for (; index != 0; --index) free &= free - 1;
+                return Coordinate(int(left + size_t(std::countr_zero(free))), int(top + row));
+            }
+        }
+
+        throw runtime_error("The game has no free spots");
+    }
+
+    /*
+     * Game logic
+     */
+
+    GameField::AttackStatus ChunkedGameField::attack(const Coordinate &coordinate) {
+        BATTLESHIPS_INSTRUMENT(FIELD_ATTACK);
+        check_bounds(coordinate);
+
+        auto &chunk = get_chunk(coordinate);
+        const auto row = row_of(coordinate), bit = bit_of(coordinate);
+        const auto ship = (chunk.ships[row] & bit) != 0;
+
+        if (chunk.discovered[row] & bit) return ship ? SHIP_ALREADY_ATTACKED : EMPTY_ALREADY_ATTACKED;
+        chunk.discovered[row] |= bit;
+        ++discovered_count_;
+        journal_.record_discovery(coordinate);
+
+        if (!ship) return MISS;
+
+        --ship_cells_alive_;
+
+        return attempt_destroy_ship(coordinate) ? ship_cells_alive_ == 0 ? WIN : DESTROY_SHIP : DAMAGE_SHIP;
+    }
+
+    bool ChunkedGameField::is_discovered(const Coordinate &coordinate) const {
+        check_bounds(coordinate);
+
+        return is_discovered_at(coordinate);
+    }
+
+    bool ChunkedGameField::can_be_attacked(const Coordinate &coordinate) const {
+        return !is_out_of_bounds(coordinate) && !is_discovered_at(coordinate);
+    }
+
+    bool ChunkedGameField::try_emplace_ship(const Coordinate &base_coordinate,
+                                            const Direction &direction, const size_t &size) {
+        BATTLESHIPS_INSTRUMENT(FIELD_TRY_EMPLACE_SHIP);
+        check_bounds(base_coordinate);
+        journal_.check_not_recording();
+
+        if (size != 1 && is_out_of_bounds(base_coordinate.move(direction, static_cast<int>(size) - 1))) return false;
+        for (size_t i = 0; i < size; ++i) if (!can_place_at(base_coordinate.move(direction, static_cast<int>(i))))
+            return false;
+
+        const auto ship_id = registry_.add(base_coordinate, direction, size);
+        for (size_t i = 0; i < size; ++i) {
+            const auto cell = base_coordinate.move(direction, static_cast<int>(i));
+            get_chunk(cell).ships[row_of(cell)] |= bit_of(cell);
+            ship_ids_[cell_number_of(cell)] = ship_id;
+        }
+        ship_cells_alive_ += size;
+
+        return true;
+    }
+
+    /*
+     * Misc
+     */
+
+    void ChunkedGameField::draw_to(ConsoleFrame &frame) const {
+        const auto width = configuration_.field_width, height = configuration_.field_height;
+        string line;
+        // draw upper border
+        {
+            line = ' ';
+            auto letter = 'A';
+            for (size_t i = 0; i < width * 2 + 1; i++) line += i % 2 == 0 ? '|' : letter++;
+        }
+        frame.write(0, 0, line);
+
+        for (size_t y = 0; y < height; y++) {
+            line = to_string(y) + '|';
+            for (size_t x = 0; x < width; x++) (line += is_ship_at(Coordinate(int(x), int(y))) ? '#' : '~') += '|';
+            frame.write(0, y + 1, line);
+        }
+
+        // draw lower border
+        line = ' ';
+        for (size_t i = 0; i < width * 2 + 1; i++) line += "¯";
+        frame.write(0, height + 1, line);
+    }
+
+    char ChunkedGameField::get_public_icon_at(const Coordinate &coordinate) const {
+        check_bounds(coordinate);
+
+        return is_discovered_at(coordinate) ? is_ship_at(coordinate) ? '#' : '~' : '.';
+    }
+
+    void ChunkedGameField::get_public_icons(string &icons) const {
+        const auto width = configuration_.field_width, height = configuration_.field_height;
+        icons.assign(width * height, '.');
+        // only the stored chunks may have discovered cells
+        for (const auto &[number, chunk] : chunks_) {
+            const auto left = number % chunk_columns_ * CHUNK_SIZE, top = number / chunk_columns_ * CHUNK_SIZE;
+            for (size_t row = 0; row < CHUNK_SIZE; ++row) for (auto discovered = chunk.discovered[row];
+                                                               discovered != 0; discovered &= discovered - 1) {
+                const auto column = size_t(std::countr_zero(discovered));
+                icons[(top + row) * width + left + column] = chunk.ships[row] >> column & 1 ? '#' : '~';
+            }
+        }
+    }
+
+    void ChunkedGameField::locate_not_visited_spot(Coordinate &coordinate, Direction direction,
+                                                   const bool &clockwise) const {
+        BATTLESHIPS_INSTRUMENT(FIELD_LOCATE_NOT_VISITED_SPOT);
+        if (is_discovered(coordinate)) {
+            size_t step_count = 0;
+
+            bool last_was_without_steps = false;
+            while (true) { // this will finally fail
+                ++step_count;
+                bool made_no_steps = true;
+
+                for (size_t attempt = 0; attempt < 2; attempt++) {
+                    for (size_t i = 0; i < step_count; i++) {
+                        coordinate.move(direction, step_count);
+                        if (is_in_bounds(coordinate)) {
+                            if (!is_discovered_at(coordinate)) return;
+                            made_no_steps = false;
+                        } else coordinate.move(direction, -step_count); // undo
+                    }
+
+                    // make a rotation
+                    direction = clockwise ? rotate_direction_clockwise(direction) : rotate_direction_counter_clockwise(
+                            direction);
+                }
+
+                // the spiral has left the field so the first free cell is taken
+                if (made_no_steps) {
+                    if (last_was_without_steps) {
+                        coordinate = nth_not_visited(0);
+                        return;
+                    }
+
+                    last_was_without_steps = true;
+                } else last_was_without_steps = false;
+            }
+        }
+    }
+
+    void ChunkedGameField::reset() noexcept {
+        chunks_.clear();
+        ship_ids_.clear();
+        registry_.clear();
+        discovered_count_ = 0;
+        ship_cells_alive_ = 0;
+        journal_.clear();
+    }
+
+    void ChunkedGameField::push_checkpoint() {
+        journal_.push_checkpoint(ship_cells_alive_);
+    }
+
+    void ChunkedGameField::rollback() {
+        ship_cells_alive_ = journal_.rollback(registry_, [this](const Coordinate &coordinate, const uint32_t &) {
+            get_chunk(coordinate).discovered[row_of(coordinate)] &= ~bit_of(coordinate);
+            --discovered_count_;
+        });
+    }
+
+    bool ChunkedGameField::can_place_near(const Coordinate &coordinate) const {
+        return is_out_of_bounds(coordinate) || !is_ship_at(coordinate);
+    }
+
+    bool ChunkedGameField::can_place_at(const Coordinate &coordinate) const {
+        BATTLESHIPS_INSTRUMENT(FIELD_CAN_PLACE_AT);
+        check_bounds(coordinate);
+
+        if (is_ship_at(coordinate)) return false;
+
+        // check each side
+        for (const auto &tested_direction : ALL_DIRECTIONS) {
+            auto tested_coordinate = coordinate;
+
+            tested_coordinate.move(tested_direction, 1);
+            if (!can_place_near(tested_coordinate)) return false;
+
+            tested_coordinate.move(rotate_direction_clockwise(tested_direction), 1);
+            if (!can_place_near(tested_coordinate)) return false;
+        }
+
+        return true;
+    }
+
+    size_t ChunkedGameField::count_not_visited() const noexcept {
+        return configuration_.field_width * configuration_.field_height - discovered_count_;
+    }
+
+    Coordinate ChunkedGameField::random_not_visited_spot(RandomEngine &random) const {
+        const auto free_cells = count_not_visited();
+        if (free_cells == 0) throw runtime_error("The game has no free spots");
+
+        // most of a large field stays undiscovered so that a random cell is usually a free one
+        uniform_int_distribution<int> x_distribution(0, int(configuration_.field_width) - 1),
+                y_distribution(0, int(configuration_.field_height) - 1);
+        for (size_t attempt = 0; attempt < SAMPLING_ATTEMPTS; ++attempt) {
+            const Coordinate coordinate(x_distribution(random), y_distribution(random));
+            if (!is_discovered_at(coordinate)) return coordinate;
+        }
+
+        return nth_not_visited(uniform_int_distribution<size_t>(0, free_cells - 1)(random));
+    }
+}
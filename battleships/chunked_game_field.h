@@ -0,0 +1,233 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "attack_journal.h"
+#include "coordinate.h"
+#include "game_configuration.h"
+#include "game_field.h"
+#include "ship_registry.h"
+
+using std::array;
+using std::string;
+using std::to_string;
+using std::unordered_map;
+
+namespace battleships {
+
+    /**
+     * @brief Game field of a very large size with comparatively few ships and shots.
+     *
+     * The field is split into square chunks which are only stored once any of their cells gets a ship
+     * or gets discovered, the cells of the missing chunks being empty and not discovered. Thus the memory taken
+     * by the field is proportional to the number of the ships and the shots rather than to the field's area.
+     * The free cells are not indexed so the random ones are picked by sampling, which is fast as long as
+     * most of the field stays undiscovered. Drawing the field or getting all of its icons takes time
+     * proportional to its area.
+     */
+    class ChunkedGameField : public GameField {
+
+    public:
+
+        /**
+         * @brief Width and height of a chunk in cells, a row of a chunk is stored as a single word
+         */
+        constexpr static size_t CHUNK_SIZE = 64;
+
+        /**
+         * @brief Memory taken by the cells of a stored chunk
+         */
+        constexpr static size_t CHUNK_BYTES = 2 * CHUNK_SIZE * sizeof(uint64_t);
+
+    protected:
+
+        /**
+         * @brief Random cells tried when picking a free one before those are counted to pick it exactly
+         */
+        constexpr static size_t SAMPLING_ATTEMPTS = 64;
+
+        struct Chunk {
+            /**
+             * @brief Bit sets of the ship cells and the discovered ones by the rows of the chunk,
+             * the lowest bit being the leftmost cell
+             */
+            array<uint64_t, CHUNK_SIZE> ships{}, discovered{};
+        };
+
+        static_assert(sizeof(Chunk) == CHUNK_BYTES);
+
+        const GameConfiguration configuration_;
+
+        const size_t chunk_columns_, chunk_rows_;
+
+        /**
+         * @brief Stored chunks by their numbers (i.e. {@code chunk_y * chunk_columns + chunk_x})
+         */
+        unordered_map<uint64_t, Chunk> chunks_;
+
+        /**
+         * @brief Ids of the ships occupying the cells by the cells' numbers (i.e. {@code y * width + x})
+         */
+        unordered_map<uint64_t, ShipRegistry::Id> ship_ids_;
+
+        ShipRegistry registry_;
+
+        size_t discovered_count_ = 0;
+
+        size_t ship_cells_alive_ = 0;
+
+        AttackJournal journal_;
+
+        inline void check_bounds(const Coordinate &coordinate) const noexcept(false) {
+            if (is_out_of_bounds(coordinate))
+                throw out_of_range(
+                        "Coordinate (" + to_string(coordinate.x)
+                        + ":" + to_string(coordinate.y) + ") is out of its range"
+                );
+        }
+
+        [[nodiscard]] inline uint64_t chunk_number_of(const Coordinate &coordinate) const noexcept {
+            return uint64_t(coordinate.y) / CHUNK_SIZE * chunk_columns_ + uint64_t(coordinate.x) / CHUNK_SIZE;
+        }
+
+        [[nodiscard]] inline uint64_t cell_number_of(const Coordinate &coordinate) const noexcept {
+            return uint64_t(coordinate.y) * configuration_.field_width + uint64_t(coordinate.x);
+        }
+
+        [[nodiscard]] inline static uint64_t bit_of(const Coordinate &coordinate) noexcept {
+            return uint64_t(1) << (size_t(coordinate.x) % CHUNK_SIZE);
+        }
+
+        [[nodiscard]] inline static size_t row_of(const Coordinate &coordinate) noexcept {
+            return size_t(coordinate.y) % CHUNK_SIZE;
+        }
+
+        /**
+         * @brief Finds the chunk of the cell in the bounds of the field.
+         *
+         * @return chunk of the cell or {@code nullptr} if it is not stored
+         */
+        [[nodiscard]] inline const Chunk *find_chunk(const Coordinate &coordinate) const {
+            const auto chunk = chunks_.find(chunk_number_of(coordinate));
+            return chunk == chunks_.end() ? nullptr : &chunk->second;
+        }
+
+        /**
+         * @brief Gets the chunk of the cell in the bounds of the field storing an empty one if it is not stored.
+         */
+        [[nodiscard]] inline Chunk &get_chunk(const Coordinate &coordinate) {
+            return chunks_[chunk_number_of(coordinate)];
+        }
+
+        [[nodiscard]] inline bool is_ship_at(const Coordinate &coordinate) const {
+            const auto chunk = find_chunk(coordinate);
+            return chunk != nullptr && (chunk->ships[row_of(coordinate)] & bit_of(coordinate));
+        }
+
+        [[nodiscard]] inline bool is_discovered_at(const Coordinate &coordinate) const {
+            const auto chunk = find_chunk(coordinate);
+            return chunk != nullptr && (chunk->discovered[row_of(coordinate)] & bit_of(coordinate));
+        }
+
+        inline void try_make_discovered(const Coordinate &coordinate);
+
+        /**
+         * @brief Counts the hit of the ship cell at the given point destroying the ship if it has no cells left.
+         * @param coordinate coordinate of the point attacked
+         * @return {@code true} if the ship was fully destroyed by the attack and {@code false} otherwise
+         */
+        inline bool attempt_destroy_ship(const Coordinate &coordinate);
+
+        /**
+         * @brief Finds the free cell by its index in the order of the chunks and of the cells in those.
+         *
+         * @param index index of the free cell less than the number of those
+         * @return coordinate of the free cell
+         */
+        [[nodiscard]] Coordinate nth_not_visited(size_t index) const;
+
+    public:
+
+        /*
+         * Construction and deconstruction
+         */
+
+        explicit ChunkedGameField(const GameConfiguration &configuration);
+
+        /*
+         * Data access
+         */
+
+        [[nodiscard]] GameConfiguration get_configuration() const noexcept override;
+
+        /**
+         * @brief Gets the number of the stored chunks each of which takes {@code CHUNK_BYTES} bytes.
+         *
+         * @return number of the stored chunks
+         */
+        [[nodiscard]] size_t chunk_count() const noexcept {
+            return chunks_.size();
+        }
+
+        /*
+         * Game logic
+         */
+
+        [[nodiscard]] bool is_discovered(const Coordinate &coordinate) const override;
+
+        [[nodiscard]] bool can_be_attacked(const Coordinate &coordinate) const override;
+
+        [[nodiscard]] bool can_place_near(const Coordinate &coordinate) const override;
+
+        bool try_emplace_ship(const Coordinate &base_coordinate,
+                              const Direction &direction, const size_t &size) override;
+
+        AttackStatus attack(const Coordinate &coordinate) override;
+
+        /*
+         * Misc
+         */
+
+        void draw_to(ConsoleFrame &frame) const override;
+
+        [[nodiscard]] char get_public_icon_at(const Coordinate &coordinate) const override;
+
+        void get_public_icons(string &icons) const override;
+
+        [[nodiscard]] inline bool is_in_bounds(const Coordinate &coordinate) const noexcept override {
+            return (0 <= coordinate.x && coordinate.x < configuration_.field_width)
+                   && (0 <= coordinate.y && coordinate.y < configuration_.field_height);
+        }
+
+        [[nodiscard]] inline bool is_out_of_bounds(const Coordinate &coordinate) const noexcept override {
+            return (coordinate.x < 0 || configuration_.field_width <= coordinate.x)
+                   || (coordinate.y < 0 || configuration_.field_height <= coordinate.y);
+        }
+
+        void reset() noexcept override;
+
+        void push_checkpoint() override;
+
+        void rollback() override;
+
+        [[nodiscard]] bool can_place_at(const Coordinate &coordinate) const override;
+
+        void locate_not_visited_spot(Coordinate &coordinate, Direction direction, const bool &clockwise) const override;
+
+        [[nodiscard]] size_t count_not_visited() const noexcept override;
+
+        [[nodiscard]] Coordinate random_not_visited_spot(RandomEngine &random) const override;
+
+        [[nodiscard]] const ShipRegistry &get_ships() const noexcept override {
+            return registry_;
+        }
+
+        [[nodiscard]] GameField *clone() const override {
+            return new ChunkedGameField(*this);
+        }
+    };
+}
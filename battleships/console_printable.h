@@ -1,6 +1,9 @@
 #pragma once
 
 #include <iostream>
+#include <string>
+
+#include "console_renderer.h"
 
 using std::cout;
 using std::endl;
@@ -9,6 +12,26 @@ namespace battleships {
     class ConsolePrintable {
 
     public:
-        virtual void print_to_console() const noexcept = 0;
+        virtual ~ConsolePrintable() = default;
+
+        /**
+         * @brief Draws this object into the frame starting from its upper left corner.
+         *
+         * @param frame frame to draw into
+         */
+        virtual void draw_to(ConsoleFrame &frame) const = 0;
+
+        /**
+         * @brief Prints this object to the console by a single write.
+         */
+        virtual void print_to_console() const noexcept {
+            ConsoleFrame frame;
+            draw_to(frame);
+
+            std::string buffer;
+            frame.append_to(buffer);
+            cout.write(buffer.data(), std::streamsize(buffer.size()));
+            cout.flush();
+        }
     };
 }
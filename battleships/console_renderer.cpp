@@ -0,0 +1,136 @@
+#include "console_renderer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "console_printable.h"
+
+namespace battleships {
+
+    /*
+     * Frame
+     */
+
+    void ConsoleFrame::put(const size_t &x, const size_t &y, const char &character) {
+        if (y >= lines_.size()) lines_.resize(y + 1);
+        auto &line = lines_[y];
+        if (x >= line.size()) line.resize(x + 1, SPACE);
+
+        line[x] = Glyph(static_cast<unsigned char>(character));
+    }
+
+    size_t ConsoleFrame::write(size_t x, const size_t &y, const string_view &text) {
+        if (y >= lines_.size()) lines_.resize(y + 1);
+        auto &line = lines_[y];
+
+        for (size_t i = 0; i < text.size(); ++x) {
+            // the length of the UTF-8 sequence is given by the leading ones of its first byte
+            const auto first = static_cast<unsigned char>(text[i]);
+            const size_t length = first < 0x80u ? 1 : first < 0xE0u ? 2 : first < 0xF0u ? 3 : 4;
+
+            Glyph glyph = 0;
+            for (size_t j = 0; j < length && i < text.size(); ++j, ++i)
+                glyph |= Glyph(static_cast<unsigned char>(text[i])) << (j * 8);
+
+            if (x >= line.size()) line.resize(x + 1, SPACE);
+            line[x] = glyph;
+        }
+
+        return x;
+    }
+
+    void ConsoleFrame::append_to(string &buffer) const {
+        for (const auto &line : lines_) {
+            for (const auto &glyph : line) append_glyph(glyph, buffer);
+            buffer += '\n';
+        }
+    }
+
+    void ConsoleFrame::append_glyph(Glyph glyph, string &buffer) {
+        do {
+            buffer += char(glyph & 0xFFu);
+            glyph >>= 8u;
+        } while (glyph != 0);
+    }
+
+    /*
+     * Renderer
+     */
+
+    void ConsoleRenderer::append_cursor_move(const size_t &x, const size_t &y) {
+        // ANSI positions start from 1
+        buffer_ += "\x1b[";
+        buffer_ += std::to_string(y + 1);
+        buffer_ += ';';
+        buffer_ += std::to_string(x + 1);
+        buffer_ += 'H';
+    }
+
+    void ConsoleRenderer::show(const ConsoleFrame &frame) {
+        buffer_.clear();
+
+        if (shown_) {
+            // the cursor is left after the written glyphs so adjacent changes need no moves
+            size_t cursor_x = 0, cursor_y = 0;
+            bool cursor_known = false;
+            const vector<ConsoleFrame::Glyph> empty_line;
+            for (size_t y = 0; y < frame.height(); ++y) {
+                const auto &line = frame.line(y);
+                const auto &previous_line = y < previous_.height() ? previous_.line(y) : empty_line;
+
+                for (size_t x = 0; x < line.size(); ++x) {
+                    if (x < previous_line.size() && previous_line[x] == line[x]) continue;
+
+                    if (!cursor_known || cursor_x != x || cursor_y != y) append_cursor_move(x, y);
+                    ConsoleFrame::append_glyph(line[x], buffer_);
+                    cursor_x = x + 1;
+                    cursor_y = y;
+                    cursor_known = true;
+                }
+                // the rest of the previous line is erased
+                if (previous_line.size() > line.size()) {
+                    append_cursor_move(line.size(), y);
+                    buffer_ += "\x1b[K";
+                    cursor_known = false;
+                }
+            }
+            // lines below the frame (i.e. the prompts printed after it) get erased
+            append_cursor_move(0, frame.height());
+            buffer_ += "\x1b[J";
+        } else {
+            buffer_ += "\x1b[H\x1b[2J";
+            frame.append_to(buffer_);
+        }
+
+        out_.write(buffer_.data(), std::streamsize(buffer_.size()));
+        out_.flush();
+        shown_ = true;
+    }
+
+    void ConsoleRenderer::append_messages(ConsoleFrame &frame) const {
+        if (messages_.empty()) return;
+
+        const auto top = frame.height() + 1;
+        for (size_t i = 0; i < messages_.size(); ++i) frame.write(0, top + i, messages_[i]);
+    }
+
+    void ConsoleRenderer::log(string message) {
+        messages_.push_back(std::move(message));
+        while (messages_.size() > message_limit_) messages_.pop_front();
+    }
+
+    void ConsoleRenderer::present(const ConsolePrintable &printable) {
+        current_.clear();
+        printable.draw_to(current_);
+        append_messages(current_);
+        show(current_);
+        std::swap(previous_, current_);
+    }
+
+    void ConsoleRenderer::present(const ConsoleFrame &frame) {
+        current_ = frame;
+        append_messages(current_);
+        show(current_);
+        std::swap(previous_, current_);
+    }
+}
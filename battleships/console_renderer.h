@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using std::deque;
+using std::string;
+using std::string_view;
+using std::vector;
+
+namespace battleships {
+
+    class ConsolePrintable;
+
+    /**
+     * @brief Text frame of the console made of lines of glyphs each taking a single column.
+     */
+    class ConsoleFrame {
+
+    public:
+
+        /**
+         * @brief UTF-8 encoded character whose bytes are packed starting from the lowest one
+         */
+        using Glyph = uint32_t;
+
+        constexpr static Glyph SPACE = ' ';
+
+    private:
+
+        vector<vector<Glyph>> lines_;
+
+    public:
+
+        [[nodiscard]] inline size_t height() const noexcept {
+            return lines_.size();
+        }
+
+        [[nodiscard]] inline const vector<Glyph> &line(const size_t &y) const noexcept {
+            return lines_[y];
+        }
+
+        inline void clear() noexcept {
+            lines_.clear();
+        }
+
+        /**
+         * @brief Writes the character at the given position growing the frame if needed.
+         *
+         * @param x column of the character
+         * @param y line of the character
+         * @param character character to write
+         */
+        void put(const size_t &x, const size_t &y, const char &character);
+
+        /**
+         * @brief Writes the UTF-8 encoded text starting at the given position growing the frame if needed.
+         *
+         * @param x column of the text's first character
+         * @param y line of the text
+         * @param text text to write which should not contain line breaks
+         * @return column following the text
+         */
+        size_t write(size_t x, const size_t &y, const string_view &text);
+
+        /**
+         * @brief Appends the frame's text to the buffer as plain lines.
+         *
+         * @param buffer buffer to append to
+         */
+        void append_to(string &buffer) const;
+
+        /**
+         * @brief Appends the glyph's bytes to the buffer.
+         *
+         * @param glyph glyph to append
+         * @param buffer buffer to append to
+         */
+        static void append_glyph(Glyph glyph, string &buffer);
+    };
+
+    /**
+     * @brief Renderer which keeps the frame last shown at the console and only redraws the cells changed since it.
+     *
+     * The frame is drawn at the top of the screen followed by the log of the last messages
+     * and the lines below it (i.e. the prompts printed after it) are cleared on each update,
+     * all the changes being moved to by ANSI escape sequences and written to the stream at once.
+     */
+    class ConsoleRenderer {
+
+        std::ostream &out_;
+
+        ConsoleFrame previous_, current_;
+
+        /**
+         * @brief Flag indicating whether the console is known to show the previous frame
+         */
+        bool shown_ = false;
+
+        string buffer_;
+
+        /**
+         * @brief Last messages shown below the frames in the order of their logging
+         */
+        deque<string> messages_;
+
+        size_t message_limit_;
+
+        void append_cursor_move(const size_t &x, const size_t &y);
+
+        /**
+         * @brief Writes the changes of the frame since the previous one to the stream.
+         */
+        void show(const ConsoleFrame &frame);
+
+        /**
+         * @brief Writes the logged messages to the lines following the frame separated from it by an empty one.
+         *
+         * @param frame frame to write the messages to
+         */
+        void append_messages(ConsoleFrame &frame) const;
+
+    public:
+
+        /**
+         * @brief Creates a renderer writing to the stream.
+         *
+         * @param out stream to write to
+         * @param message_limit maximal number of the last messages shown below the frames
+         */
+        explicit ConsoleRenderer(std::ostream &out = std::cout, const size_t &message_limit = 8)
+                : out_(out), message_limit_(message_limit) {}
+
+        /**
+         * @brief Makes the next update redraw the whole screen, should be called once the console gets changed
+         * other than by this renderer.
+         */
+        inline void invalidate() noexcept {
+            shown_ = false;
+        }
+
+        /**
+         * @brief Logs the message to be shown below the frames starting from the next update,
+         * the oldest message being dropped once there are more than the limit.
+         *
+         * @param message message which should not contain line breaks
+         */
+        void log(string message);
+
+        /**
+         * @brief Draws the printable and shows the changes of its frame.
+         *
+         * @param printable printable to show
+         */
+        void present(const ConsolePrintable &printable);
+
+        /**
+         * @brief Shows the changes of the frame followed by the messages since the previously shown one.
+         *
+         * @param frame frame to show
+         */
+        void present(const ConsoleFrame &frame);
+    };
+}
@@ -1,28 +1,355 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <random>
 #include <set>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 using std::find;
 using std::set;
 using std::advance;
+using std::out_of_range;
+using std::uniform_int_distribution;
 
 namespace common_util {
 
+    /**
+     * @brief Ordered set which also gives access to its elements by their ranks.
+     *
+     * This is a treap whose nodes are augmented with the sizes of their subtrees and stored in a single vector,
+     * so that lookups, insertions, removals and accesses by rank all take expected logarithmic time.
+     * The priorities of the nodes are generated by a fixed sequence so the shape of the tree is deterministic.
+     *
+     * @tparam T type of the elements
+     * @tparam Compare comparator ordering the elements
+     */
+    template<typename T, typename Compare = std::less<T>>
+    class OrderedSet {
+
+        using NodeIndex = uint32_t;
+
+        constexpr static NodeIndex NIL = NodeIndex(-1);
+
+        struct Node {
+            T value;
+            uint64_t priority;
+            NodeIndex left, right;
+            /**
+             * @brief Number of the nodes in the subtree of this node
+             */
+            uint32_t size;
+        };
+
+        std::vector<Node> nodes_;
+
+        /**
+         * @brief Indices of the removed nodes which may be reused
+         */
+        std::vector<NodeIndex> free_nodes_;
+
+        NodeIndex root_ = NIL;
+
+        uint64_t priority_state_ = 0;
+
+        Compare compare_;
+
+        [[nodiscard]] inline uint32_t size_of(const NodeIndex &node) const noexcept {
+            return node == NIL ? 0 : nodes_[node].size;
+        }
+
+        inline void update(const NodeIndex &node) noexcept {
+            auto &data = nodes_[node];
+            data.size = 1 + size_of(data.left) + size_of(data.right);
+        }
+
+        /**
+         * @brief Generates the next priority using SplitMix64.
+         */
+        [[nodiscard]] inline uint64_t next_priority() noexcept {
+            auto value = priority_state_ += 0x9E3779B97F4A7C15u;
+            value = (value ^ (value >> 30u)) * 0xBF58476D1CE4E5B9u;
+            value = (value ^ (value >> 27u)) * 0x94D049BB133111EBu;
+            return value ^ (value >> 31u);
+        }
+
+        /**
+         * @brief Splits the subtree into the one of the elements less than the value and the one of the others.
+         * The indices are passed by value as the output ones may refer to the links of the split nodes.
+         */
+        void split(const NodeIndex node, const T &value, NodeIndex &less, NodeIndex &not_less) noexcept {
+            if (node == NIL) {
+                less = not_less = NIL;
+                return;
+            }
+
+            if (compare_(nodes_[node].value, value)) {
+                split(nodes_[node].right, value, nodes_[node].right, not_less);
+                less = node;
+            } else {
+                split(nodes_[node].left, value, less, nodes_[node].left);
+                not_less = node;
+            }
+            update(node);
+        }
+
+        /**
+         * @brief Merges the subtrees all of whose elements of the first one are less than those of the second one.
+         */
+        [[nodiscard]] NodeIndex merge(const NodeIndex less, const NodeIndex greater) noexcept {
+            if (less == NIL) return greater;
+            if (greater == NIL) return less;
+
+            if (nodes_[less].priority > nodes_[greater].priority) {
+                nodes_[less].right = merge(nodes_[less].right, greater);
+                update(less);
+                return less;
+            }
+
+            nodes_[greater].left = merge(less, nodes_[greater].left);
+            update(greater);
+            return greater;
+        }
+
+        [[nodiscard]] NodeIndex erase_from(const NodeIndex node, const T &value, bool &erased) noexcept {
+            if (node == NIL) return NIL;
+
+            auto &data = nodes_[node];
+            if (compare_(value, data.value)) data.left = erase_from(data.left, value, erased);
+            else if (compare_(data.value, value)) data.right = erase_from(data.right, value, erased);
+            else {
+                erased = true;
+                free_nodes_.push_back(node);
+                return merge(data.left, data.right);
+            }
+            update(node);
+
+            return node;
+        }
+
+    public:
+
+        /**
+         * @brief Iterator over the elements in their order which refers to an element by its rank.
+         */
+        class const_iterator {
+
+            const OrderedSet *set_;
+
+            size_t rank_;
+
+        public:
+
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T *;
+            using reference = const T &;
+
+            const_iterator(const OrderedSet *const set, const size_t &rank) : set_(set), rank_(rank) {}
+
+            [[nodiscard]] inline reference operator*() const {
+                return set_->at(rank_);
+            }
+
+            [[nodiscard]] inline pointer operator->() const {
+                return &set_->at(rank_);
+            }
+
+            inline const_iterator &operator++() noexcept {
+                ++rank_;
+                return *this;
+            }
+
+            inline const_iterator operator++(int) noexcept {
+                const auto previous = *this;
+                ++rank_;
+                return previous;
+            }
+
+            inline const_iterator &operator--() noexcept {
+                --rank_;
+                return *this;
+            }
+
+            inline const_iterator operator--(int) noexcept {
+                const auto previous = *this;
+                --rank_;
+                return previous;
+            }
+
+            [[nodiscard]] inline bool operator==(const const_iterator &other) const noexcept {
+                return set_ == other.set_ && rank_ == other.rank_;
+            }
+
+            [[nodiscard]] inline bool operator!=(const const_iterator &other) const noexcept {
+                return !(*this == other);
+            }
+        };
+
+        explicit OrderedSet(const Compare &compare = Compare()) : compare_(compare) {}
+
+        template<typename I>
+        OrderedSet(I first, const I last, const Compare &compare = Compare()) : compare_(compare) {
+            for (; first != last; ++first) insert(*first);
+        }
+
+        OrderedSet(const std::initializer_list<T> &values, const Compare &compare = Compare())
+                : OrderedSet(values.begin(), values.end(), compare) {}
+
+        [[nodiscard]] inline size_t size() const noexcept {
+            return size_of(root_);
+        }
+
+        [[nodiscard]] inline bool empty() const noexcept {
+            return root_ == NIL;
+        }
+
+        inline void clear() noexcept {
+            nodes_.clear();
+            free_nodes_.clear();
+            root_ = NIL;
+        }
+
+        /**
+         * @brief Inserts the value if there is no equal one.
+         *
+         * @param value value to insert
+         * @return {@code true} if the value has been inserted and {@code false} if it was already present
+         */
+        bool insert(const T &value) {
+            if (contains(value)) return false;
+
+            NodeIndex node;
+            if (free_nodes_.empty()) {
+                node = NodeIndex(nodes_.size());
+                nodes_.push_back({value, next_priority(), NIL, NIL, 1});
+            } else {
+                node = free_nodes_.back();
+                free_nodes_.pop_back();
+                nodes_[node] = {value, next_priority(), NIL, NIL, 1};
+            }
+
+            NodeIndex less, not_less;
+            split(root_, value, less, not_less);
+            root_ = merge(merge(less, node), not_less);
+
+            return true;
+        }
+
+        /**
+         * @brief Removes the value if it is present.
+         *
+         * @param value value to remove
+         * @return {@code true} if the value has been removed and {@code false} if it was not present
+         */
+        bool erase(const T &value) noexcept {
+            bool erased = false;
+            root_ = erase_from(root_, value, erased);
+
+            return erased;
+        }
+
+        [[nodiscard]] bool contains(const T &value) const noexcept {
+            auto node = root_;
+            while (node != NIL) {
+                const auto &data = nodes_[node];
+                if (compare_(value, data.value)) node = data.left;
+                else if (compare_(data.value, value)) node = data.right;
+                else return true;
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief Gets the element by its rank.
+         *
+         * @param rank number of the elements less than the one got
+         * @return element with the given rank
+         * @throws out_of_range if the rank is not less than the size of this set
+         */
+        [[nodiscard]] const T &at(size_t rank) const {
+            if (rank >= size()) throw out_of_range("Rank " + std::to_string(rank) + " is out of the set's range");
+
+            auto node = root_;
+            while (true) {
+                const auto &data = nodes_[node];
+                const auto left_size = size_of(data.left);
+                if (rank < left_size) node = data.left;
+                else if (rank == left_size) return data.value;
+                else {
+                    rank -= left_size + 1;
+                    node = data.right;
+                }
+            }
+        }
+
+        /**
+         * @brief Counts the elements less than the value.
+         *
+         * @param value value whose rank is computed
+         * @return number of the elements less than the value
+         */
+        [[nodiscard]] size_t rank_of(const T &value) const noexcept {
+            size_t rank = 0;
+            auto node = root_;
+            while (node != NIL) {
+                const auto &data = nodes_[node];
+                if (compare_(data.value, value)) {
+                    rank += size_of(data.left) + 1;
+                    node = data.right;
+                } else node = data.left;
+            }
+
+            return rank;
+        }
+
+        [[nodiscard]] inline const_iterator begin() const noexcept {
+            return const_iterator(this, 0);
+        }
+
+        [[nodiscard]] inline const_iterator end() const noexcept {
+            return const_iterator(this, size());
+        }
+
+        /**
+         * @brief Finds the element equal to the value.
+         *
+         * @param value value to find
+         * @return iterator pointing to the found element or {@link #end()} if there is none
+         */
+        [[nodiscard]] inline const_iterator find(const T &value) const noexcept {
+            return contains(value) ? const_iterator(this, rank_of(value)) : end();
+        }
+    };
+
     template<typename T>
     inline bool contains(const set<T> &container, const T &value) {
-        return find(container.begin(), container.end(), value) != container.end();
+        return container.find(value) != container.end();
     }
 
     template<typename T>
     inline bool not_contains(const set<T> &container, const T &value) {
-        return find(container.begin(), container.end(), value) == container.end();
+        return container.find(value) == container.end();
     }
 
-    template<typename T>
-    inline T get_random(set<T> &container, random_device &random) {
+    template<typename T, typename C>
+    inline bool contains(const OrderedSet<T, C> &container, const T &value) {
+        return container.contains(value);
+    }
+
+    template<typename T, typename C>
+    inline bool not_contains(const OrderedSet<T, C> &container, const T &value) {
+        return !container.contains(value);
+    }
+
+    template<typename T, typename R>
+    inline T get_random(set<T> &container, R &random) {
         if (container.empty()) throw out_of_range("Container is empty");
 
         const auto index = uniform_int_distribution<size_t>(0, container.size() - 1)(random);
@@ -32,4 +359,11 @@ namespace common_util {
 
         return *iterator;
     }
-}
\ No newline at end of file
+
+    template<typename T, typename C, typename R>
+    inline T get_random(const OrderedSet<T, C> &container, R &random) {
+        if (container.empty()) throw out_of_range("Container is empty");
+
+        return container.at(uniform_int_distribution<size_t>(0, container.size() - 1)(random));
+    }
+}
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <cctype>
 #include <cstddef>
+#include <limits>
+#include <optional>
 #include <string>
 #include "direction.h"
 
+using std::optional;
 using std::string;
 
 namespace battleships {
@@ -71,8 +75,60 @@ namespace battleships {
             return x == other.x ? y < other.y : x < other.x;
         }
 
+        /**
+         * @brief Gets the name of the column as written in the coordinates: {@code A} to {@code Z}
+         * followed by {@code AA}, {@code AB} and so on.
+         *
+         * @param x non-negative index of the column
+         * @return name of the column
+         */
+        [[nodiscard]] static string column_name(const int &x) {
+            string name;
+            for (auto column = size_t(x) + 1; column != 0; column = (column - 1) / 26)
+                name.insert(name.begin(), char('A' + (column - 1) % 26));
+
+            return name;
+        }
+
+        /**
+         * @brief Formats the coordinate as its column name followed by its row number (e.g. {@code AB12}),
+         * the coordinates with negative column being formatted as their numbers separated by a colon.
+         *
+         * @return formatted coordinate
+         */
         [[nodiscard]] string to_string() const {
-            return char(x + 'A') + std::to_string(y);
+            return x < 0 ? std::to_string(x) + ':' + std::to_string(y) : column_name(x) + std::to_string(y);
+        }
+
+        /**
+         * @brief Parses the coordinate written either as its column name followed by its row number
+         * (e.g. {@code AB12} or {@code ab12}) or as its numbers separated by a colon (e.g. {@code 27:12}).
+         *
+         * @param text text to parse
+         * @return parsed coordinate or an empty optional if the text is not a valid coordinate
+         */
+        [[nodiscard]] static optional<Coordinate> parse(const string &text) {
+            constexpr auto MAX = size_t(std::numeric_limits<int>::max());
+
+            size_t i = 0, x = 0, y = 0;
+            const auto is_digit = [&] { return i < text.size() && '0' <= text[i] && text[i] <= '9'; };
+            const auto read_number = [&](size_t &number) {
+                if (!is_digit()) return false;
+                for (number = 0; is_digit(); ++i) if ((number = number * 10 + size_t(text[i] - '0')) > MAX) return false;
+                return true;
+            };
+
+            if (is_digit()) {
+                if (!read_number(x) || i == text.size() || text[i++] != ':') return std::nullopt;
+            } else {
+                for (; i < text.size() && std::isalpha(static_cast<unsigned char>(text[i])); ++i)
+                    if ((x = x * 26 + size_t(std::toupper(static_cast<unsigned char>(text[i])) - 'A' + 1)) > MAX + 1)
+                        return std::nullopt;
+                if (x-- == 0) return std::nullopt;
+            }
+            if (!read_number(y) || i != text.size()) return std::nullopt;
+
+            return Coordinate(int(x), int(y));
         }
     };
 }
@@ -0,0 +1,100 @@
+#include "coroutine_rival_bot.h"
+
+#include <utility>
+#include <vector>
+
+#include "instrumentation.h"
+
+using std::vector;
+
+namespace battleships {
+
+    namespace {
+
+        /**
+         * @brief Attack callback collecting the shots of a single turn
+         */
+        class TurnCollector : public RivalBot::AttackCallback {
+
+        public:
+            vector<std::pair<Coordinate, GameField::AttackStatus>> shots;
+
+            void on_attack(const Coordinate &coordinate, const GameField::AttackStatus &attack_status) override {
+                shots.emplace_back(coordinate, attack_status);
+            }
+        };
+    }
+
+    /*
+     * Coroutine bot adapter
+     */
+
+    CoroutineRivalBotAdapter::CoroutineRivalBotAdapter(unique_ptr<CoroutineRivalBot> bot, GameField *const rival_field)
+            : bot_(std::move(bot)), rival_field_(rival_field) {}
+
+    void CoroutineRivalBotAdapter::place_ships() {
+        BATTLESHIPS_INSTRUMENT(BOT_PLACE_SHIPS);
+        bot_->place_ships();
+    }
+
+    bool CoroutineRivalBotAdapter::act(AttackCallback *attack_callback) {
+        BATTLESHIPS_INSTRUMENT(BOT_ACT);
+        attack_callback = EmptyAttackCallback::or_empty(attack_callback);
+        if (!shots_) shots_.emplace(bot_->shots());
+
+        while (true) {
+            const auto attacked_coordinate = shots_->target();
+            const auto attack_status = rival_field_->attack(attacked_coordinate);
+            attack_callback->on_attack(attacked_coordinate, attack_status);
+            shots_->resolve(attack_status);
+            switch (attack_status) {
+                case GameField::MISS: return false;
+                case GameField::WIN: return true;
+                default: break;
+            }
+        }
+    }
+
+    bool CoroutineRivalBotAdapter::act_within(const std::chrono::microseconds &, AttackCallback *attack_callback) {
+        UnsearchedAttackCallback unsearched_attack_callback(attack_callback);
+        return act(&unsearched_attack_callback);
+    }
+
+    bool CoroutineRivalBotAdapter::act_salvo(const size_t &, AttackCallback *) {
+        throw runtime_error("Coroutine bots cannot fire salvos");
+    }
+
+    /*
+     * Blocking bot adapter
+     */
+
+    RivalBotCoroutineAdapter::RivalBotCoroutineAdapter(const GameField *const rival_field,
+                                                       const function<unique_ptr<RivalBot>(GameField *)> &create_bot)
+            : rival_field_(rival_field), rival_field_copy_(rival_field->clone()),
+              bot_(create_bot(rival_field_copy_.get())) {}
+
+    void RivalBotCoroutineAdapter::place_ships() {
+        bot_->place_ships();
+    }
+
+    ShotStream RivalBotCoroutineAdapter::shots() {
+        // the rival's fleet is only known once the ships are placed
+        rival_field_copy_->reset();
+        for (const auto &ship : rival_field_->get_ships())
+            if (!rival_field_copy_->try_emplace_ship(ship.coordinate, ship.direction, ship.size))
+                throw runtime_error("Rival's fleet cannot be copied");
+
+        TurnCollector turn;
+        while (true) {
+            turn.shots.clear();
+            const auto won = bot_->act(&turn);
+            for (const auto &[coordinate, expected_status] : turn.shots) {
+                const auto attack_status = co_yield coordinate;
+                if (attack_status != expected_status)
+                    throw runtime_error("Rival's field differs from its copy at " + coordinate.to_string());
+            }
+
+            if (won) co_return;
+        }
+    }
+}
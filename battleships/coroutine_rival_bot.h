@@ -0,0 +1,117 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <optional>
+
+#include "game_field.h"
+#include "rival_bot.h"
+#include "shot_stream.h"
+
+using std::function;
+using std::optional;
+using std::unique_ptr;
+
+namespace battleships {
+
+    /**
+     * @brief Bot playing against the player whose shots are produced by a coroutine
+     * so that it can be suspended at each of them instead of blocking the thread for the whole turn.
+     */
+    class CoroutineRivalBot {
+
+    public:
+
+        virtual ~CoroutineRivalBot() = default;
+
+        virtual void place_ships() = 0;
+
+        /**
+         * @brief Starts the coroutine producing the shots of this bot for the whole game.
+         * The caller resolves the shots at the rival's field, a miss passing the turn to the rival.
+         * The coroutine refers to this bot which should outlive it.
+         *
+         * @return coroutine yielding the shots of this bot until it wins
+         */
+        [[nodiscard]] virtual ShotStream shots() = 0;
+    };
+
+    /**
+     * @brief Bot playing the turns of the coroutine bot by resolving its shots at the rival's field.
+     */
+    class CoroutineRivalBotAdapter final : public RivalBot {
+
+        const unique_ptr<CoroutineRivalBot> bot_;
+
+        GameField *const rival_field_;
+
+        /**
+         * @brief Shots of the bot started by its first turn
+         */
+        optional<ShotStream> shots_;
+
+    public:
+
+        /**
+         * @brief Creates a new adapter.
+         *
+         * @param bot adapted bot
+         * @param rival_field field of the rival attacked by the bot
+         */
+        CoroutineRivalBotAdapter(unique_ptr<CoroutineRivalBot> bot, GameField *rival_field);
+
+        void place_ships() override;
+
+        bool act(AttackCallback *attack_callback) override;
+
+        /**
+         * @brief Salvos are not supported as the coroutine bots learn the result of each shot before aiming the next.
+         *
+         * @throws runtime_error always
+         */
+        bool act_salvo(const size_t &shots, AttackCallback *attack_callback) override;
+
+        /**
+         * @brief Makes a turn as {@link #act} does as the coroutine bots have no notion of the time budget.
+         */
+        bool act_within(const std::chrono::microseconds &shot_budget, AttackCallback *attack_callback) override;
+    };
+
+    /**
+     * @brief Coroutine bot playing the turns of the blocking bot.
+     *
+     * The blocking bot attacks a private copy of the rival's field which gets the rival's fleet once the shots
+     * are started. Each turn is played at the copy at once and its shots are then yielded one by one
+     * expecting the same results at the rival's field.
+     */
+    class RivalBotCoroutineAdapter final : public CoroutineRivalBot {
+
+        const GameField *const rival_field_;
+
+        const unique_ptr<GameField> rival_field_copy_;
+
+        const unique_ptr<RivalBot> bot_;
+
+    public:
+
+        /**
+         * @brief Creates a new adapter.
+         *
+         * @param rival_field field of the rival the shots are aimed at
+         * @param create_bot function creating the adapted bot attacking the given copy of the rival's field
+         */
+        RivalBotCoroutineAdapter(const GameField *rival_field,
+                                 const function<unique_ptr<RivalBot>(GameField *)> &create_bot);
+
+        void place_ships() override;
+
+        /**
+         * @brief Starts the shots of the blocking bot, this should happen before any shot at the rival's field.
+         *
+         * @return coroutine yielding the shots of the blocking bot
+         * @throws runtime_error if the copy of the rival's field cannot get the rival's fleet
+         * or if the results of the shots at the rival's field differ from those at the copy
+         */
+        [[nodiscard]] ShotStream shots() override;
+    };
+}
@@ -0,0 +1,395 @@
+#include "density_rival_bot.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+#include <random>
+
+#include "instrumentation.h"
+#include "ship_placement.h"
+
+using std::runtime_error;
+using std::uniform_int_distribution;
+using std::chrono::steady_clock;
+
+namespace battleships {
+
+    namespace {
+
+        [[nodiscard]] size_t max_ship_length_of(const GameConfiguration &configuration) {
+            return configuration.ships.empty() ? 0 : configuration.ships.rbegin()->first;
+        }
+    }
+
+    DensityRivalBot::DensityRivalBot(GameField *const own_field, GameField *const rival_field, const uint64_t &seed)
+            : own_field_(own_field), rival_field_(rival_field),
+              width_(rival_field->get_configuration().field_width),
+              height_(rival_field->get_configuration().field_height),
+              cell_count_(width_ * height_), random_(seed),
+              ships_left_(max_ship_length_of(rival_field->get_configuration()) + 1, 0),
+              discovered_(cell_count_, 0), blocked_(cell_count_, 0),
+              heat_(ships_left_.size() * cell_count_, 0), scores_(cell_count_, 0) {
+        for (const auto &entry : rival_field->get_configuration().ships) ships_left_[entry.first] = entry.second;
+
+        initialize_heat();
+    }
+
+    /*
+     * Heat maintenance
+     */
+
+    void DensityRivalBot::initialize_heat() {
+        for (size_t length = 1; length < ships_left_.size(); ++length) {
+            if (ships_left_[length] == 0) continue;
+            const auto heat = &heat_[length * cell_count_];
+
+            // horizontal placements are counted within each row
+            if (length <= width_) for (size_t y = 0; y < height_; ++y) {
+                const auto row = heat + y * width_;
+                for (size_t start = 0; start + length <= width_; ++start)
+                    for (size_t i = 0; i < length; ++i) ++row[start + i];
+            }
+            // vertical placements starting at the same row cover whole rows so those get incremented at once
+            if (length > 1 && length <= height_) for (size_t start = 0; start + length <= height_; ++start)
+                for (size_t i = 0; i < length; ++i) {
+                    const auto row = heat + (start + i) * width_;
+                    for (size_t x = 0; x < width_; ++x) ++row[x];
+                }
+        }
+    }
+
+    void DensityRivalBot::block(const Coordinate &coordinate) {
+        const auto cell = index_of(coordinate);
+        if (blocked_[cell]) return;
+
+        for (size_t length = 1; length < ships_left_.size(); ++length) {
+            if (ships_left_[length] == 0) continue;
+            const auto heat = &heat_[length * cell_count_];
+
+            for (const auto horizontal : {true, false}) {
+                if (!horizontal && length == 1) break; // single-celled ships have the only orientation
+
+                const auto position = ptrdiff_t(horizontal ? coordinate.x : coordinate.y),
+                        limit = ptrdiff_t(horizontal ? width_ : height_), signed_length = ptrdiff_t(length);
+                const auto step = horizontal ? size_t(1) : width_;
+
+                const auto last_start = std::min(position, limit - signed_length);
+                for (auto start = std::max(ptrdiff_t(0), position - signed_length + 1); start <= last_start; ++start) {
+                    const auto start_cell = cell - size_t(position - start) * step;
+
+                    bool legal = true;
+                    for (size_t i = 0; i < length; ++i) if (blocked_[start_cell + i * step]) {
+                        legal = false;
+                        break;
+                    }
+                    if (legal) for (size_t i = 0; i < length; ++i) --heat[start_cell + i * step];
+                }
+            }
+        }
+
+        blocked_[cell] = 1;
+    }
+
+    void DensityRivalBot::try_block(const Coordinate &coordinate) {
+        if (is_in_bounds(coordinate)) block(coordinate);
+    }
+
+    /*
+     * Targeting
+     */
+
+    Coordinate DensityRivalBot::hunt_target(const steady_clock::time_point &deadline, SearchEffort &effort) {
+        // the clock is only read if the search is limited
+        const auto limited = deadline != steady_clock::time_point::max();
+        bool weighed = false;
+
+        std::fill(scores_.begin(), scores_.end(), 0);
+        for (auto length = ships_left_.size() - 1; length >= 1; --length) {
+            const auto weight = int64_t(ships_left_[length]);
+            if (weight == 0) continue;
+            if (weighed && limited && steady_clock::now() >= deadline) {
+                effort.interrupted = true;
+                break;
+            }
+            weighed = true;
+            ++effort.evaluations;
+
+            const auto heat = &heat_[length * cell_count_];
+            for (size_t i = 0; i < cell_count_; ++i) scores_[i] += weight * heat[i];
+        }
+
+        auto chosen = cell_count_;
+        int64_t best_score = -1;
+        size_t ties = 0;
+        for (size_t i = 0; i < cell_count_; ++i) {
+            if (discovered_[i]) continue;
+
+            const auto score = scores_[i];
+            if (score > best_score) {
+                best_score = score;
+                chosen = i;
+                ties = 1;
+            } else if (score == best_score && uniform_int_distribution<size_t>(0, ties++)(random_) == 0) chosen = i;
+        }
+
+        if (chosen == cell_count_) throw runtime_error("The game has no free spots");
+
+        return Coordinate(int(chosen % width_), int(chosen / width_));
+    }
+
+    Coordinate DensityRivalBot::finish_target(const steady_clock::time_point &deadline, SearchEffort &effort) {
+        auto lowest = damaged_cells_.front(), highest = lowest;
+        for (const auto &damaged_cell : damaged_cells_) {
+            if (damaged_cell < lowest) lowest = damaged_cell;
+            if (highest < damaged_cell) highest = damaged_cell;
+        }
+        const auto damaged_count = ptrdiff_t(damaged_cells_.size());
+
+        optional<Coordinate> chosen;
+        int64_t best_score = 0;
+        size_t ties = 0;
+        for (const auto horizontal : {true, false}) {
+            // multiple damaged cells reveal the orientation of the ship
+            if (damaged_count > 1 && horizontal != (lowest.y == highest.y)) continue;
+
+            const auto segment_start = ptrdiff_t(horizontal ? lowest.x : lowest.y),
+                    segment_end = segment_start + damaged_count - 1,
+                    limit = ptrdiff_t(horizontal ? width_ : height_);
+            const auto at = [&](const ptrdiff_t &position) {
+                return horizontal ? Coordinate(int(position), lowest.y) : Coordinate(lowest.x, int(position));
+            };
+
+            int64_t score_before = 0, score_after = 0;
+            for (auto length = size_t(damaged_count) + 1; length < ships_left_.size(); ++length) {
+                const auto weight = int64_t(ships_left_[length]);
+                if (weight == 0) continue;
+                ++effort.evaluations;
+
+                const auto signed_length = ptrdiff_t(length);
+                const auto last_start = std::min(segment_start, limit - signed_length);
+                for (auto start = std::max(ptrdiff_t(0), segment_end - signed_length + 1); start <= last_start; ++start) {
+                    bool legal = true;
+                    for (auto position = start; position < start + signed_length; ++position) {
+                        if (segment_start <= position && position <= segment_end) continue;
+
+                        const auto cell = index_of(at(position));
+                        if (blocked_[cell] || discovered_[cell]) {
+                            legal = false;
+                            break;
+                        }
+                    }
+                    if (!legal) continue;
+
+                    if (start < segment_start) score_before += weight;
+                    if (start + signed_length - 1 > segment_end) score_after += weight;
+                }
+            }
+
+            for (const auto &[score, position] : {std::pair(score_before, segment_start - 1),
+                                                  std::pair(score_after, segment_end + 1)}) {
+                if (score == 0) continue;
+                if (score > best_score) {
+                    best_score = score;
+                    chosen = at(position);
+                    ties = 1;
+                } else if (score == best_score && uniform_int_distribution<size_t>(0, ties++)(random_) == 0)
+                    chosen = at(position);
+            }
+        }
+
+        // no placement can continue the damaged cells which means that the knowledge is inconsistent
+        return chosen.has_value() ? chosen.value() : hunt_target(deadline, effort);
+    }
+
+    Coordinate DensityRivalBot::choose_target() {
+        SearchEffort effort;
+        return choose_target(steady_clock::time_point::max(), effort);
+    }
+
+    Coordinate DensityRivalBot::choose_target(const steady_clock::time_point &deadline, SearchEffort &effort) {
+        return damaged_cells_.empty() ? hunt_target(deadline, effort) : finish_target(deadline, effort);
+    }
+
+    void DensityRivalBot::register_attack(const Coordinate &coordinate, const GameField::AttackStatus &attack_status) {
+        discovered_[index_of(coordinate)] = 1;
+
+        switch (attack_status) {
+            case GameField::EMPTY_ALREADY_ATTACKED:
+            case GameField::MISS: {
+                block(coordinate);
+                break;
+            }
+            case GameField::SHIP_ALREADY_ATTACKED: break;
+            case GameField::DAMAGE_SHIP: {
+                // ships are straight and never touch each other so diagonal neighbours are always empty
+                for (const auto &direction : ALL_DIRECTIONS) {
+                    const auto side_coordinate = coordinate.move(direction, 1);
+                    try_block(side_coordinate.move(rotate_direction_clockwise(direction), 1));
+                }
+                // a salvo may hit other ships than the one being finished
+                if (!damaged_cells_.empty() && !touches(damaged_cells_, coordinate)) {
+                    stray_damaged_cells_.push_back(coordinate);
+                    break;
+                }
+                damaged_cells_.push_back(coordinate);
+                gather_stray_cells(damaged_cells_);
+                block_ship_sides();
+                break;
+            }
+            case GameField::DESTROY_SHIP:
+            case GameField::WIN: {
+                auto &ship_cells = destroyed_cells_;
+                ship_cells.clear();
+                if (damaged_cells_.empty() || touches(damaged_cells_, coordinate)) {
+                    ship_cells.insert(ship_cells.end(), damaged_cells_.begin(), damaged_cells_.end());
+                    damaged_cells_.clear();
+                }
+                ship_cells.push_back(coordinate);
+                gather_stray_cells(ship_cells);
+                const auto length = ship_cells.size();
+                if (length < ships_left_.size() && ships_left_[length] != 0) --ships_left_[length];
+
+                // the field discovers the surrounding of the destroyed ship on its own
+                for (const auto &ship_cell : ship_cells) for (int deltaX = -1; deltaX <= 1; ++deltaX)
+                    for (int deltaY = -1; deltaY <= 1; ++deltaY) {
+                        const auto neighbour = ship_cell.move(deltaX, deltaY);
+                        if (!is_in_bounds(neighbour)) continue;
+
+                        discovered_[index_of(neighbour)] = 1;
+                        block(neighbour);
+                    }
+
+                // the other damaged ships are finished one by one
+                if (damaged_cells_.empty() && !stray_damaged_cells_.empty()) {
+                    damaged_cells_.push_back(stray_damaged_cells_.back());
+                    stray_damaged_cells_.pop_back();
+                    gather_stray_cells(damaged_cells_);
+                    block_ship_sides();
+                }
+                break;
+            }
+        }
+    }
+
+    bool DensityRivalBot::touches(const vector<Coordinate> &cells, const Coordinate &coordinate) {
+        return std::any_of(cells.begin(), cells.end(), [&](const Coordinate &cell) {
+            return std::abs(cell.x - coordinate.x) + std::abs(cell.y - coordinate.y) == 1;
+        });
+    }
+
+    void DensityRivalBot::gather_stray_cells(vector<Coordinate> &cells) {
+        bool gathered = true;
+        while (gathered) {
+            gathered = false;
+            for (size_t i = 0; i < stray_damaged_cells_.size(); ++i) {
+                if (!touches(cells, stray_damaged_cells_[i])) continue;
+
+                cells.push_back(stray_damaged_cells_[i]);
+                stray_damaged_cells_.erase(stray_damaged_cells_.begin() + ptrdiff_t(i));
+                gathered = true;
+                break;
+            }
+        }
+    }
+
+    void DensityRivalBot::block_ship_sides() {
+        if (damaged_cells_.size() < 2) return;
+
+        const auto horizontal = damaged_cells_[0].y == damaged_cells_[1].y;
+        for (const auto &damaged_cell : damaged_cells_) {
+            try_block(damaged_cell.move(horizontal ? UP : RIGHT, 1));
+            try_block(damaged_cell.move(horizontal ? DOWN : LEFT, 1));
+        }
+    }
+
+    /*
+     * Bot logic
+     */
+
+    void DensityRivalBot::place_ships() {
+        BATTLESHIPS_INSTRUMENT(BOT_PLACE_SHIPS);
+        place_ships_randomly(own_field_, random_);
+    }
+
+    bool DensityRivalBot::act(AttackCallback *attack_callback) {
+        BATTLESHIPS_INSTRUMENT(BOT_ACT);
+        return play_turn(std::nullopt, attack_callback);
+    }
+
+    bool DensityRivalBot::act_within(const std::chrono::microseconds &shot_budget, AttackCallback *attack_callback) {
+        BATTLESHIPS_INSTRUMENT(BOT_ACT);
+        return play_turn(shot_budget, attack_callback);
+    }
+
+    bool DensityRivalBot::play_turn(const optional<std::chrono::microseconds> &shot_budget,
+                                    AttackCallback *attack_callback) {
+        attack_callback = EmptyAttackCallback::or_empty(attack_callback);
+
+        while (true) {
+            SearchEffort effort;
+            const auto attacked_coordinate = shot_budget.has_value()
+                    ? choose_target(steady_clock::now() + shot_budget.value(), effort) : choose_target();
+            if (shot_budget.has_value()) attack_callback->on_search(effort);
+
+            const auto attack_status = rival_field_->attack(attacked_coordinate);
+            switch (attack_status) {
+                case GameField::EMPTY_ALREADY_ATTACKED:
+                case GameField::SHIP_ALREADY_ATTACKED: throw runtime_error(
+                        "Cell was expected to not be visited"
+                );
+                default: break;
+            }
+
+            attack_callback->on_attack(attacked_coordinate, attack_status);
+            register_attack(attacked_coordinate, attack_status);
+            switch (attack_status) {
+                case GameField::MISS: return false;
+                case GameField::WIN: return true;
+                default: break;
+            }
+        }
+    }
+
+    ShotStream DensityRivalBot::shots() {
+        while (true) {
+            const auto attacked_coordinate = choose_target();
+            const auto attack_status = co_yield attacked_coordinate;
+            switch (attack_status) {
+                case GameField::EMPTY_ALREADY_ATTACKED:
+                case GameField::SHIP_ALREADY_ATTACKED: throw runtime_error(
+                        "Cell was expected to not be visited"
+                );
+                default: break;
+            }
+
+            register_attack(attacked_coordinate, attack_status);
+            if (attack_status == GameField::WIN) co_return;
+        }
+    }
+
+    bool DensityRivalBot::act_salvo(const size_t &shots, AttackCallback *attack_callback) {
+        BATTLESHIPS_INSTRUMENT(BOT_ACT);
+        attack_callback = EmptyAttackCallback::or_empty(attack_callback);
+
+        // the chosen cells are marked as discovered for the time of aiming so that each one is chosen once
+        const auto count = std::min(shots, rival_field_->count_not_visited());
+        salvo_targets_.clear();
+        for (size_t i = 0; i < count; ++i) {
+            const auto target = choose_target();
+            discovered_[index_of(target)] = 1;
+            salvo_targets_.push_back(target);
+        }
+        for (const auto &target : salvo_targets_) discovered_[index_of(target)] = 0;
+
+        salvo_statuses_.resize(count);
+        rival_field_->attack_batch(salvo_targets_, salvo_statuses_);
+        for (size_t i = 0; i < count; ++i) {
+            attack_callback->on_attack(salvo_targets_[i], salvo_statuses_[i]);
+            register_attack(salvo_targets_[i], salvo_statuses_[i]);
+            // the shots following the winning one are not counted
+            if (salvo_statuses_[i] == GameField::WIN) return true;
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "coroutine_rival_bot.h"
+#include "rival_bot.h"
+#include "random_engine.h"
+
+using std::optional;
+using std::vector;
+
+namespace battleships {
+
+    /**
+     * @brief Bot attacking the cell covered by the largest number of legal placements of the rival's remaining ships.
+     *
+     * Counts of placements covering each cell are kept per ship length and are maintained incrementally:
+     * once a cell is known to contain no alive ship only the placements passing through it get subtracted.
+     */
+    class DensityRivalBot : public RivalBot, public CoroutineRivalBot {
+
+    protected:
+
+        // Uninitialized members
+
+        GameField *const own_field_, *const rival_field_;
+
+        const size_t width_, height_, cell_count_;
+
+        // Initialized members
+
+        RandomEngine random_;
+
+        /**
+         * @brief Counts of the rival's ships which are not yet destroyed indexed by their length
+         */
+        vector<size_t> ships_left_;
+
+        /**
+         * @brief Flags of the rival's cells which have been discovered
+         */
+        vector<uint8_t> discovered_;
+
+        /**
+         * @brief Flags of the rival's cells which cannot be occupied by an alive ship
+         */
+        vector<uint8_t> blocked_;
+
+        /**
+         * @brief Counts of legal placements covering each cell, the count for a ship of length {@code l}
+         * covering the cell {@code i} being stored at {@code l * cell_count_ + i}
+         */
+        vector<int32_t> heat_;
+
+        /**
+         * @brief Buffer for the heat combined over all the remaining ships
+         */
+        vector<int64_t> scores_;
+
+        /**
+         * @brief Damaged cells of the ship being currently finished
+         */
+        vector<Coordinate> damaged_cells_;
+
+        /**
+         * @brief Damaged cells of the other ships hit by the salvos which are finished after the current one
+         */
+        vector<Coordinate> stray_damaged_cells_;
+
+        /**
+         * @brief Buffer of the cells of the ship destroyed last
+         */
+        vector<Coordinate> destroyed_cells_;
+
+        /**
+         * @brief Buffers of the targets of the current salvo and their results
+         */
+        vector<Coordinate> salvo_targets_;
+        vector<GameField::AttackStatus> salvo_statuses_;
+
+        [[nodiscard]] inline size_t index_of(const Coordinate &coordinate) const noexcept {
+            return coordinate.y * width_ + coordinate.x;
+        }
+
+        [[nodiscard]] inline bool is_in_bounds(const Coordinate &coordinate) const noexcept {
+            return 0 <= coordinate.x && coordinate.x < width_ && 0 <= coordinate.y && coordinate.y < height_;
+        }
+
+        /**
+         * @brief Fills the heat for the empty field.
+         */
+        void initialize_heat();
+
+        /**
+         * @brief Marks the cell as the one which cannot be occupied by an alive ship
+         * subtracting all the placements going through it.
+         *
+         * @param coordinate coordinate of the blocked cell
+         */
+        void block(const Coordinate &coordinate);
+
+        /**
+         * @brief Blocks the cell if it is in bounds.
+         *
+         * @param coordinate coordinate of the blocked cell
+         */
+        void try_block(const Coordinate &coordinate);
+
+        /**
+         * @brief Checks whether the cell is a side neighbour of any of the cells.
+         *
+         * @param cells cells to check the neighbourhood of
+         * @param coordinate coordinate of the cell
+         * @return {@code true} if the cell touches any of the cells by a side and {@code false} otherwise
+         */
+        [[nodiscard]] static bool touches(const vector<Coordinate> &cells, const Coordinate &coordinate);
+
+        /**
+         * @brief Moves the stray damaged cells belonging to the same ship as the given cells to those.
+         *
+         * @param cells damaged cells of a single ship
+         */
+        void gather_stray_cells(vector<Coordinate> &cells);
+
+        /**
+         * @brief Blocks the cells alongside the ship being finished once its orientation is known.
+         */
+        void block_ship_sides();
+
+        /**
+         * @brief Chooses the cell with the highest heat out of the undiscovered ones.
+         * The heat of the longest ships is weighed first so that only the shortest ones are left out
+         * once the deadline is reached.
+         *
+         * @param deadline time after which no more ship lengths are weighed, at least one always is
+         * @param effort search effort to add the weighed ship lengths to
+         * @return coordinate to attack
+         */
+        Coordinate hunt_target(const std::chrono::steady_clock::time_point &deadline, SearchEffort &effort);
+
+        /**
+         * @brief Chooses the cell continuing the damaged ship which is covered by the most placements.
+         *
+         * @param deadline time after which no more ship lengths are weighed if the ship cannot be continued
+         * @param effort search effort to add the weighed ship lengths to
+         * @return coordinate to attack
+         */
+        Coordinate finish_target(const std::chrono::steady_clock::time_point &deadline, SearchEffort &effort);
+
+        /**
+         * @brief Makes a turn reporting the search for each shot if it is limited by the budget.
+         *
+         * @param shot_budget time in which each shot should be chosen or an empty optional for no limit
+         * @param attack_callback callback notified on the searches and the shots
+         * @return {@code true} if the bot has won
+         */
+        bool play_turn(const optional<std::chrono::microseconds> &shot_budget, AttackCallback *attack_callback);
+
+    public:
+
+        /**
+         * @brief Creates a new bot.
+         *
+         * @param own_field field of this bot
+         * @param rival_field field of the rival attacked by this bot
+         * @param seed seed of this bot's random engine
+         */
+        explicit DensityRivalBot(GameField *own_field, GameField *rival_field, const uint64_t &seed = random_seed());
+
+        /**
+         * @brief Chooses the coordinate to be attacked next.
+         *
+         * @return coordinate to attack
+         */
+        Coordinate choose_target();
+
+        /**
+         * @brief Chooses the coordinate to be attacked next stopping the search once the deadline is reached.
+         *
+         * @param deadline time by which the coordinate should be chosen
+         * @param effort search effort to add the performed search to
+         * @return coordinate to attack
+         */
+        Coordinate choose_target(const std::chrono::steady_clock::time_point &deadline, SearchEffort &effort);
+
+        /**
+         * @brief Updates the knowledge of the rival's field with the result of the attack.
+         *
+         * @param coordinate attacked coordinate
+         * @param attack_status result of the attack
+         */
+        void register_attack(const Coordinate &coordinate, const GameField::AttackStatus &attack_status);
+
+        void place_ships() override;
+
+        bool act(AttackCallback *attack_callback) override;
+
+        bool act_salvo(const size_t &shots, AttackCallback *attack_callback) override;
+
+        bool act_within(const std::chrono::microseconds &shot_budget, AttackCallback *attack_callback) override;
+
+        [[nodiscard]] ShotStream shots() override;
+    };
+}
@@ -4,7 +4,6 @@
 #include <stdexcept>
 #include <string>
 
-using std::random_device;
 using std::string;
 using std::uniform_int_distribution;
 using std::invalid_argument;
@@ -70,7 +69,8 @@ namespace battleships {
         }
     }
 
-    inline static Direction random_direction(random_device &random) {
+    template<typename R>
+    inline static Direction random_direction(R &random) {
         switch (direction_int_distribution(random)) {
             case 0: return RIGHT;
             case 1: return DOWN;
@@ -80,7 +80,8 @@ namespace battleships {
         }
     }
 
-    inline static Direction random_horizontal_direction(random_device &random) {
+    template<typename R>
+    inline static Direction random_horizontal_direction(R &random) {
         switch (horizontal_direction_int_distribution(random)) {
             case 0: return RIGHT;
             case 1: return LEFT;
@@ -88,7 +89,8 @@ namespace battleships {
         }
     }
 
-    inline static Direction random_vertical_direction(random_device &random) {
+    template<typename R>
+    inline static Direction random_vertical_direction(R &random) {
         switch (vertical_direction_int_distribution(random)) {
             case 0: return DOWN;
             case 1: return UP;
@@ -0,0 +1,450 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "attack_journal.h"
+#include "game_field.h"
+#include "game_configuration.h"
+#include "coordinate.h"
+#include "ship_registry.h"
+#include "free_cell_index.h"
+#include "instrumentation.h"
+
+using std::array;
+using std::invalid_argument;
+using std::string;
+using std::to_string;
+
+namespace battleships {
+
+    /**
+     * @brief Game field whose size is known at compile time.
+     *
+     * The cells are stored row by row with a border of guard cells around them, so that the neighbours of any
+     * cell of the field are at constant offsets and never need a bounds check. The offsets, the initial state
+     * and the mapping of the cells to their positions are computed at compile time and the neighbourhood checks
+     * are unrolled over those.
+     *
+     * @tparam W width of the field
+     * @tparam H height of the field
+     */
+    template<size_t W, size_t H>
+    class FixedGameField final : public GameField {
+
+        static_assert(W != 0 && H != 0, "The field should have at least one cell");
+
+        /**
+         * @brief Distance between the vertically neighbouring cells
+         */
+        constexpr static size_t STRIDE = W + 2;
+
+        /**
+         * @brief Number of the cells including the guard ones
+         */
+        constexpr static size_t PADDED_CELLS = STRIDE * (H + 2);
+
+        /**
+         * @brief Type of the positions of the cells, the smallest one which fits all of them
+         */
+        using CellIndex = std::conditional_t<
+                PADDED_CELLS <= UINT8_MAX, uint8_t, std::conditional_t<PADDED_CELLS <= UINT16_MAX, uint16_t, uint32_t>
+        >;
+
+        /**
+         * @brief Type of the ids of the ships stored per cell, the smallest one which fits a ship per cell
+         */
+        using ShipId = std::conditional_t<W * H < UINT8_MAX, uint8_t, ShipRegistry::Id>;
+
+        /*
+         * Cell flags
+         */
+
+        constexpr static uint8_t SHIP = 1, DISCOVERED = 2;
+
+        /**
+         * @brief Offsets of the eight neighbours of a cell going clockwise from the right one,
+         * the same order in which {@link SimpleGameField} discovers them so that the undiscovered cells stay
+         * in the same order and the random picks among those do not depend on the field used
+         */
+        constexpr static array<ptrdiff_t, 8> HALO_OFFSETS = {
+                1, 1 - ptrdiff_t(STRIDE), -ptrdiff_t(STRIDE), -ptrdiff_t(STRIDE) - 1,
+                -1, ptrdiff_t(STRIDE) - 1, ptrdiff_t(STRIDE), ptrdiff_t(STRIDE) + 1
+        };
+
+        /**
+         * @brief Offsets of the next cell in each direction indexed by the direction
+         */
+        constexpr static array<ptrdiff_t, 4> DIRECTION_OFFSETS = {
+                1, -ptrdiff_t(STRIDE), -1, ptrdiff_t(STRIDE) // RIGHT, DOWN, LEFT, UP
+        };
+
+        /**
+         * @brief Positions of the cells by their numbers (i.e. {@code y * W + x})
+         */
+        constexpr static array<CellIndex, W * H> POSITIONS = [] {
+            array<CellIndex, W * H> positions{};
+            for (size_t y = 0; y < H; ++y)
+                for (size_t x = 0; x < W; ++x) positions[y * W + x] = CellIndex((y + 1) * STRIDE + x + 1);
+            return positions;
+        }();
+
+        /**
+         * @brief State of the cells of the empty field, the guard cells being already discovered
+         * so that the halo of a ship never discovers them
+         */
+        constexpr static array<uint8_t, PADDED_CELLS> EMPTY_CELLS = [] {
+            array<uint8_t, PADDED_CELLS> cells{};
+            for (auto &cell : cells) cell = DISCOVERED;
+            for (const auto position : POSITIONS) cells[position] = 0;
+            return cells;
+        }();
+
+        const GameConfiguration configuration_;
+
+        /**
+         * @brief Flags of the cells by their positions
+         */
+        array<uint8_t, PADDED_CELLS> cells_ = EMPTY_CELLS;
+
+        /**
+         * @brief Ids of the ships occupying the cells by their positions, only meaningful for the ship cells
+         */
+        array<ShipId, PADDED_CELLS> ship_ids_{};
+
+        ShipRegistry registry_;
+
+        /**
+         * @brief Cells which have not been discovered yet
+         */
+        FreeCellIndex not_visited_;
+
+        size_t ship_cells_alive_ = 0;
+
+        AttackJournal journal_;
+
+        [[nodiscard]] static const GameConfiguration &validated(const GameConfiguration &configuration) {
+            if (configuration.field_width != W || configuration.field_height != H)
+                throw invalid_argument(
+                        "Field of size " + to_string(W) + "x" + to_string(H) + " cannot be created by configuration of "
+                        + to_string(configuration.field_width) + "x" + to_string(configuration.field_height)
+                );
+
+            return configuration;
+        }
+
+        inline void check_bounds(const Coordinate &coordinate) const noexcept(false) {
+            if (is_out_of_bounds(coordinate))
+                throw out_of_range(
+                        "Coordinate (" + to_string(coordinate.x)
+                        + ":" + to_string(coordinate.y) + ") is out of its range"
+                );
+        }
+
+        [[nodiscard]] inline static size_t position_of(const size_t &x, const size_t &y) noexcept {
+            return (y + 1) * STRIDE + x + 1;
+        }
+
+        [[nodiscard]] inline static size_t position_of(const Coordinate &coordinate) noexcept {
+            return position_of(size_t(coordinate.x), size_t(coordinate.y));
+        }
+
+        [[nodiscard]] inline static Coordinate coordinate_of(const size_t &position) noexcept {
+            return Coordinate(static_cast<int>(position % STRIDE) - 1, static_cast<int>(position / STRIDE) - 1);
+        }
+
+        /**
+         * @brief Checks that none of the neighbours of the cell has any of the flags.
+         */
+        template<size_t... I>
+        [[nodiscard]] inline bool is_halo_free_of(const size_t &position, const uint8_t &flags,
+                                                  std::index_sequence<I...>) const noexcept {
+            return (((cells_[position + HALO_OFFSETS[I]] & flags) == 0) && ...);
+        }
+
+        inline void try_make_discovered(const size_t &position) {
+            if ((cells_[position] & (DISCOVERED | SHIP)) == 0) {
+                cells_[position] |= DISCOVERED;
+                const auto coordinate = coordinate_of(position);
+                journal_.record_discovery(coordinate, not_visited_.remove(coordinate));
+            }
+        }
+
+        template<size_t... I>
+        inline void surround_destroyed_ship_cell(const size_t &position, std::index_sequence<I...>) {
+            (try_make_discovered(position + HALO_OFFSETS[I]), ...);
+        }
+
+        /**
+         * @brief Counts the hit of the ship cell at the given position destroying the ship if it has no cells left.
+         * @param position position of the cell attacked
+         * @return {@code true} if the ship was fully destroyed by the attack and {@code false} otherwise
+         */
+        inline bool attempt_destroy_ship(const size_t &position) {
+            const auto ship_id = ship_ids_[position];
+            journal_.record_hit(ship_id);
+            if (!registry_.hit(ship_id)) return false; // the ship is not yet fully destroyed
+
+            const auto &ship = registry_[ship_id];
+            const auto step = DIRECTION_OFFSETS[ship.direction];
+            auto cell = position_of(ship.coordinate);
+            for (size_t i = 0; i < ship.size; ++i, cell += step)
+                surround_destroyed_ship_cell(cell, std::make_index_sequence<HALO_OFFSETS.size()>());
+
+            return true;
+        }
+
+        /**
+         * @brief Attacks the cell which is known to be in bounds.
+         *
+         * @param coordinate coordinate of the attacked cell
+         * @return result of the attack
+         */
+        inline AttackStatus attack_in_bounds(const Coordinate &coordinate) {
+            const auto position = position_of(coordinate);
+            auto &cell = cells_[position];
+
+            if (cell & DISCOVERED) return cell & SHIP ? SHIP_ALREADY_ATTACKED : EMPTY_ALREADY_ATTACKED;
+            cell |= DISCOVERED;
+            journal_.record_discovery(coordinate, not_visited_.remove(coordinate));
+
+            if (!(cell & SHIP)) return MISS;
+
+            --ship_cells_alive_;
+
+            return attempt_destroy_ship(position) ? ship_cells_alive_ == 0 ? WIN : DESTROY_SHIP : DAMAGE_SHIP;
+        }
+
+        [[nodiscard]] inline bool can_place_at_position(const size_t &position) const noexcept {
+            return (cells_[position] & SHIP) == 0
+                   && is_halo_free_of(position, SHIP, std::make_index_sequence<HALO_OFFSETS.size()>());
+        }
+
+    public:
+
+        /*
+         * Construction and deconstruction
+         */
+
+        /**
+         * @brief Creates a new empty field.
+         *
+         * @param configuration configuration of the field
+         * @throws invalid_argument if the size of the configuration's field differs from this one's
+         */
+        explicit FixedGameField(const GameConfiguration &configuration)
+                : configuration_(validated(configuration)), not_visited_(W, H) {}
+
+        /*
+         * Data access
+         */
+
+        [[nodiscard]] GameConfiguration get_configuration() const noexcept override {
+            return configuration_;
+        }
+
+        /*
+         * Game logic
+         */
+
+        [[nodiscard]] bool is_discovered(const Coordinate &coordinate) const override {
+            check_bounds(coordinate);
+
+            return cells_[position_of(coordinate)] & DISCOVERED;
+        }
+
+        [[nodiscard]] bool can_be_attacked(const Coordinate &coordinate) const override {
+            return is_in_bounds(coordinate) && !(cells_[position_of(coordinate)] & DISCOVERED);
+        }
+
+        [[nodiscard]] bool can_place_near(const Coordinate &coordinate) const override {
+            return is_out_of_bounds(coordinate) || !(cells_[position_of(coordinate)] & SHIP);
+        }
+
+        bool try_emplace_ship(const Coordinate &base_coordinate,
+                              const Direction &direction, const size_t &size) override {
+            BATTLESHIPS_INSTRUMENT(FIELD_TRY_EMPLACE_SHIP);
+            check_bounds(base_coordinate);
+            journal_.check_not_recording();
+
+            const auto base = position_of(base_coordinate);
+            if (!can_place_at_position(base)) return false;
+
+            const auto step = DIRECTION_OFFSETS[direction];
+            if (size != 1) {
+                if (is_out_of_bounds(base_coordinate.move(direction, static_cast<int>(size) - 1))) return false;
+
+                auto cell = base;
+                for (size_t i = 1; i < size; ++i) if (!can_place_at_position(cell += step)) return false;
+            }
+
+            const auto ship_id = ShipId(registry_.add(base_coordinate, direction, size));
+            auto cell = base;
+            for (size_t i = 0; i < size; ++i, cell += step) {
+                cells_[cell] |= SHIP;
+                ship_ids_[cell] = ship_id;
+            }
+            ship_cells_alive_ += size;
+
+            return true;
+        }
+
+        AttackStatus attack(const Coordinate &coordinate) override {
+            BATTLESHIPS_INSTRUMENT(FIELD_ATTACK);
+            check_bounds(coordinate);
+
+            return attack_in_bounds(coordinate);
+        }
+
+        void attack_batch(const span<const Coordinate> coordinates, const span<AttackStatus> statuses) override {
+            BATTLESHIPS_INSTRUMENT(FIELD_ATTACK_BATCH);
+            check_batch_size(coordinates, statuses);
+            for (const auto &coordinate : coordinates) check_bounds(coordinate);
+
+            for (size_t i = 0; i < coordinates.size(); ++i) statuses[i] = attack_in_bounds(coordinates[i]);
+        }
+
+        /*
+         * Misc
+         */
+
+        void draw_to(ConsoleFrame &frame) const override {
+            string line;
+            // draw upper border
+            {
+                line = ' ';
+                auto letter = 'A';
+                for (size_t i = 0; i < W * 2 + 1; i++) line += i % 2 == 0 ? '|' : letter++;
+            }
+            frame.write(0, 0, line);
+
+            for (size_t y = 0; y < H; y++) {
+                line = to_string(y) + '|';
+                for (size_t x = 0; x < W; x++) (line += cells_[position_of(x, y)] & SHIP ? '#' : '~') += '|';
+                frame.write(0, y + 1, line);
+            }
+
+            // draw lower border
+            line = ' ';
+            for (size_t i = 0; i < W * 2 + 1; i++) line += "¯";
+            frame.write(0, H + 1, line);
+        }
+
+        [[nodiscard]] char get_public_icon_at(const Coordinate &coordinate) const override {
+            check_bounds(coordinate);
+
+            const auto cell = cells_[position_of(coordinate)];
+            return cell & DISCOVERED ? cell & SHIP ? '#' : '~' : '.';
+        }
+
+        void get_public_icons(string &icons) const override {
+            icons.resize(W * H);
+            for (size_t number = 0; number < W * H; ++number) {
+                const auto cell = cells_[POSITIONS[number]];
+                icons[number] = cell & DISCOVERED ? cell & SHIP ? '#' : '~' : '.';
+            }
+        }
+
+        [[nodiscard]] inline bool is_in_bounds(const Coordinate &coordinate) const noexcept override {
+            // negative coordinates wrap around to the values greater than any size
+            return size_t(coordinate.x) < W && size_t(coordinate.y) < H;
+        }
+
+        [[nodiscard]] inline bool is_out_of_bounds(const Coordinate &coordinate) const noexcept override {
+            return size_t(coordinate.x) >= W || size_t(coordinate.y) >= H;
+        }
+
+        void reset() noexcept override {
+            cells_ = EMPTY_CELLS;
+            registry_.clear();
+            not_visited_.reset();
+            ship_cells_alive_ = 0;
+            journal_.clear();
+        }
+
+        void push_checkpoint() override {
+            journal_.push_checkpoint(ship_cells_alive_);
+        }
+
+        void rollback() override {
+            ship_cells_alive_ = journal_.rollback(registry_, [this](const Coordinate &coordinate,
+                                                                    const uint32_t &position) {
+                cells_[position_of(coordinate)] &= uint8_t(~DISCOVERED);
+                not_visited_.restore(coordinate, position);
+            });
+        }
+
+        [[nodiscard]] bool can_place_at(const Coordinate &coordinate) const override {
+            BATTLESHIPS_INSTRUMENT(FIELD_CAN_PLACE_AT);
+            check_bounds(coordinate);
+
+            return can_place_at_position(position_of(coordinate));
+        }
+
+        void locate_not_visited_spot(Coordinate &coordinate, Direction direction, const bool &clockwise) const override {
+            BATTLESHIPS_INSTRUMENT(FIELD_LOCATE_NOT_VISITED_SPOT);
+            if (is_discovered(coordinate)) {
+                size_t step_count = 0;
+
+                bool last_was_without_steps = false;
+                while (true) { // this will finally fail
+                    ++step_count;
+                    bool made_no_steps = true;
+
+                    for (size_t attempt = 0; attempt < 2; attempt++) {
+                        for (size_t i = 0; i < step_count; i++) {
+                            coordinate.move(direction, step_count);
+                            if (is_in_bounds(coordinate)) {
+                                if (!is_discovered(coordinate)) return;
+                                made_no_steps = false;
+                            } else coordinate.move(direction, -step_count); // undo
+                        }
+
+                        // make a rotation
+                        direction = clockwise ? rotate_direction_clockwise(direction)
+                                              : rotate_direction_counter_clockwise(direction);
+                    }
+
+                    // check can be done right now
+                    if (made_no_steps) {
+                        if (last_was_without_steps) {
+                            for (coordinate.x = 0; coordinate.x < int(W); ++coordinate.x)
+                                for (coordinate.y = 0; coordinate.y < int(H); ++coordinate.y)
+                                    if (!is_discovered(coordinate)) return;
+
+                            throw runtime_error("The game has no free spots");
+                        }
+
+                        last_was_without_steps = true;
+                    } else last_was_without_steps = false;
+                }
+            }
+        }
+
+        [[nodiscard]] size_t count_not_visited() const noexcept override {
+            return not_visited_.size();
+        }
+
+        [[nodiscard]] Coordinate random_not_visited_spot(RandomEngine &random) const override {
+            return not_visited_.random(random);
+        }
+
+        [[nodiscard]] const ShipRegistry &get_ships() const noexcept override {
+            return registry_;
+        }
+
+        [[nodiscard]] GameField *clone() const override {
+            return new FixedGameField(*this);
+        }
+    };
+
+    /**
+     * @brief Field of the classic 10x10 game
+     */
+    using ClassicGameField = FixedGameField<10, 10>;
+}
@@ -0,0 +1,382 @@
+#include "fleet_feasibility.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bitboard.h"
+
+using std::atomic;
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+namespace battleships {
+
+    namespace {
+
+        /**
+         * @brief Maximal number of failed states memoized by a single search task before those get forgotten
+         */
+        constexpr size_t MAX_MEMOIZED_FAILURES = size_t(1) << 20u;
+
+        /**
+         * @brief Number of states per thread of the pool to split the search into
+         */
+        constexpr size_t SPLIT_STATES_PER_THREAD = 4;
+
+        /**
+         * @brief Maximal number of the first decisions expanded while splitting the search
+         */
+        constexpr size_t MAX_SPLIT_LEVELS = 16;
+
+        /**
+         * @brief Lengths of all the ships of the configuration from the largest to the smallest ones
+         */
+        [[nodiscard]] vector<size_t> fleet_of(const GameConfiguration &configuration) {
+            vector<size_t> fleet;
+            for (auto iterator = configuration.ships.rbegin(); iterator != configuration.ships.rend(); ++iterator)
+                fleet.insert(fleet.end(), iterator->second, iterator->first);
+
+            return fleet;
+        }
+
+        /**
+         * @brief Checks whether the ships may be packed into the shelves of the given length
+         * leaving an empty shelf between each two used ones (i.e. those are either rows or columns).
+         * The ships are put at the first shelf at which they fit (i.e. first fit decreasing).
+         */
+        [[nodiscard]] bool fit_into_shelves(const vector<size_t> &fleet, const size_t &shelf_length,
+                                            const size_t &shelf_count) {
+            // each ship takes its cells and the gap after it while the last gap of the shelf is beyond the field
+            vector<size_t> space_left((shelf_count + 1) / 2, shelf_length + 1);
+            for (const auto &length : fleet) {
+                const auto shelf = std::find_if(space_left.begin(), space_left.end(), [&](const size_t &space) {
+                    return space >= length + 1;
+                });
+                if (shelf == space_left.end()) return false;
+
+                *shelf -= length + 1;
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief State of the search in which all the cells before the cursor have been decided
+         */
+        struct SearchState {
+            /**
+             * @brief Index of the first undecided cell
+             */
+            size_t cursor;
+            /**
+             * @brief Cells which are either occupied or touched by the placed ships
+             */
+            Bitboard blocked;
+            /**
+             * @brief Numbers of ships left to place by the indices of their lengths
+             */
+            vector<size_t> ships_left;
+        };
+
+        /**
+         * @brief Checks whether the ship may be anchored at the cell (i.e. all its cells are free).
+         */
+        [[nodiscard]] bool fits(const Bitboard &valid, const Bitboard &blocked, const size_t &anchor,
+                                const size_t &size, const bool &vertical) noexcept {
+            const auto step = vertical ? valid.stride() : 1;
+            if (vertical && anchor / valid.stride() + size > valid.height()) return false;
+
+            // the guard column is not valid so horizontal ships never wrap
+            for (size_t i = 0, cell = anchor; i < size; ++i, cell += step)
+                if (cell >= valid.height() * valid.stride() || !valid.test(cell) || blocked.test(cell)) return false;
+
+            return true;
+        }
+
+        /**
+         * @brief Blocks the cells of the ship with the given anchor and its halo.
+         */
+        void block_ship(Bitboard &blocked, const size_t &size, const bool &vertical, const size_t &anchor) noexcept {
+            const auto anchor_x = anchor % blocked.stride(), anchor_y = anchor / blocked.stride();
+            const auto last_x = std::min(anchor_x + (vertical ? 1 : size), blocked.width() - 1),
+                    last_y = std::min(anchor_y + (vertical ? size : 1), blocked.height() - 1);
+            for (auto y = anchor_y == 0 ? 0 : anchor_y - 1; y <= last_y; ++y)
+                for (auto x = anchor_x == 0 ? 0 : anchor_x - 1; x <= last_x; ++x) blocked.set(x, y);
+        }
+
+        /**
+         * @brief Calls the consumer for each state following the given one, i.e. for the ones with each ship anchored
+         * at the state's first free cell and for the one with the cell left empty. There are none if no cells are free.
+         */
+        template<typename C>
+        void for_each_next_state(const Bitboard &valid, const vector<size_t> &lengths, const SearchState &state,
+                                 const C &consumer) {
+            const auto cursor = valid.find_next_without(state.blocked, state.cursor);
+            if (cursor == Bitboard::npos) return;
+
+            for (size_t length = 0; length < lengths.size(); ++length) if (state.ships_left[length] != 0)
+                for (const auto vertical : {false, true}) {
+                    const auto size = lengths[length];
+                    if ((vertical && size == 1) || !fits(valid, state.blocked, cursor, size, vertical)) continue;
+
+                    SearchState next{cursor + 1, state.blocked, state.ships_left};
+                    block_ship(next.blocked, size, vertical, cursor);
+                    --next.ships_left[length];
+                    consumer(std::move(next));
+                }
+            consumer(SearchState{cursor + 1, state.blocked, state.ships_left});
+        }
+
+        /**
+         * @brief Exhaustive search of a layout deciding the free cells one by one in the order of their indices,
+         * each one being either left empty or made the anchor (i.e. the left or lower cell) of some ship.
+         *
+         * The failed states are memoized by the cursor, the cells blocked after it and the ships left,
+         * so the search is a memoized broken-profile one.
+         */
+        class LayoutSearch {
+
+            const Bitboard &valid_;
+
+            /**
+             * @brief Distinct lengths of the ships from the longest to the shortest ones
+             */
+            const vector<size_t> &lengths_;
+
+            /**
+             * @brief Flag set once any of the searches succeeds so that the others stop
+             */
+            const atomic<bool> &found_;
+
+            /**
+             * @brief Blocked cells after placing each number of ships
+             */
+            vector<Bitboard> blocked_;
+
+            vector<size_t> ships_left_;
+
+            /**
+             * @brief Total cell count and shadow area of the ships left
+             */
+            size_t cells_left_ = 0, shadows_left_ = 0;
+
+            /**
+             * @brief Shadows of the free cells at the field extended by a row and a column
+             */
+            Bitboard shadows_, scratch_;
+
+            /**
+             * @brief Numbers of ships left with which the search has already failed by the keys of the states,
+             * only the minimal ones are stored as the search also fails with more ships left
+             */
+            unordered_map<string, vector<vector<size_t>>> failures_;
+
+            size_t failure_count_ = 0;
+
+            /**
+             * @brief Checks whether the ships left fit the free cells from the cursor by their cell count
+             * and by the area of their shadows.
+             *
+             * The shadow of a ship is the ship extended by a cell right and up, so the shadows of non-touching ships
+             * never intersect and lay at the field extended by a column and a row.
+             */
+            [[nodiscard]] bool bounds_hold(const Bitboard &blocked, const size_t &cursor) noexcept {
+                auto *const shadows = shadows_.words();
+                const auto *const blocked_words = blocked.words(), *const valid_words = valid_.words();
+                for (size_t i = 0; i < shadows_.word_count(); ++i) {
+                    if (i < cursor >> 6u || i >= blocked.word_count()) shadows[i] = 0;
+                    else shadows[i] = valid_words[i] & ~blocked_words[i];
+                }
+                shadows[cursor >> 6u] &= ~uint64_t(0) << (cursor & 63u);
+                if (shadows_.count() < cells_left_) return false;
+
+                // the guard column of the extended field is the extra column
+                for (const auto step : {size_t(1), shadows_.stride()}) {
+                    scratch_ = shadows_;
+                    scratch_.shift_up(step);
+                    shadows_ |= scratch_;
+                }
+
+                return shadows_.count() >= shadows_left_;
+            }
+
+            [[nodiscard]] static string state_key(const Bitboard &blocked, const size_t &cursor) {
+                const auto first_word = cursor >> 6u;
+                string key(reinterpret_cast<const char *>(blocked.words() + first_word),
+                           (blocked.word_count() - first_word) * sizeof(uint64_t));
+                // the cells before the cursor are already decided
+                reinterpret_cast<uint64_t *>(key.data())[0] &= ~uint64_t(0) << (cursor & 63u);
+                key.append(reinterpret_cast<const char *>(&cursor), sizeof(cursor));
+
+                return key;
+            }
+
+            /**
+             * @brief Checks whether a is less than or equal to b in each of the numbers of ships.
+             */
+            [[nodiscard]] static bool dominates(const vector<size_t> &a, const vector<size_t> &b) noexcept {
+                for (size_t i = 0; i < a.size(); ++i) if (a[i] > b[i]) return false;
+                return true;
+            }
+
+            [[nodiscard]] bool has_failed(const string &key) const {
+                const auto failures = failures_.find(key);
+                if (failures == failures_.end()) return false;
+
+                return std::any_of(failures->second.begin(), failures->second.end(),
+                                   [this](const vector<size_t> &ships_left) {
+                                       return dominates(ships_left, ships_left_);
+                                   });
+            }
+
+            void add_failure(string &&key) {
+                if (failure_count_ >= MAX_MEMOIZED_FAILURES) {
+                    failures_.clear();
+                    failure_count_ = 0;
+                }
+
+                auto &failures = failures_[std::move(key)];
+                const auto dominated = std::remove_if(failures.begin(), failures.end(),
+                                                      [this](const vector<size_t> &ships_left) {
+                                                          return dominates(ships_left_, ships_left);
+                                                      });
+                failure_count_ -= size_t(failures.end() - dominated);
+                failures.erase(dominated, failures.end());
+                failures.push_back(ships_left_);
+                ++failure_count_;
+            }
+
+            bool search(const size_t &depth, size_t cursor) {
+                if (cells_left_ == 0) return true;
+
+                const auto &blocked = blocked_[depth];
+                vector<string> visited;
+                // leaving the cell empty is the same as continuing from the next one
+                for (cursor = valid_.find_next_without(blocked, cursor); cursor != Bitboard::npos;
+                     cursor = valid_.find_next_without(blocked, cursor + 1)) {
+                    if (found_.load(std::memory_order_relaxed) || !bounds_hold(blocked, cursor)) break;
+
+                    auto key = state_key(blocked, cursor);
+                    if (has_failed(key)) break;
+                    visited.push_back(std::move(key));
+
+                    for (size_t length = 0; length < lengths_.size(); ++length) if (ships_left_[length] != 0)
+                        for (const auto vertical : {false, true}) {
+                            const auto size = lengths_[length];
+                            if ((vertical && size == 1) || !fits(valid_, blocked, cursor, size, vertical)) continue;
+
+                            auto &next = blocked_[depth + 1];
+                            next = blocked;
+                            block_ship(next, size, vertical, cursor);
+                            --ships_left_[length];
+                            cells_left_ -= size;
+                            shadows_left_ -= 2 * (size + 1);
+
+                            const auto placed = search(depth + 1, cursor + 1);
+
+                            ++ships_left_[length];
+                            cells_left_ += size;
+                            shadows_left_ += 2 * (size + 1);
+                            if (placed) return true;
+                        }
+                }
+
+                for (auto &key : visited) add_failure(std::move(key));
+
+                return false;
+            }
+
+        public:
+
+            LayoutSearch(const Bitboard &valid, const vector<size_t> &lengths, const atomic<bool> &found)
+                    : valid_(valid), lengths_(lengths), found_(found),
+                      shadows_(valid.width(), valid.height() + 1), scratch_(valid.width(), valid.height() + 1) {}
+
+            /**
+             * @brief Searches for the placements of the ships left starting from the state.
+             *
+             * @return {@code true} if all the ships have been placed
+             */
+            bool search(const SearchState &state) {
+                ships_left_ = state.ships_left;
+                cells_left_ = shadows_left_ = 0;
+                size_t ship_count = 0;
+                for (size_t length = 0; length < lengths_.size(); ++length) {
+                    ship_count += ships_left_[length];
+                    cells_left_ += ships_left_[length] * lengths_[length];
+                    shadows_left_ += ships_left_[length] * 2 * (lengths_[length] + 1);
+                }
+                blocked_.resize(ship_count + 1, Bitboard(valid_.width(), valid_.height()));
+                blocked_[0] = state.blocked;
+
+                return search(0, state.cursor);
+            }
+        };
+    }
+
+    bool is_fleet_placeable(const GameConfiguration &configuration, ThreadPool *const thread_pool) {
+        // the field is searched row by row so its rows should be the shorter ones
+        const auto width = std::min(configuration.field_width, configuration.field_height),
+                height = std::max(configuration.field_width, configuration.field_height);
+        const auto fleet = fleet_of(configuration);
+        if (fleet.empty()) return true;
+        if (fleet.back() == 0) return false;
+
+        // bounds: the longest ship should fit the field and the shadows of the ships should fit it extended
+        if (fleet.front() > std::max(width, height)) return false;
+        size_t required_shadows = 0;
+        for (const auto &length : fleet) required_shadows += 2 * (length + 1);
+        if (required_shadows > (width + 1) * (height + 1)) return false;
+
+        // certificates: the ships packed into every other row or column
+        if (fit_into_shelves(fleet, width, height) || fit_into_shelves(fleet, height, width)) return true;
+
+        const auto valid = Bitboard::full(width, height);
+        vector<size_t> lengths;
+        SearchState initial{0, Bitboard(width, height), {}};
+        for (auto iterator = configuration.ships.rbegin(); iterator != configuration.ships.rend(); ++iterator)
+            if (iterator->second != 0) {
+                lengths.push_back(iterator->first);
+                initial.ships_left.push_back(iterator->second);
+            }
+
+        // the first decisions are expanded so that there are enough independent states to search in parallel
+        const auto min_state_count = SPLIT_STATES_PER_THREAD * thread_pool->size();
+        vector<SearchState> states{std::move(initial)};
+        for (size_t level = 0; level < MAX_SPLIT_LEVELS && states.size() < min_state_count; ++level) {
+            vector<SearchState> next_states;
+            for (const auto &state : states) {
+                const auto all_placed = std::all_of(state.ships_left.begin(), state.ships_left.end(),
+                                                    [](const size_t &count) { return count == 0; });
+                if (all_placed) return true;
+
+                for_each_next_state(valid, lengths, state, [&](SearchState &&next) {
+                    next_states.push_back(std::move(next));
+                });
+            }
+            if (next_states.empty()) return false;
+
+            states = std::move(next_states);
+        }
+
+        atomic<bool> found(false);
+        thread_pool->run_batch(states.size(), [&](const size_t &index) {
+            if (found.load(std::memory_order_relaxed)) return;
+
+            if (LayoutSearch(valid, lengths, found).search(states[index])) found.store(true, std::memory_order_relaxed);
+        });
+
+        return found.load();
+    }
+
+    LayoutCount count_legal_layouts(const GameConfiguration &configuration) {
+        // the sampler requires the fleet to have some layouts
+        if (!is_fleet_placeable(configuration)) return 0;
+
+        return UniformLayoutSampler(configuration).layout_count();
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "game_configuration.h"
+#include "thread_pool.h"
+#include "uniform_layout_sampler.h"
+
+namespace battleships {
+
+    /**
+     * @brief Decides whether all the ships of the configuration can be placed at its field.
+     *
+     * Fleets are rejected by the bounds on the ships' lengths and areas, and accepted once a layout is built
+     * by packing the ships into every other row or column. Only the fleets which are decided by neither of those
+     * get searched for a layout exhaustively cell by cell memoizing the failed states, the search being split
+     * by its first decisions between the threads of the pool.
+     *
+     * @param configuration configuration to check
+     * @param thread_pool pool on which the exhaustive search is performed
+     * @return {@code true} if there is a legal layout of the fleet and {@code false} otherwise
+     */
+    [[nodiscard]] bool is_fleet_placeable(const GameConfiguration &configuration,
+                                          ThreadPool *thread_pool = &ThreadPool::shared());
+
+    /**
+     * @brief Counts all the legal layouts of the configuration.
+     *
+     * @param configuration configuration whose layouts are counted
+     * @return number of legal layouts
+     * @throws invalid_argument if the field is too wide for the fleet to be counted
+     * @throws runtime_error if there are too many layouts to count
+     */
+    [[nodiscard]] LayoutCount count_legal_layouts(const GameConfiguration &configuration);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "coordinate.h"
+#include "random_engine.h"
+
+using std::runtime_error;
+using std::uniform_int_distribution;
+using std::vector;
+
+namespace battleships {
+
+    /**
+     * @brief Set of the cells of a field which have not been discovered yet.
+     *
+     * The cells are stored densely with the position of each one in the dense array,
+     * so that a cell gets removed by swapping it with the last one
+     * and a random cell is picked by a single random index.
+     */
+    class FreeCellIndex {
+
+        const size_t width_;
+
+        /**
+         * @brief Numbers of the free cells (i.e. {@code y * width + x}) in no particular order
+         */
+        vector<uint32_t> cells_;
+
+        /**
+         * @brief Positions of the cells in {@code cells_} by their numbers, {@code NOT_FREE} for the removed ones
+         */
+        vector<uint32_t> positions_;
+
+    public:
+
+        /**
+         * @brief Position of the cells which are not free
+         */
+        constexpr static uint32_t NOT_FREE = uint32_t(-1);
+
+        FreeCellIndex(const size_t &width, const size_t &height)
+                : width_(width), cells_(width * height), positions_(width * height) {
+            reset();
+        }
+
+        /**
+         * @brief Makes all the cells free.
+         */
+        inline void reset() noexcept {
+            cells_.resize(positions_.size());
+            for (uint32_t cell = 0; cell < positions_.size(); ++cell) cells_[cell] = positions_[cell] = cell;
+        }
+
+        [[nodiscard]] inline size_t size() const noexcept {
+            return cells_.size();
+        }
+
+        [[nodiscard]] inline bool empty() const noexcept {
+            return cells_.empty();
+        }
+
+        [[nodiscard]] inline bool contains(const Coordinate &coordinate) const noexcept {
+            return positions_[coordinate.y * width_ + coordinate.x] != NOT_FREE;
+        }
+
+        /**
+         * @brief Removes the cell if it is free.
+         *
+         * @param coordinate coordinate of the removed cell
+         * @return position which the cell has been removed from or {@code NOT_FREE} if it was not free
+         */
+        inline uint32_t remove(const Coordinate &coordinate) noexcept {
+            const auto cell = coordinate.y * width_ + coordinate.x;
+            const auto position = positions_[cell];
+            if (position == NOT_FREE) return NOT_FREE;
+
+            const auto last = cells_.back();
+            cells_[position] = last;
+            positions_[last] = position;
+            cells_.pop_back();
+            positions_[cell] = NOT_FREE;
+
+            return position;
+        }
+
+        /**
+         * @brief Undoes the last removal of a cell which has not been undone yet, restoring the order of the cells.
+         *
+         * @param coordinate coordinate of the removed cell
+         * @param position position which the cell has been removed from
+         */
+        inline void restore(const Coordinate &coordinate, const uint32_t &position) noexcept {
+            const auto cell = uint32_t(coordinate.y * width_ + coordinate.x);
+            const auto end = uint32_t(cells_.size());
+            // the capacity never shrinks so this does not allocate
+            if (position == end) cells_.push_back(cell);
+            else {
+                const auto moved = cells_[position];
+                cells_.push_back(moved);
+                positions_[moved] = end;
+                cells_[position] = cell;
+            }
+            positions_[cell] = position;
+        }
+
+        /**
+         * @brief Picks a uniformly random free cell.
+         *
+         * @param random random engine used to pick the cell
+         * @return coordinate of the picked cell
+         * @throws runtime_error if there are no free cells
+         */
+        [[nodiscard]] inline Coordinate random(RandomEngine &random) const {
+            if (cells_.empty()) throw runtime_error("The game has no free spots");
+
+            const auto cell = cells_[uniform_int_distribution<size_t>(0, cells_.size() - 1)(random)];
+
+            return Coordinate(static_cast<int>(cell % width_), static_cast<int>(cell / width_));
+        }
+    };
+}
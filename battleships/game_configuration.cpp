@@ -0,0 +1,45 @@
+#include "game_configuration.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "fleet_feasibility.h"
+
+using std::invalid_argument;
+
+namespace battleships {
+
+    GameConfiguration GameConfiguration::parse(const string &spec) {
+        if (spec == "classic") return classic();
+
+        const auto colon = spec.find(':'), cross = spec.find('x');
+        if (colon == string::npos || cross == string::npos || cross > colon)
+            throw invalid_argument("Malformed configuration " + spec);
+
+        GameConfiguration configuration(std::stoul(spec.substr(0, cross)),
+                                        std::stoul(spec.substr(cross + 1, colon - cross - 1)), 0);
+        for (auto start = colon + 1; start < spec.size();) {
+            const auto end = std::min(spec.find(',', start), spec.size());
+            const auto ship = spec.substr(start, end - start);
+            start = end + 1;
+
+            const auto star = ship.find('*');
+            if (star == string::npos) throw invalid_argument("Malformed ship " + ship);
+
+            const auto length = std::stoul(ship.substr(0, star)), count = std::stoul(ship.substr(star + 1));
+            if (length == 0 || count == 0) throw invalid_argument("Malformed ship " + ship);
+            configuration.ships[length] += count;
+            configuration.max_ship_length = std::max<size_t>(configuration.max_ship_length, length);
+        }
+        if (configuration.field_width == 0 || configuration.field_height == 0 || configuration.ships.empty())
+            throw invalid_argument("Malformed configuration " + spec);
+        if (!configuration.are_ships_valid())
+            throw invalid_argument("Ships of the configuration " + spec + " cannot be placed at its field");
+
+        return configuration;
+    }
+
+    bool GameConfiguration::are_ships_valid() const {
+        return is_fleet_placeable(*this);
+    }
+}
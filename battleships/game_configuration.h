@@ -2,8 +2,10 @@
 
 #include <cstddef>
 #include <map>
+#include <string>
 
 using std::map;
+using std::string;
 
 namespace battleships {
 
@@ -37,6 +39,29 @@ namespace battleships {
         GameConfiguration(const size_t &field_width, const size_t &field_height, const size_t &max_ship_length) :
                 field_width(field_width), field_height(field_height), max_ship_length(max_ship_length) {}
 
+        /**
+         * @brief Creates the configuration of the classic 10x10 game with ships of length from 1 to 4.
+         *
+         * @return classic game configuration
+         */
+        [[nodiscard]] static GameConfiguration classic() {
+            GameConfiguration configuration(10, 10, 4);
+
+            for (size_t i = 1; i <= 4; i++) configuration.ships.insert(std::pair(i, 4 - i + 1));
+
+            return configuration;
+        }
+
+        /**
+         * @brief Parses the specification of the configuration, either {@code classic}
+         * or {@code WIDTHxHEIGHT:LENGTH*COUNT,...} (e.g. {@code 8x8:1*3,2*2,3*1}).
+         *
+         * @param spec specification of the configuration
+         * @return parsed configuration
+         * @throws invalid_argument if the specification is malformed or its ships cannot be placed at its field
+         */
+        [[nodiscard]] static GameConfiguration parse(const string &spec);
+
         [[nodiscard]] size_t ship_cell_count() const {
             size_t ship_cell_count = 0;
 
@@ -45,11 +70,11 @@ namespace battleships {
             return ship_cell_count;
         }
 
-        bool are_ships_valid() {
-            size_t max_ship_coverage = 0;
-            for (const auto entry : ships) max_ship_coverage += entry.second * (6 + entry.first * 2);
-
-            return max_ship_coverage <= field_width * field_height;
-        }
+        /**
+         * @brief Checks whether all the ships can be placed at the field without touching each other.
+         *
+         * @return {@code true} if there is a legal layout of the ships and {@code false} otherwise
+         */
+        [[nodiscard]] bool are_ships_valid() const;
     };
 }
@@ -0,0 +1,34 @@
+#include "game_field.h"
+
+using std::to_string;
+
+namespace battleships {
+
+    void GameField::check_batch_size(const span<const Coordinate> &coordinates, const span<AttackStatus> &statuses) {
+        if (coordinates.size() != statuses.size()) throw invalid_argument(
+                "Batch of " + to_string(coordinates.size()) + " attacks cannot store "
+                + to_string(statuses.size()) + " statuses"
+        );
+    }
+
+    void GameField::attack_batch(const span<const Coordinate> coordinates, const span<AttackStatus> statuses) {
+        check_batch_size(coordinates, statuses);
+        for (const auto &coordinate : coordinates)
+            if (is_out_of_bounds(coordinate))
+                throw out_of_range(
+                        "Coordinate (" + to_string(coordinate.x)
+                        + ":" + to_string(coordinate.y) + ") is out of its range"
+                );
+
+        for (size_t i = 0; i < coordinates.size(); ++i) statuses[i] = attack(coordinates[i]);
+    }
+
+    void GameField::get_private_icons(string &icons) const {
+        get_public_icons(icons);
+        const auto width = get_configuration().field_width;
+        for (const auto &ship : get_ships()) for (size_t i = 0; i < ship.size; ++i) {
+            const auto cell = ship.cell(i);
+            if (!is_discovered(cell)) icons[cell.y * width + cell.x] = 'O';
+        }
+    }
+}
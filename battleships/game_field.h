@@ -3,12 +3,24 @@
 #include "console_printable.h"
 #include "coordinate.h"
 #include "game_configuration.h"
+#include "random_engine.h"
+#include "ship_registry.h"
+#include <memory>
+#include <span>
 #include <stdexcept>
+#include <string>
 
+using std::invalid_argument;
 using std::out_of_range;
 using std::runtime_error;
+using std::shared_ptr;
+using std::span;
+using std::string;
 
 namespace battleships {
+
+    class GameFieldSnapshot;
+
     class GameField : public ConsolePrintable {
 
     public:
@@ -16,6 +28,19 @@ namespace battleships {
             EMPTY_ALREADY_ATTACKED, SHIP_ALREADY_ATTACKED, MISS, DAMAGE_SHIP, DESTROY_SHIP, WIN
         };
 
+    protected:
+
+        /**
+         * @brief Checks that the results of the batch of attacks can be stored.
+         *
+         * @param coordinates coordinates of the attacked cells
+         * @param statuses span to store the results of the attacks in
+         * @throws invalid_argument if the sizes of the spans differ
+         */
+        static void check_batch_size(const span<const Coordinate> &coordinates, const span<AttackStatus> &statuses);
+
+    public:
+
         virtual ~GameField() = default;
 
         [[nodiscard]] virtual GameConfiguration get_configuration() const noexcept = 0;
@@ -30,16 +55,95 @@ namespace battleships {
 
         virtual AttackStatus attack(const Coordinate &coordinate) noexcept(false) = 0;
 
+        /**
+         * @brief Attacks the cells one after another with the same results as the separate attacks would have.
+         * None of the cells is attacked unless all of them are in bounds.
+         *
+         * @param coordinates coordinates of the attacked cells in the order of the attacks
+         * @param statuses span of the same size to store the results of the attacks in
+         * @throws invalid_argument if the sizes of the spans differ
+         * @throws out_of_range if any of the coordinates is out of bounds
+         */
+        virtual void attack_batch(span<const Coordinate> coordinates, span<AttackStatus> statuses);
+
         [[nodiscard]] virtual char get_public_icon_at(const Coordinate &coordinate) const = 0;
 
+        /**
+         * @brief Gets the public icons of all the cells.
+         *
+         * @param icons string to store the icons in row by row
+         */
+        virtual void get_public_icons(string &icons) const = 0;
+
+        /**
+         * @brief Gets the icons of all the cells as seen by the field's owner:
+         * the public icons with the ship cells which have not been hit yet shown as {@code 'O'}.
+         *
+         * @param icons string to store the icons in row by row
+         */
+        void get_private_icons(string &icons) const;
+
         [[nodiscard]] virtual bool is_in_bounds(const Coordinate &coordinate) const noexcept = 0;
 
         [[nodiscard]] virtual bool is_out_of_bounds(const Coordinate &coordinate) const noexcept = 0;
 
         virtual void reset() noexcept = 0;
 
+        /**
+         * @brief Pushes a checkpoint which the attacks made after it can be rolled back to.
+         * Until the checkpoint is rolled back the field records the cells and the ships changed by the attacks
+         * and no ships can be placed at it. Resetting the field drops all of its checkpoints.
+         */
+        virtual void push_checkpoint() = 0;
+
+        /**
+         * @brief Undoes all the attacks made since the last pushed checkpoint and pops it.
+         * This takes time proportional to the number of the cells changed by those.
+         *
+         * @throws runtime_error if there is no checkpoint
+         */
+        virtual void rollback() = 0;
+
         [[nodiscard]] virtual bool can_place_at(const Coordinate &coordinate) const = 0;
 
         virtual void locate_not_visited_spot(Coordinate &start, Direction direction, const bool &clockwise) const = 0;
+
+        /**
+         * @brief Counts the cells which have not been discovered yet.
+         *
+         * @return number of undiscovered cells
+         */
+        [[nodiscard]] virtual size_t count_not_visited() const noexcept = 0;
+
+        /**
+         * @brief Picks a uniformly random cell which has not been discovered yet.
+         *
+         * @param random random engine used to pick the cell
+         * @return coordinate of the picked cell
+         * @throws runtime_error if all the cells have been discovered
+         */
+        [[nodiscard]] virtual Coordinate random_not_visited_spot(RandomEngine &random) const = 0;
+
+        /**
+         * @brief Gets the ships placed at this field.
+         *
+         * @return registry of the placed ships in the order of their placement
+         */
+        [[nodiscard]] virtual const ShipRegistry &get_ships() const noexcept = 0;
+
+        /**
+         * @brief Creates an independent copy of this field in its current state.
+         *
+         * @return copy of this field of the same type owned by the caller
+         */
+        [[nodiscard]] virtual GameField *clone() const = 0;
+
+        /**
+         * @brief Takes an immutable snapshot of the current state of this field
+         * which is not affected by the later changes of the field.
+         *
+         * @return snapshot of this field which may be shared and read by multiple threads
+         */
+        [[nodiscard]] shared_ptr<const GameFieldSnapshot> snapshot() const;
     };
 }
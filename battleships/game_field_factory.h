@@ -0,0 +1,47 @@
+#pragma once
+
+#include "game_field.h"
+
+namespace battleships {
+
+    /**
+     * @brief Factory responsible for creating game fields
+     */
+    class GameFieldFactory {
+
+    public:
+
+        virtual ~GameFieldFactory() = default;
+
+        /**
+         * @brief Creates a new empty game field.
+         *
+         * @param configuration configuration of the created field
+         * @return created game field owned by the caller
+         */
+        [[nodiscard]] virtual GameField *create(const GameConfiguration &configuration) const = 0;
+    };
+
+    /**
+     * @brief Game field factory creating fields of the given type by their configuration-constructor
+     *
+     * @tparam F type of the created game fields
+     */
+    template<typename F>
+    class TypedGameFieldFactory final : public GameFieldFactory {
+
+    public:
+
+        [[nodiscard]] static const GameFieldFactory *instance() {
+            /**
+             * @brief Singleton instance of this factory
+             */
+            static TypedGameFieldFactory INSTANCE;
+            return &INSTANCE;
+        }
+
+        [[nodiscard]] GameField *create(const GameConfiguration &configuration) const override {
+            return new F(configuration);
+        }
+    };
+}
@@ -0,0 +1,14 @@
+#include "game_field_snapshot.h"
+
+namespace battleships {
+
+    shared_ptr<const GameFieldSnapshot> GameField::snapshot() const {
+        return std::make_shared<const GameFieldSnapshot>(*this);
+    }
+
+    GameFieldSnapshot::GameFieldSnapshot(const GameField &field) : state_(field.clone()) {}
+
+    unique_ptr<GameField> GameFieldSnapshot::fork() const {
+        return unique_ptr<GameField>(state_->clone());
+    }
+}
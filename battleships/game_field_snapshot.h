@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+
+#include "game_field.h"
+
+using std::unique_ptr;
+
+namespace battleships {
+
+    /**
+     * @brief Immutable state of a game field taken by {@link GameField#snapshot}.
+     *
+     * The snapshot keeps a flat copy of the field which is only ever accessed through its const methods,
+     * none of which modifies the field, so the snapshot may be read by any number of threads at once.
+     * Positions derived from it are explored by forking mutable fields, each fork being a flat copy of the state
+     * which costs a few allocations and copies of the field's arrays.
+     */
+    class GameFieldSnapshot {
+
+        const unique_ptr<const GameField> state_;
+
+    public:
+
+        /**
+         * @brief Takes the snapshot of the field.
+         *
+         * @param field field whose current state is copied
+         */
+        explicit GameFieldSnapshot(const GameField &field);
+
+        GameFieldSnapshot(const GameFieldSnapshot &) = delete;
+
+        GameFieldSnapshot &operator=(const GameFieldSnapshot &) = delete;
+
+        /**
+         * @brief Gets the read-only view of the state.
+         *
+         * @return field in the state of the snapshot
+         */
+        [[nodiscard]] const GameField &field() const noexcept {
+            return *state_;
+        }
+
+        /**
+         * @brief Creates a mutable field starting in the state of the snapshot whose changes do not affect it.
+         *
+         * @return field of the same type as the one the snapshot was taken of
+         */
+        [[nodiscard]] unique_ptr<GameField> fork() const;
+    };
+}
@@ -0,0 +1,348 @@
+#include "game_record.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::invalid_argument;
+using std::runtime_error;
+
+namespace battleships {
+
+    namespace {
+
+        constexpr size_t SHIP_KIND_SIZE = 4, SHIP_SIZE = 4, MOVE_SIZE = 2;
+
+        template<typename T>
+        void append_little_endian(string &buffer, const T &value) {
+            for (size_t i = 0; i < sizeof(T); ++i) buffer += char((value >> (i * 8)) & 0xFFu);
+        }
+
+        template<typename T>
+        [[nodiscard]] inline T load_little_endian(const uint8_t *const bytes) noexcept {
+            // this gets compiled into a single load on little-endian targets
+            T value = 0;
+            for (size_t i = 0; i < sizeof(T); ++i) value |= T(bytes[i]) << (i * 8);
+            return value;
+        }
+
+        [[nodiscard]] constexpr size_t padded(const size_t &size) noexcept {
+            return (size + 7) & ~size_t(7);
+        }
+
+        [[nodiscard]] constexpr size_t record_size(const size_t &ship_kind_count, const size_t &ship_count,
+                                                   const size_t &move_count) noexcept {
+            return padded(GAME_RECORD_HEADER_SIZE + ship_kind_count * SHIP_KIND_SIZE
+                          + ship_count * SHIP_SIZE + move_count * MOVE_SIZE);
+        }
+
+        void append_fleet(string &buffer, const vector<RegisteredShip> &fleet, const size_t &field_width) {
+            for (const auto &ship : fleet) {
+                append_little_endian(buffer, uint16_t(ship.coordinate.y * field_width + ship.coordinate.x));
+                buffer += char(ship.size);
+                buffer += char(ship.direction);
+            }
+        }
+
+        void copy_fleet(const GameField *const field, vector<RegisteredShip> &fleet) {
+            fleet.clear();
+            for (const auto &ship : field->get_ships()) {
+                fleet.push_back(ship);
+                fleet.back().hits = 0;
+            }
+        }
+    }
+
+    /*
+     * Record
+     */
+
+    GameRecord::GameRecord(const GameConfiguration &configuration, const uint64_t &seed)
+            : configuration_(configuration), seed_(seed) {
+        if (configuration.field_width * configuration.field_height > GAME_RECORD_MAX_CELLS)
+            throw invalid_argument("Field is too big to be recorded");
+        if (configuration.ships.size() > 0xFF) throw invalid_argument("There are too many ship kinds to be recorded");
+        for (const auto &ship_count : configuration.ships) if (ship_count.first > 0xFF || ship_count.second > 0xFFFF)
+            throw invalid_argument("Ships are too big or too many to be recorded");
+    }
+
+    void GameRecord::clear(const uint64_t &seed) noexcept {
+        seed_ = seed;
+        first_fleet_.clear();
+        second_fleet_.clear();
+        moves_.clear();
+        winner_ = UNFINISHED;
+    }
+
+    void GameRecord::record_fleets(const GameField *const first_field, const GameField *const second_field) {
+        copy_fleet(first_field, first_fleet_);
+        copy_fleet(second_field, second_fleet_);
+    }
+
+    size_t GameRecord::serialized_size() const noexcept {
+        return record_size(configuration_.ships.size(), first_fleet_.size() + second_fleet_.size(), moves_.size());
+    }
+
+    void GameRecord::serialize_to(string &buffer) const {
+        const auto size = serialized_size(), start = buffer.size();
+        buffer.reserve(start + size);
+
+        append_little_endian(buffer, uint32_t(size));
+        append_little_endian(buffer, uint32_t(moves_.size()));
+        append_little_endian(buffer, uint16_t(configuration_.field_width));
+        append_little_endian(buffer, uint16_t(configuration_.field_height));
+        append_little_endian(buffer, uint16_t(first_fleet_.size()));
+        append_little_endian(buffer, uint16_t(second_fleet_.size()));
+        buffer += char(configuration_.ships.size());
+        buffer += char(winner_);
+        append_little_endian(buffer, uint16_t(configuration_.max_ship_length));
+        append_little_endian(buffer, uint32_t(0));
+        append_little_endian(buffer, seed_);
+
+        for (const auto &ship_count : configuration_.ships) {
+            append_little_endian(buffer, uint16_t(ship_count.first));
+            append_little_endian(buffer, uint16_t(ship_count.second));
+        }
+        append_fleet(buffer, first_fleet_, configuration_.field_width);
+        append_fleet(buffer, second_fleet_, configuration_.field_width);
+        for (const auto move : moves_) append_little_endian(buffer, move);
+
+        buffer.resize(start + size, '\0');
+    }
+
+    /*
+     * Writer
+     */
+
+    GameRecordWriter::GameRecordWriter(const string &path) {
+        bool has_header = false;
+        {
+            std::ifstream in(path, std::ios::binary);
+            char header[GAME_RECORD_FILE_HEADER_SIZE];
+            if (in && in.read(header, sizeof(header))) {
+                if (!std::equal(GAME_RECORD_MAGIC, GAME_RECORD_MAGIC + sizeof(GAME_RECORD_MAGIC), header))
+                    throw runtime_error("Not a game record file: " + path);
+                if (load_little_endian<uint32_t>(reinterpret_cast<const uint8_t *>(header) + 8) != GAME_RECORD_VERSION)
+                    throw runtime_error("Unsupported game record version: " + path);
+                has_header = true;
+            } else if (in.gcount() != 0) throw runtime_error("Not a game record file: " + path);
+
+            if (has_header) {
+                // a record cut off by an interrupted writer is dropped so that the appended ones follow the valid ones
+                in.seekg(0, std::ios::end);
+                const auto file_size = uint64_t(in.tellg());
+                uint64_t valid_size = GAME_RECORD_FILE_HEADER_SIZE;
+                uint8_t size_bytes[4];
+                while (valid_size < file_size) {
+                    in.seekg(std::streamoff(valid_size));
+                    if (!in.read(reinterpret_cast<char *>(size_bytes), sizeof(size_bytes))) break;
+
+                    const auto size = load_little_endian<uint32_t>(size_bytes);
+                    if (size < GAME_RECORD_HEADER_SIZE || valid_size + size > file_size) break;
+                    valid_size += size;
+                }
+                in.close();
+                if (valid_size != file_size) std::filesystem::resize_file(path, valid_size);
+            }
+        }
+
+        out_.open(path, std::ios::binary | std::ios::app);
+        if (!out_) throw runtime_error("Cannot open the game record file: " + path);
+
+        if (!has_header) {
+            out_.write(GAME_RECORD_MAGIC, sizeof(GAME_RECORD_MAGIC));
+            append_little_endian(buffer_, GAME_RECORD_VERSION);
+            append_little_endian(buffer_, uint32_t(0));
+            out_.write(buffer_.data(), std::streamsize(buffer_.size()));
+            buffer_.clear();
+        }
+    }
+
+    void GameRecordWriter::write(const GameRecord &record) {
+        std::lock_guard<mutex> lock(mutex_);
+
+        buffer_.clear();
+        record.serialize_to(buffer_);
+        if (!out_.write(buffer_.data(), std::streamsize(buffer_.size())))
+            throw runtime_error("Cannot write the game record");
+    }
+
+    void GameRecordWriter::flush() {
+        std::lock_guard<mutex> lock(mutex_);
+
+        out_.flush();
+    }
+
+    /*
+     * View
+     */
+
+    uint32_t GameRecordView::size() const noexcept {
+        return load_little_endian<uint32_t>(data_);
+    }
+
+    uint32_t GameRecordView::move_count() const noexcept {
+        return load_little_endian<uint32_t>(data_ + 4);
+    }
+
+    size_t GameRecordView::field_width() const noexcept {
+        return load_little_endian<uint16_t>(data_ + 8);
+    }
+
+    size_t GameRecordView::field_height() const noexcept {
+        return load_little_endian<uint16_t>(data_ + 10);
+    }
+
+    uint64_t GameRecordView::seed() const noexcept {
+        return load_little_endian<uint64_t>(data_ + 24);
+    }
+
+    GameRecord::Winner GameRecordView::winner() const noexcept {
+        return GameRecord::Winner(data_[17]);
+    }
+
+    const uint8_t *GameRecordView::ships_data() const noexcept {
+        return data_ + GAME_RECORD_HEADER_SIZE + data_[16] * SHIP_KIND_SIZE;
+    }
+
+    GameConfiguration GameRecordView::configuration() const {
+        GameConfiguration configuration(field_width(), field_height(), load_little_endian<uint16_t>(data_ + 18));
+
+        const auto ship_kinds = data_ + GAME_RECORD_HEADER_SIZE;
+        for (size_t i = 0; i < data_[16]; ++i) configuration.ships.emplace(
+                load_little_endian<uint16_t>(ship_kinds + i * SHIP_KIND_SIZE),
+                load_little_endian<uint16_t>(ship_kinds + i * SHIP_KIND_SIZE + 2)
+        );
+
+        return configuration;
+    }
+
+    vector<RegisteredShip> GameRecordView::fleet(const bool &second) const {
+        const auto first_count = load_little_endian<uint16_t>(data_ + 12),
+                second_count = load_little_endian<uint16_t>(data_ + 14);
+        const auto width = field_width();
+
+        vector<RegisteredShip> fleet;
+        fleet.reserve(second ? second_count : first_count);
+        auto ship = ships_data() + (second ? first_count * SHIP_SIZE : 0);
+        for (size_t i = 0, count = second ? second_count : first_count; i < count; ++i, ship += SHIP_SIZE) {
+            const auto cell = load_little_endian<uint16_t>(ship);
+            fleet.push_back({
+                    Coordinate(static_cast<int>(cell % width), static_cast<int>(cell / width)),
+                    Direction(ship[3]), ship[2]
+            });
+        }
+
+        return fleet;
+    }
+
+    GameRecordView::MoveRange GameRecordView::moves() const noexcept {
+        const auto begin = ships_data()
+                           + (load_little_endian<uint16_t>(data_ + 12) + load_little_endian<uint16_t>(data_ + 14))
+                             * SHIP_SIZE;
+
+        return MoveRange(begin, begin + move_count() * MOVE_SIZE);
+    }
+
+    void GameRecordView::replay(GameField *const first_field, GameField *const second_field,
+                                const size_t &move_count) const {
+        const auto width = field_width(), height = field_height();
+        for (const auto field : {first_field, second_field}) {
+            const auto configuration = field->get_configuration();
+            if (configuration.field_width != width || configuration.field_height != height)
+                throw invalid_argument("Field is not of the recorded game's dimensions");
+        }
+
+        first_field->reset();
+        second_field->reset();
+        for (const auto second : {false, true}) for (const auto &ship : fleet(second))
+            if (!(second ? second_field : first_field)->try_emplace_ship(ship.coordinate, ship.direction, ship.size))
+                throw runtime_error("Recorded ship cannot be placed at " + ship.coordinate.to_string());
+
+        size_t replayed = 0;
+        for (const auto move : moves()) {
+            if (replayed++ == move_count) break;
+
+            const auto coordinate = move.coordinate(width);
+            if ((move.by_second ? first_field : second_field)->attack(coordinate) != move.status)
+                throw runtime_error("Attack of " + coordinate.to_string() + " differs from the recorded one");
+        }
+    }
+
+    /*
+     * Reader
+     */
+
+    GameRecordReader::const_iterator::const_iterator(const uint8_t *const position, const uint8_t *const end)
+            : position_(position), end_(end) {
+        if (position_ == end_) return;
+
+        const auto remaining = size_t(end_ - position_);
+        // the record which has not been written completely is treated as the end of the file
+        if (remaining < GAME_RECORD_HEADER_SIZE) {
+            position_ = end_;
+            return;
+        }
+        const GameRecordView record(position_);
+        if (record.size() > remaining) {
+            position_ = end_;
+            return;
+        }
+
+        const auto ship_count = size_t(load_little_endian<uint16_t>(position_ + 12))
+                                + load_little_endian<uint16_t>(position_ + 14);
+        if (record.size() != record_size(position_[16], ship_count, record.move_count())
+            || record.field_width() * record.field_height() > GAME_RECORD_MAX_CELLS)
+            throw runtime_error("Game record is corrupted");
+    }
+
+    GameRecordReader::const_iterator &GameRecordReader::const_iterator::operator++() {
+        return *this = const_iterator(position_ + GameRecordView(position_).size(), end_);
+    }
+
+    GameRecordReader::GameRecordReader(const string &path) {
+        const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) throw runtime_error("Cannot open the game record file: " + path);
+
+        struct stat file_stat{};
+        if (fstat(fd, &file_stat) == -1 || size_t(file_stat.st_size) < GAME_RECORD_FILE_HEADER_SIZE) {
+            close(fd);
+            throw runtime_error("Not a game record file: " + path);
+        }
+        size_ = size_t(file_stat.st_size);
+
+        const auto mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping stays valid once the descriptor is closed
+        close(fd);
+        if (mapping == MAP_FAILED) throw runtime_error("Cannot map the game record file: " + path);
+        data_ = static_cast<const uint8_t *>(mapping);
+        madvise(mapping, size_, MADV_SEQUENTIAL);
+
+        if (!std::equal(GAME_RECORD_MAGIC, GAME_RECORD_MAGIC + sizeof(GAME_RECORD_MAGIC),
+                        reinterpret_cast<const char *>(data_))) {
+            munmap(mapping, size_);
+            throw runtime_error("Not a game record file: " + path);
+        }
+        if (load_little_endian<uint32_t>(data_ + 8) != GAME_RECORD_VERSION) {
+            munmap(mapping, size_);
+            throw runtime_error("Unsupported game record version: " + path);
+        }
+    }
+
+    GameRecordReader::~GameRecordReader() {
+        munmap(const_cast<uint8_t *>(data_), size_);
+    }
+
+    GameRecordReader::const_iterator GameRecordReader::begin() const {
+        return const_iterator(data_ + GAME_RECORD_FILE_HEADER_SIZE, data_ + size_);
+    }
+
+    GameRecordReader::const_iterator GameRecordReader::end() const {
+        return const_iterator(data_ + size_, data_ + size_);
+    }
+}
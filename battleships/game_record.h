@@ -0,0 +1,457 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "game_configuration.h"
+#include "game_field.h"
+#include "rival_bot.h"
+#include "ship_registry.h"
+
+using std::mutex;
+using std::string;
+using std::vector;
+
+namespace battleships {
+
+    /*
+     * Binary format of the game records.
+     *
+     * The file starts with the 16-byte header made of the magic and the little-endian version (followed by 4 zero
+     * bytes), the records following it back to back. All the integers are little-endian and each record is padded
+     * with zeroes to a multiple of 8 bytes:
+     *
+     *   offset  size
+     *        0     4  size of the whole record in bytes
+     *        4     4  number of the moves
+     *        8     2  width of the field
+     *       10     2  height of the field
+     *       12     2  number of the first player's ships
+     *       14     2  number of the second player's ships
+     *       16     1  number of the ship kinds of the configuration
+     *       17     1  winner (see {@link GameRecord::Winner})
+     *       18     2  maximal length of a ship
+     *       20     4  zeroes
+     *       24     8  seed of the game
+     *       32        ship kinds as the pairs of 2-byte lengths and counts
+     *                 ships of the first player and then those of the second one as 2-byte numbers
+     *                 of their first cells ({@code y * width + x}) followed by their 1-byte sizes and directions
+     *                 moves as 2-byte words packed by {@link pack_move}
+     *
+     * A record cut off at the end of the file (i.e. the one whose writing was interrupted) is ignored by the reader.
+     */
+
+    constexpr char GAME_RECORD_MAGIC[8] = {'B', 'S', 'R', 'E', 'C', 'O', 'R', 'D'};
+
+    constexpr uint32_t GAME_RECORD_VERSION = 1;
+
+    constexpr size_t GAME_RECORD_FILE_HEADER_SIZE = 16;
+
+    constexpr size_t GAME_RECORD_HEADER_SIZE = 32;
+
+    /**
+     * @brief Maximal number of cells of a recorded field, its cells have to fit in 12 bits of a packed move
+     */
+    constexpr size_t GAME_RECORD_MAX_CELLS = 1u << 12u;
+
+    /**
+     * @brief Packs the move into a 2-byte word: the number of the attacked cell takes the lowest 12 bits,
+     * the attack status the following 3 bits and the highest bit is set for the moves of the second player.
+     *
+     * @param cell number of the attacked cell
+     * @param status status of the attack
+     * @param by_second whether the move was made by the second player
+     * @return packed move
+     */
+    [[nodiscard]] constexpr uint16_t pack_move(const size_t &cell, const GameField::AttackStatus &status,
+                                               const bool &by_second) noexcept {
+        return uint16_t(cell | (size_t(status) << 12u) | (size_t(by_second) << 15u));
+    }
+
+    /**
+     * @brief Move of a recorded game
+     */
+    struct RecordedMove {
+
+        /**
+         * @brief Number of the attacked cell (i.e. {@code y * width + x})
+         */
+        uint16_t cell;
+
+        GameField::AttackStatus status;
+
+        /**
+         * @brief Flag indicating whether the move was made by the second player (i.e. the one attacking
+         * the first field)
+         */
+        bool by_second;
+
+        [[nodiscard]] constexpr static RecordedMove unpack(const uint16_t &packed) noexcept {
+            return {uint16_t(packed & 0xFFFu), GameField::AttackStatus((packed >> 12u) & 0x7u), (packed >> 15u) != 0};
+        }
+
+        [[nodiscard]] inline Coordinate coordinate(const size_t &field_width) const noexcept {
+            return Coordinate(static_cast<int>(cell % field_width), static_cast<int>(cell / field_width));
+        }
+    };
+
+    /**
+     * @brief Game being recorded to be written by {@link GameRecordWriter}
+     */
+    class GameRecord {
+
+    public:
+
+        enum Winner : uint8_t {
+            UNFINISHED, FIRST, SECOND
+        };
+
+    private:
+
+        GameConfiguration configuration_;
+
+        uint64_t seed_;
+
+        vector<RegisteredShip> first_fleet_, second_fleet_;
+
+        vector<uint16_t> moves_;
+
+        Winner winner_ = UNFINISHED;
+
+    public:
+
+        /**
+         * @brief Creates an empty record of a game.
+         *
+         * @param configuration configuration of the game
+         * @param seed seed of the game
+         * @throws invalid_argument if the game's field or ships are too big to be recorded
+         */
+        explicit GameRecord(const GameConfiguration &configuration, const uint64_t &seed = 0);
+
+        [[nodiscard]] inline const GameConfiguration &configuration() const noexcept {
+            return configuration_;
+        }
+
+        [[nodiscard]] inline uint64_t seed() const noexcept {
+            return seed_;
+        }
+
+        [[nodiscard]] inline const vector<RegisteredShip> &fleet(const bool &second) const noexcept {
+            return second ? second_fleet_ : first_fleet_;
+        }
+
+        [[nodiscard]] inline const vector<uint16_t> &moves() const noexcept {
+            return moves_;
+        }
+
+        [[nodiscard]] inline Winner winner() const noexcept {
+            return winner_;
+        }
+
+        /**
+         * @brief Starts the record of a new game of the same configuration.
+         *
+         * @param seed seed of the new game
+         */
+        void clear(const uint64_t &seed = 0) noexcept;
+
+        /**
+         * @brief Records the ships placed at the fields of both players.
+         *
+         * @param first_field field of the first player
+         * @param second_field field of the second player
+         */
+        void record_fleets(const GameField *first_field, const GameField *second_field);
+
+        /**
+         * @brief Records the move, the game gets won by the move's player if its status is {@code WIN}.
+         *
+         * @param by_second whether the move was made by the second player
+         * @param coordinate attacked coordinate
+         * @param status status of the attack
+         */
+        inline void add_move(const bool &by_second, const Coordinate &coordinate,
+                             const GameField::AttackStatus &status) {
+            moves_.push_back(pack_move(coordinate.y * configuration_.field_width + coordinate.x, status, by_second));
+            if (status == GameField::WIN) winner_ = by_second ? SECOND : FIRST;
+        }
+
+        /**
+         * @brief Gets the size of the serialized record.
+         *
+         * @return size of the record in bytes
+         */
+        [[nodiscard]] size_t serialized_size() const noexcept;
+
+        /**
+         * @brief Appends the serialized record to the buffer.
+         *
+         * @param buffer buffer to append to
+         */
+        void serialize_to(string &buffer) const;
+    };
+
+    /**
+     * @brief Attack callback recording the moves of one of the players.
+     */
+    class RecordingAttackCallback : public RivalBot::AttackCallback {
+
+        GameRecord *const record_;
+
+        const bool by_second_;
+
+    public:
+
+        RecordingAttackCallback(GameRecord *const record, const bool &by_second)
+                : record_(record), by_second_(by_second) {}
+
+        void on_attack(const Coordinate &coordinate, const GameField::AttackStatus &attack_status) override {
+            record_->add_move(by_second_, coordinate, attack_status);
+        }
+    };
+
+    /**
+     * @brief Writer appending the records to a file. The writes are synchronized so it may be shared by threads.
+     */
+    class GameRecordWriter {
+
+        std::ofstream out_;
+
+        mutex mutex_;
+
+        string buffer_;
+
+    public:
+
+        /**
+         * @brief Opens the file to append the records to creating it if needed.
+         * The record cut off at the end of the file by an interrupted writer gets truncated.
+         *
+         * @param path path of the file
+         * @throws runtime_error if the file cannot be opened or is not a file of game records
+         */
+        explicit GameRecordWriter(const string &path);
+
+        GameRecordWriter(const GameRecordWriter &) = delete;
+
+        GameRecordWriter &operator=(const GameRecordWriter &) = delete;
+
+        /**
+         * @brief Appends the record to the file.
+         *
+         * @param record record to append
+         * @throws runtime_error if the record cannot be written
+         */
+        void write(const GameRecord &record);
+
+        /**
+         * @brief Flushes the written records to the file.
+         */
+        void flush();
+    };
+
+    /**
+     * @brief View of a record of the file mapped by {@link GameRecordReader} which reads it in place.
+     */
+    class GameRecordView {
+
+        const uint8_t *data_;
+
+        [[nodiscard]] const uint8_t *ships_data() const noexcept;
+
+    public:
+
+        /**
+         * @brief Iterator over the moves of the record unpacking them on the fly
+         */
+        class MoveIterator {
+
+            const uint8_t *position_;
+
+        public:
+
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = RecordedMove;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const RecordedMove *;
+            using reference = RecordedMove;
+
+            explicit MoveIterator(const uint8_t *const position) : position_(position) {}
+
+            [[nodiscard]] inline RecordedMove operator*() const noexcept {
+                return RecordedMove::unpack(uint16_t(position_[0] | (position_[1] << 8u)));
+            }
+
+            inline MoveIterator &operator++() noexcept {
+                position_ += 2;
+                return *this;
+            }
+
+            inline MoveIterator operator++(int) noexcept {
+                const auto previous = *this;
+                position_ += 2;
+                return previous;
+            }
+
+            [[nodiscard]] inline bool operator==(const MoveIterator &other) const noexcept {
+                return position_ == other.position_;
+            }
+
+            [[nodiscard]] inline bool operator!=(const MoveIterator &other) const noexcept {
+                return position_ != other.position_;
+            }
+        };
+
+        /**
+         * @brief Range of the moves of the record
+         */
+        class MoveRange {
+
+            const uint8_t *begin_, *end_;
+
+        public:
+
+            MoveRange(const uint8_t *const begin, const uint8_t *const end) : begin_(begin), end_(end) {}
+
+            [[nodiscard]] inline MoveIterator begin() const noexcept {
+                return MoveIterator(begin_);
+            }
+
+            [[nodiscard]] inline MoveIterator end() const noexcept {
+                return MoveIterator(end_);
+            }
+
+            [[nodiscard]] inline size_t size() const noexcept {
+                return size_t(end_ - begin_) / 2;
+            }
+        };
+
+        explicit GameRecordView(const uint8_t *const data) : data_(data) {}
+
+        /**
+         * @brief Gets the size of the record.
+         *
+         * @return size of the record in bytes including its padding
+         */
+        [[nodiscard]] uint32_t size() const noexcept;
+
+        [[nodiscard]] uint32_t move_count() const noexcept;
+
+        [[nodiscard]] size_t field_width() const noexcept;
+
+        [[nodiscard]] size_t field_height() const noexcept;
+
+        [[nodiscard]] uint64_t seed() const noexcept;
+
+        [[nodiscard]] GameRecord::Winner winner() const noexcept;
+
+        /**
+         * @brief Gets the configuration of the recorded game.
+         *
+         * @return configuration of the game
+         */
+        [[nodiscard]] GameConfiguration configuration() const;
+
+        /**
+         * @brief Gets the fleet of the player.
+         *
+         * @param second whether the fleet of the second player should be got
+         * @return ships of the player in the order of their placement
+         */
+        [[nodiscard]] vector<RegisteredShip> fleet(const bool &second) const;
+
+        [[nodiscard]] MoveRange moves() const noexcept;
+
+        /**
+         * @brief Replays the game into the fields resetting them first.
+         *
+         * @param first_field field of the first player
+         * @param second_field field of the second player
+         * @param move_count number of the moves to replay, all of them if it is greater than their number
+         * @throws invalid_argument if the fields are not of the recorded game's dimensions
+         * @throws runtime_error if the ships cannot be placed or the results of the attacks differ from the recorded ones
+         */
+        void replay(GameField *first_field, GameField *second_field, const size_t &move_count = size_t(-1)) const;
+    };
+
+    /**
+     * @brief Reader of the file of game records which maps it into memory
+     * so that the records are read without being copied.
+     */
+    class GameRecordReader {
+
+        const uint8_t *data_ = nullptr;
+
+        size_t size_ = 0;
+
+    public:
+
+        /**
+         * @brief Forward iterator over the records of the file
+         */
+        class const_iterator {
+
+            const uint8_t *position_, *end_;
+
+        public:
+
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = GameRecordView;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const GameRecordView *;
+            using reference = GameRecordView;
+
+            /**
+             * @brief Creates an iterator pointing to the record.
+             *
+             * @param position start of the record or {@code end} if there is none
+             * @param end end of the file
+             * @throws runtime_error if the record is corrupted
+             */
+            const_iterator(const uint8_t *position, const uint8_t *end);
+
+            [[nodiscard]] inline GameRecordView operator*() const noexcept {
+                return GameRecordView(position_);
+            }
+
+            /**
+             * @brief Moves to the next record.
+             *
+             * @throws runtime_error if the next record is corrupted
+             */
+            const_iterator &operator++();
+
+            [[nodiscard]] inline bool operator==(const const_iterator &other) const noexcept {
+                return position_ == other.position_;
+            }
+
+            [[nodiscard]] inline bool operator!=(const const_iterator &other) const noexcept {
+                return position_ != other.position_;
+            }
+        };
+
+        /**
+         * @brief Maps the file of the records.
+         *
+         * @param path path of the file
+         * @throws runtime_error if the file cannot be mapped or is not a file of game records
+         */
+        explicit GameRecordReader(const string &path);
+
+        GameRecordReader(const GameRecordReader &) = delete;
+
+        GameRecordReader &operator=(const GameRecordReader &) = delete;
+
+        ~GameRecordReader();
+
+        [[nodiscard]] const_iterator begin() const;
+
+        [[nodiscard]] const_iterator end() const;
+    };
+}
@@ -0,0 +1,143 @@
+#include "instrumentation.h"
+
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+using std::mutex;
+using std::vector;
+
+namespace battleships::instrumentation {
+
+    namespace {
+
+        const char *const OPERATION_NAMES[OPERATION_COUNT] = {
+                "field_attack", "field_attack_batch", "field_try_emplace_ship", "field_can_place_at",
+                "field_locate_not_visited_spot", "bot_place_ships", "bot_act"
+        };
+
+#ifdef BATTLESHIPS_INSTRUMENTATION
+        /**
+         * @brief Counters of the running threads and the totals of the exited ones
+         */
+        struct CounterRegistry {
+            mutex guard;
+            vector<const detail::ThreadCounters *> threads;
+            array<uint64_t, OPERATION_COUNT> exited_calls{}, exited_timed_calls{}, exited_ticks{};
+            /**
+             * @brief Moment at which the registry was created by the clock and in the ticks, used to convert the ticks
+             */
+            const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+            const uint64_t origin_ticks = detail::read_ticks();
+
+            [[nodiscard]] double seconds_per_tick() const {
+#if defined(__x86_64__) || defined(__i386__)
+                const auto ticks = detail::read_ticks() - origin_ticks;
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - origin;
+
+                return ticks == 0 ? 0 : elapsed.count() / double(ticks);
+#else
+                return 1e-9;
+#endif
+            }
+        };
+
+        /**
+         * @brief Gets the registry which is created before the first thread's counters
+         * so that it outlives those of all the threads.
+         */
+        [[nodiscard]] CounterRegistry &registry() {
+            static CounterRegistry REGISTRY;
+            return REGISTRY;
+        }
+#endif
+    }
+
+#ifdef BATTLESHIPS_INSTRUMENTATION
+    namespace detail {
+
+        ThreadCounters::ThreadCounters() {
+            auto &registry = instrumentation::registry();
+            std::lock_guard<mutex> lock(registry.guard);
+            registry.threads.push_back(this);
+        }
+
+        ThreadCounters::~ThreadCounters() {
+            auto &registry = instrumentation::registry();
+            std::lock_guard<mutex> lock(registry.guard);
+            for (size_t operation = 0; operation < OPERATION_COUNT; ++operation) {
+                registry.exited_calls[operation] += calls[operation].load(std::memory_order_relaxed);
+                registry.exited_timed_calls[operation] += timed_calls[operation].load(std::memory_order_relaxed);
+                registry.exited_ticks[operation] += ticks[operation].load(std::memory_order_relaxed);
+            }
+            std::erase(registry.threads, this);
+        }
+    }
+#endif
+
+    const char *operation_name(const Operation &operation) noexcept {
+        return OPERATION_NAMES[operation];
+    }
+
+    Snapshot take_snapshot() {
+        Snapshot snapshot;
+#ifdef BATTLESHIPS_INSTRUMENTATION
+        auto &registry = instrumentation::registry();
+        std::lock_guard<mutex> lock(registry.guard);
+
+        const auto seconds_per_tick = registry.seconds_per_tick();
+        for (size_t operation = 0; operation < OPERATION_COUNT; ++operation) {
+            auto calls = registry.exited_calls[operation], timed_calls = registry.exited_timed_calls[operation],
+                    ticks = registry.exited_ticks[operation];
+            for (const auto counters : registry.threads) {
+                calls += counters->calls[operation].load(std::memory_order_relaxed);
+                timed_calls += counters->timed_calls[operation].load(std::memory_order_relaxed);
+                ticks += counters->ticks[operation].load(std::memory_order_relaxed);
+            }
+            snapshot.operations[operation] = {
+                    calls, timed_calls == 0 ? 0 : double(ticks) * seconds_per_tick * double(calls) / double(timed_calls)
+            };
+        }
+#endif
+
+        return snapshot;
+    }
+
+    optional<SnapshotFormat> parse_snapshot_format(const string &name) {
+        if (name == "json") return JSON;
+        if (name == "prometheus") return PROMETHEUS;
+
+        return std::nullopt;
+    }
+
+    string format_snapshot(const Snapshot &snapshot, const SnapshotFormat &format) {
+        std::ostringstream out;
+        out << std::setprecision(9);
+
+        if (format == JSON) {
+            out << "{\"enabled\":" << (ENABLED ? "true" : "false") << ",\"operations\":{";
+            for (size_t operation = 0; operation < OPERATION_COUNT; ++operation) {
+                const auto &statistics = snapshot.operations[operation];
+                out << (operation == 0 ? "" : ",") << '"' << OPERATION_NAMES[operation] << "\":{\"calls\":"
+                    << statistics.calls << ",\"seconds\":" << statistics.seconds << '}';
+            }
+            out << "}}";
+        } else {
+            out << "# HELP battleships_operation_calls_total Calls of the instrumented operation\n"
+                << "# TYPE battleships_operation_calls_total counter\n";
+            for (size_t operation = 0; operation < OPERATION_COUNT; ++operation)
+                out << "battleships_operation_calls_total{operation=\"" << OPERATION_NAMES[operation] << "\"} "
+                    << snapshot.operations[operation].calls << '\n';
+            out << "# HELP battleships_operation_seconds_total Time spent in the instrumented operation"
+                   " including the nested ones\n"
+                << "# TYPE battleships_operation_seconds_total counter\n";
+            for (size_t operation = 0; operation < OPERATION_COUNT; ++operation)
+                out << "battleships_operation_seconds_total{operation=\"" << OPERATION_NAMES[operation] << "\"} "
+                    << snapshot.operations[operation].seconds << '\n';
+        }
+
+        return out.str();
+    }
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#ifdef BATTLESHIPS_INSTRUMENTATION
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+using std::array;
+using std::atomic;
+using std::optional;
+using std::string;
+
+/*
+ * Counters and timers of the hot operations of the fields and the bots.
+ *
+ * The instrumented operations are marked by {@code BATTLESHIPS_INSTRUMENT(OPERATION)} at the beginning of their
+ * bodies. Unless the project is configured with {@code BATTLESHIPS_INSTRUMENTATION} the mark expands to nothing.
+ * Otherwise each thread counts the calls and the time spent in the operations (including the nested ones)
+ * in its own counters which are only merged once a snapshot is taken. Reading the clock costs much more than
+ * the cheapest operations themselves so only a sample of their calls is timed and the total time is estimated by it.
+ */
+namespace battleships::instrumentation {
+
+    enum Operation {
+        FIELD_ATTACK, FIELD_ATTACK_BATCH, FIELD_TRY_EMPLACE_SHIP, FIELD_CAN_PLACE_AT, FIELD_LOCATE_NOT_VISITED_SPOT,
+        BOT_PLACE_SHIPS, BOT_ACT, OPERATION_COUNT
+    };
+
+    /**
+     * @brief Periods of the calls being timed by the operations, powers of two so that every placement of a fleet
+     * which takes microseconds and one in a few dozens of the calls which may take nanoseconds is timed
+     */
+    constexpr array<uint64_t, OPERATION_COUNT> TIMING_PERIODS = {64, 64, 64, 64, 64, 1, 64};
+
+    /**
+     * @brief Whether the operations are instrumented in this build
+     */
+#ifdef BATTLESHIPS_INSTRUMENTATION
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    /**
+     * @brief Gets the name of the operation as used by the exported snapshots.
+     *
+     * @param operation instrumented operation
+     * @return name of the operation
+     */
+    [[nodiscard]] const char *operation_name(const Operation &operation) noexcept;
+
+    /**
+     * @brief Totals of a single operation over all the threads
+     */
+    struct OperationStatistics {
+        uint64_t calls = 0;
+        /**
+         * @brief Time spent in the operation estimated by its timed calls
+         */
+        double seconds = 0;
+    };
+
+    /**
+     * @brief Totals of all the operations at the moment the snapshot was taken
+     */
+    struct Snapshot {
+        array<OperationStatistics, OPERATION_COUNT> operations{};
+    };
+
+    /**
+     * @brief Merges the counters of all the threads including the ones which have already exited.
+     * The counters of the running threads are read without stopping those so the snapshot may miss their last calls.
+     *
+     * @return snapshot of the counters, all zeros if the operations are not instrumented
+     */
+    [[nodiscard]] Snapshot take_snapshot();
+
+    enum SnapshotFormat {
+        JSON, PROMETHEUS
+    };
+
+    /**
+     * @brief Parses the name of the snapshot format.
+     *
+     * @param name {@code json} or {@code prometheus}
+     * @return parsed format or an empty optional if the name is unknown
+     */
+    [[nodiscard]] optional<SnapshotFormat> parse_snapshot_format(const string &name);
+
+    /**
+     * @brief Formats the snapshot as a single-line JSON object or the Prometheus text exposition.
+     *
+     * @param snapshot snapshot to format
+     * @param format format to use
+     * @return formatted snapshot
+     */
+    [[nodiscard]] string format_snapshot(const Snapshot &snapshot, const SnapshotFormat &format);
+
+#ifdef BATTLESHIPS_INSTRUMENTATION
+    namespace detail {
+
+        /**
+         * @brief Reads the cheapest monotonic clock available, the time stamp counter on x86.
+         *
+         * @return current time in the clock's ticks
+         */
+        [[nodiscard]] inline uint64_t read_ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()
+            ).count());
+#endif
+        }
+
+        /**
+         * @brief Counters of a single thread written by it only and read by the snapshots.
+         */
+        struct ThreadCounters {
+            array<atomic<uint64_t>, OPERATION_COUNT> calls{}, timed_calls{}, ticks{};
+
+            /**
+             * @brief Registers the counters to be merged by the snapshots.
+             */
+            ThreadCounters();
+
+            /**
+             * @brief Adds the counters to the totals of the exited threads.
+             */
+            ~ThreadCounters();
+
+            ThreadCounters(const ThreadCounters &) = delete;
+
+            ThreadCounters &operator=(const ThreadCounters &) = delete;
+        };
+
+        [[nodiscard]] inline ThreadCounters &thread_counters() {
+            thread_local ThreadCounters counters;
+            return counters;
+        }
+
+        /**
+         * @brief Increments the counter which is only written by the current thread.
+         */
+        inline void add(atomic<uint64_t> &counter, const uint64_t &value) noexcept {
+            // as there is a single writer the plain store is enough and avoids the locked instruction
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Timer counting the call of the operation and the time spent in it until its destruction
+     * if the call is one of the timed ones.
+     */
+    class ScopedTimer {
+
+        detail::ThreadCounters &counters_;
+
+        const Operation operation_;
+
+        /**
+         * @brief Ticks at which the call has started or {@code 0} if it is not timed
+         */
+        uint64_t start_ = 0;
+
+    public:
+
+        explicit ScopedTimer(const Operation &operation)
+                : counters_(detail::thread_counters()), operation_(operation) {
+            const auto calls = counters_.calls[operation].load(std::memory_order_relaxed);
+            counters_.calls[operation].store(calls + 1, std::memory_order_relaxed);
+            if ((calls & (TIMING_PERIODS[operation] - 1)) == 0) start_ = detail::read_ticks();
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+        ~ScopedTimer() {
+            if (start_ == 0) return;
+
+            const auto elapsed = detail::read_ticks() - start_;
+            detail::add(counters_.timed_calls[operation_], 1);
+            detail::add(counters_.ticks[operation_], elapsed);
+        }
+    };
+#endif
+}
+
+#ifdef BATTLESHIPS_INSTRUMENTATION
+#define BATTLESHIPS_INSTRUMENT(operation) const ::battleships::instrumentation::ScopedTimer \
+        battleships_instrumentation_timer_(::battleships::instrumentation::operation)
+#else
+#define BATTLESHIPS_INSTRUMENT(operation) static_cast<void>(0)
+#endif
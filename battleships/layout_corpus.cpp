@@ -0,0 +1,107 @@
+#include "layout_corpus.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using std::runtime_error;
+
+namespace battleships {
+
+    namespace {
+
+        template<typename T>
+        void write_little_endian(std::ostream &out, const T &value) {
+            char bytes[sizeof(T)];
+            for (size_t i = 0; i < sizeof(T); ++i) bytes[i] = char((value >> (i * 8)) & 0xFFu);
+            out.write(bytes, sizeof(T));
+        }
+
+        template<typename T>
+        [[nodiscard]] T read_little_endian(std::istream &in) {
+            unsigned char bytes[sizeof(T)];
+            if (!in.read(reinterpret_cast<char *>(bytes), sizeof(T))) throw runtime_error("Unexpected end of corpus");
+
+            T value = 0;
+            for (size_t i = 0; i < sizeof(T); ++i) value |= T(bytes[i]) << (i * 8);
+            return value;
+        }
+    }
+
+    LayoutCorpusHeader LayoutCorpusHeader::of(const GameConfiguration &configuration, const uint64_t &layout_count,
+                                              const uint64_t &seed) {
+        LayoutCorpusHeader header;
+        header.field_width = uint32_t(configuration.field_width);
+        header.field_height = uint32_t(configuration.field_height);
+        header.ships = configuration.ships;
+        header.layout_count = layout_count;
+        header.seed = seed;
+
+        return header;
+    }
+
+    bool LayoutCorpusHeader::matches(const GameConfiguration &configuration) const noexcept {
+        return field_width == configuration.field_width && field_height == configuration.field_height
+               && ships == configuration.ships;
+    }
+
+    void LayoutCorpusHeader::write_to(std::ostream &out) const {
+        out.write(MAGIC, sizeof(MAGIC));
+        write_little_endian(out, VERSION);
+        write_little_endian(out, field_width);
+        write_little_endian(out, field_height);
+        write_little_endian(out, uint32_t(ships.size()));
+        for (const auto &[length, count] : ships) {
+            write_little_endian(out, uint32_t(length));
+            write_little_endian(out, uint32_t(count));
+        }
+        write_little_endian(out, layout_count);
+        write_little_endian(out, seed);
+    }
+
+    LayoutCorpusHeader LayoutCorpusHeader::read_from(std::istream &in) {
+        char magic[sizeof(MAGIC)];
+        if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), MAGIC))
+            throw runtime_error("Not a layout corpus");
+        if (read_little_endian<uint32_t>(in) != VERSION) throw runtime_error("Unsupported layout corpus version");
+
+        LayoutCorpusHeader header;
+        header.field_width = read_little_endian<uint32_t>(in);
+        header.field_height = read_little_endian<uint32_t>(in);
+        const auto ship_lengths = read_little_endian<uint32_t>(in);
+        for (uint32_t i = 0; i < ship_lengths; ++i) {
+            const auto length = read_little_endian<uint32_t>(in), count = read_little_endian<uint32_t>(in);
+            if (length == 0 || count == 0 || !header.ships.emplace(length, count).second)
+                throw runtime_error("Malformed fleet of the layout corpus");
+        }
+        header.layout_count = read_little_endian<uint64_t>(in);
+        header.seed = read_little_endian<uint64_t>(in);
+
+        return header;
+    }
+
+    LayoutCorpusHeader LayoutCorpusHeader::read_from(std::istream &in, const GameConfiguration &configuration) {
+        auto header = read_from(in);
+        if (!header.matches(configuration))
+            throw runtime_error("Layout corpus was drawn for another field or fleet");
+
+        return header;
+    }
+
+    void pack_layout(const Bitboard &layout, uint8_t *const bytes) noexcept {
+        const auto width = layout.width(), height = layout.height();
+        std::fill(bytes, bytes + (width * height + 7) / 8, 0);
+        for (size_t y = 0; y < height; ++y) for (size_t x = 0; x < width; ++x) if (layout.test(x, y)) {
+            const auto bit = y * width + x;
+            bytes[bit / 8] |= uint8_t(1u << (bit % 8));
+        }
+    }
+
+    void unpack_layout(const uint8_t *const bytes, Bitboard &layout) noexcept {
+        const auto width = layout.width(), height = layout.height();
+        layout.clear();
+        for (size_t y = 0; y < height; ++y) for (size_t x = 0; x < width; ++x) {
+            const auto bit = y * width + x;
+            if ((bytes[bit / 8] >> (bit % 8)) & 1u) layout.set(x, y);
+        }
+    }
+}
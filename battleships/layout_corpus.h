@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+
+#include "bitboard.h"
+#include "game_configuration.h"
+
+using std::map;
+
+namespace battleships {
+
+    /**
+     * @brief Header of a binary file of fleet layouts.
+     *
+     * The file starts with the header whose fields are stored as little-endian integers after the magic,
+     * the fleet being stored as the number of the ship lengths followed by the length and the count of each,
+     * followed by {@code layout_count} layouts of {@code layout_size()} bytes each.
+     * A layout is the bit set of the ship cells in row-major order, the lowest bit of a byte being the first.
+     */
+    struct LayoutCorpusHeader {
+
+        constexpr static char MAGIC[8] = {'B', 'S', 'L', 'A', 'Y', 'O', 'U', 'T'};
+
+        constexpr static uint32_t VERSION = 2;
+
+        uint32_t field_width = 0, field_height = 0;
+
+        /**
+         * @brief Counts of the ships of the fleet the layouts were drawn for by their length
+         */
+        map<size_t, size_t> ships;
+
+        uint64_t layout_count = 0;
+
+        /**
+         * @brief Seed from which the layouts were generated
+         */
+        uint64_t seed = 0;
+
+        /**
+         * @brief Creates the header of the corpus of the layouts drawn for the configuration.
+         *
+         * @param configuration configuration whose field and fleet the layouts are drawn for
+         * @param layout_count number of the layouts
+         * @param seed seed from which the layouts are generated
+         * @return created header
+         */
+        [[nodiscard]] static LayoutCorpusHeader of(const GameConfiguration &configuration,
+                                                   const uint64_t &layout_count, const uint64_t &seed);
+
+        /**
+         * @brief Gets the size of the serialized header in bytes, the first layout following it.
+         */
+        [[nodiscard]] size_t size() const noexcept {
+            return sizeof(MAGIC) + 4 * 4 + 8 * 2 + 4 * 2 * ships.size();
+        }
+
+        [[nodiscard]] size_t layout_size() const noexcept {
+            return (size_t(field_width) * field_height + 7) / 8;
+        }
+
+        /**
+         * @brief Checks whether the layouts were drawn for the field and the fleet of the configuration.
+         *
+         * @param configuration configuration to check
+         * @return {@code true} if the field size and the ships match and {@code false} otherwise
+         */
+        [[nodiscard]] bool matches(const GameConfiguration &configuration) const noexcept;
+
+        /**
+         * @brief Writes the header to the stream.
+         *
+         * @param out stream to write to
+         */
+        void write_to(std::ostream &out) const;
+
+        /**
+         * @brief Reads the header from the stream.
+         *
+         * @param in stream to read from
+         * @return read header
+         * @throws runtime_error if the stream does not start with a valid header
+         */
+        [[nodiscard]] static LayoutCorpusHeader read_from(std::istream &in);
+
+        /**
+         * @brief Reads the header of the corpus which should have been drawn for the configuration.
+         *
+         * @param in stream to read from
+         * @param configuration configuration the layouts are expected to be drawn for
+         * @return read header
+         * @throws runtime_error if the stream does not start with a valid header
+         * or if the layouts were drawn for another field or fleet
+         */
+        [[nodiscard]] static LayoutCorpusHeader read_from(std::istream &in, const GameConfiguration &configuration);
+    };
+
+    /**
+     * @brief Packs the layout into its binary representation.
+     *
+     * @param layout layout to pack
+     * @param bytes buffer of {@link LayoutCorpusHeader#layout_size} bytes to write to
+     */
+    void pack_layout(const Bitboard &layout, uint8_t *bytes) noexcept;
+
+    /**
+     * @brief Unpacks the layout from its binary representation.
+     *
+     * @param bytes buffer of {@link LayoutCorpusHeader#layout_size} bytes to read from
+     * @param layout layout of the corpus field's dimensions to write to
+     */
+    void unpack_layout(const uint8_t *bytes, Bitboard &layout) noexcept;
+}
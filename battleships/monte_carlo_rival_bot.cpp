@@ -0,0 +1,452 @@
+#include "monte_carlo_rival_bot.h"
+
+#include <algorithm>
+#include <optional>
+#include <random>
+
+#include "instrumentation.h"
+#include "ship_placement.h"
+
+using std::optional;
+using std::runtime_error;
+using std::uniform_int_distribution;
+using std::chrono::steady_clock;
+
+namespace battleships {
+
+    namespace {
+
+        /**
+         * @brief Probability of anchoring a ship out of the preferred placements rather than out of all the consistent
+         * ones, the rest being kept so that the layouts not covering the damaged cells early are sampled too
+         */
+        constexpr double PREFERRED_PLACEMENT_PROBABILITY = 0.5;
+    }
+
+    MonteCarloRivalBot::MonteCarloRivalBot(GameField *const own_field, GameField *const rival_field,
+                                           const uint64_t &seed, const SamplingBudget &budget,
+                                           ThreadPool *const thread_pool)
+            : own_field_(own_field), rival_field_(rival_field), thread_pool_(thread_pool),
+              width_(rival_field->get_configuration().field_width),
+              height_(rival_field->get_configuration().field_height),
+              cell_count_(width_ * height_), valid_(Bitboard::full(width_, height_)),
+              random_(seed), budget_(budget), total_hits_(cell_count_) {
+        if (budget_.samples == 0 && budget_.time.count() <= 0) budget_.samples = 1;
+
+        // the ships are placed in the same order as the placement engine places them
+        const auto configuration = rival_field->get_configuration();
+        for (auto iterator = configuration.ships.rbegin(); iterator != configuration.ships.rend(); ++iterator)
+            for (size_t i = 0; i < iterator->second; ++i) {
+                fleet_.push_back(iterator->first);
+                remaining_of_length_.push_back(iterator->second - i);
+            }
+        length_bound_ = (configuration.ships.empty() ? 0 : configuration.ships.rbegin()->first) + 1;
+
+        scratches_.reserve(thread_pool_->size());
+        for (size_t i = 0; i < thread_pool_->size(); ++i) {
+            auto &scratch = scratches_.emplace_back(derive_seed(seed, i + 1));
+            for (auto *const bitboard : {&scratch.blocked, &scratch.free, &scratch.cells, &scratch.shifted,
+                                         &scratch.anchors, &scratch.plain_anchors[0], &scratch.plain_anchors[1]})
+                *bitboard = Bitboard(width_, height_);
+            scratch.hits.resize(cell_count_);
+        }
+    }
+
+    /*
+     * Sampling
+     */
+
+    void MonteCarloRivalBot::read_public_state() {
+        auto &cells = state_.cells;
+        cells.assign(cell_count_, UNKNOWN);
+        for (size_t y = 0; y < height_; ++y) for (size_t x = 0; x < width_; ++x) {
+            const Coordinate coordinate(static_cast<int>(x), static_cast<int>(y));
+            if (rival_field_->is_discovered(coordinate)) cells[index_of(coordinate)]
+                        = rival_field_->get_public_icon_at(coordinate) == '#' ? DAMAGED : EMPTY;
+        }
+
+        // group the damaged cells into ships starting from their top-left cells
+        state_.damaged_segments.clear();
+        state_.destroyed_ships.clear();
+        state_.destroyed_counts.assign(length_bound_, 0);
+        const auto is_known = [&](const Coordinate &coordinate) {
+            return !is_in_bounds(coordinate) || cells[index_of(coordinate)] != UNKNOWN;
+        };
+        const auto is_damaged = [&](const Coordinate &coordinate) {
+            return is_in_bounds(coordinate) && cells[index_of(coordinate)] == DAMAGED;
+        };
+        for (size_t y = 0; y < height_; ++y) for (size_t x = 0; x < width_; ++x) {
+            const Coordinate start(static_cast<int>(x), static_cast<int>(y));
+            if (!is_damaged(start) || is_damaged(start.move(LEFT, 1)) || is_damaged(start.move(DOWN, 1))) continue;
+
+            const auto horizontal = is_damaged(start.move(RIGHT, 1));
+            const auto direction = horizontal ? RIGHT : UP;
+            size_t length = 1;
+            while (is_damaged(start.move(direction, int(length)))) ++length;
+
+            // the ship is destroyed if it can't be continued in any direction
+            const auto destroyed = length == 1
+                    ? is_known(start.move(RIGHT, 1)) && is_known(start.move(LEFT, 1))
+                      && is_known(start.move(UP, 1)) && is_known(start.move(DOWN, 1))
+                    : is_known(start.move(direction, -1)) && is_known(start.move(direction, int(length)));
+
+            if (destroyed) {
+                for (size_t i = 0; i < length; ++i) cells[index_of(start.move(direction, int(i)))] = DESTROYED;
+                // single-celled ships are anchored as the horizontal ones
+                state_.destroyed_ships.push_back(encode(index_of(start), length, horizontal || length == 1));
+                if (length < length_bound_) ++state_.destroyed_counts[length];
+            } else state_.damaged_segments.push_back({start, length, horizontal});
+        }
+
+        state_.usable = Bitboard(width_, height_);
+        state_.plain = Bitboard(width_, height_);
+        for (size_t y = 0; y < height_; ++y) for (size_t x = 0; x < width_; ++x) {
+            const auto knowledge = cells[y * width_ + x];
+            if (knowledge != EMPTY) state_.usable.set(x, y);
+            if (knowledge == UNKNOWN) state_.plain.set(x, y);
+        }
+        state_.hit_count = 0;
+        for (size_t y = 0; y < height_; ++y) for (size_t x = 0; x < width_; ++x) {
+            const auto knowledge = cells[y * width_ + x];
+            if (knowledge != DAMAGED && knowledge != DESTROYED) continue;
+
+            ++state_.hit_count;
+            for (int deltaX = -1; deltaX <= 1; ++deltaX) for (int deltaY = -1; deltaY <= 1; ++deltaY) {
+                const Coordinate neighbour(int(x) + deltaX, int(y) + deltaY);
+                if (is_in_bounds(neighbour)) state_.plain.reset(state_.plain.index_of(neighbour));
+            }
+        }
+    }
+
+    MonteCarloRivalBot::PlacementKind MonteCarloRivalBot::classify(const size_t &start, const size_t &length,
+                                                                   const bool &horizontal) const {
+        // the ship's halo is the rectangle around it and no other ship may cover the hits in it
+        const auto x = start % width_, y = start / width_;
+        const auto last_x = horizontal ? x + length - 1 : x, last_y = horizontal ? y : y + length - 1;
+        size_t undiscovered = 0, damaged = 0, destroyed = 0;
+        for (auto halo_y = y == 0 ? y : y - 1; halo_y <= std::min(height_ - 1, last_y + 1); ++halo_y)
+            for (auto halo_x = x == 0 ? x : x - 1; halo_x <= std::min(width_ - 1, last_x + 1); ++halo_x) {
+                const auto knowledge = state_.cells[halo_y * width_ + halo_x];
+                const auto covered = x <= halo_x && halo_x <= last_x && y <= halo_y && halo_y <= last_y;
+                if (!covered) {
+                    if (knowledge == DAMAGED || knowledge == DESTROYED) return INCONSISTENT;
+                    continue;
+                }
+
+                switch (knowledge) {
+                    case UNKNOWN: ++undiscovered; break;
+                    case DAMAGED: ++damaged; break;
+                    case DESTROYED: ++destroyed; break;
+                    default: return INCONSISTENT;
+                }
+            }
+
+        if (destroyed != 0) {
+            const auto placement = encode(start, length, horizontal);
+            return destroyed == length && std::find(state_.destroyed_ships.begin(), state_.destroyed_ships.end(),
+                                                    placement) != state_.destroyed_ships.end()
+                   ? DESTROYING : INCONSISTENT;
+        }
+        // a ship all of whose cells are damaged would have been destroyed
+        if (undiscovered == 0) return INCONSISTENT;
+
+        return damaged == 0 ? UNDISCOVERED : DAMAGING;
+    }
+
+    bool MonteCarloRivalBot::sample_layout(SamplerScratch &scratch) const {
+        const auto stride = valid_.stride();
+        // anchors are the bits of the cells from which the ship's cells are all set in the bitboard
+        const auto find_anchors = [&](const Bitboard &cells, const size_t &length, const size_t &step,
+                                      Bitboard &anchors) {
+            anchors = cells;
+            scratch.shifted = cells;
+            for (size_t i = 1; i < length; ++i) {
+                scratch.shifted.shift_down(step);
+                anchors &= scratch.shifted;
+            }
+        };
+        const auto cell_of = [&](const size_t &bit) {
+            return bit / stride * width_ + bit % stride;
+        };
+
+        scratch.blocked.clear();
+        scratch.destroyed_left = state_.destroyed_counts;
+        scratch.placed.clear();
+
+        // the probability of the layout to be generated by the engine divided by that of it being sampled
+        double weight = 1;
+        size_t covered_hits = 0;
+        for (size_t ship = 0; ship < fleet_.size(); ++ship) {
+            const auto length = fleet_[ship];
+            // once the destroyed ships of this length are all of the ones left those can only be placed
+            const auto destroyed_only = scratch.destroyed_left[length] == remaining_of_length_[ship];
+
+            scratch.free = valid_;
+            scratch.free.subtract(scratch.blocked);
+            scratch.preferred.clear();
+            size_t anchor_count = 0, plain_counts[2] = {0, 0};
+            for (const auto vertical : {false, true}) {
+                // single-celled ships would be counted twice otherwise
+                if (length == 1 && vertical) break;
+
+                const auto step = vertical ? stride : size_t(1);
+                find_anchors(scratch.free, length, step, scratch.anchors);
+                anchor_count += scratch.anchors.count();
+
+                // the plain anchors are consistent while the ones near the hits need to be classified
+                scratch.cells = scratch.free;
+                scratch.cells &= state_.plain;
+                find_anchors(scratch.cells, length, step, scratch.plain_anchors[vertical]);
+                if (!destroyed_only) plain_counts[vertical] = scratch.plain_anchors[vertical].count();
+
+                scratch.cells = scratch.free;
+                scratch.cells &= state_.usable;
+                find_anchors(scratch.cells, length, step, scratch.anchors);
+                for (auto bit = scratch.anchors.find_next_without(scratch.plain_anchors[vertical], 0);
+                     bit != Bitboard::npos;
+                     bit = scratch.anchors.find_next_without(scratch.plain_anchors[vertical], bit + 1)) {
+                    const auto kind = classify(cell_of(bit), length, !vertical);
+                    if (kind == DESTROYING || (kind == DAMAGING && !destroyed_only))
+                        scratch.preferred.push_back(encode(cell_of(bit), length, !vertical));
+                }
+            }
+            const auto plain_count = plain_counts[0] + plain_counts[1], candidate_count
+                    = plain_count + scratch.preferred.size();
+            if (candidate_count == 0) return false;
+
+            // the preferred candidates are only chosen specially if there are other ones
+            const auto prefer = !scratch.preferred.empty() && plain_count != 0;
+            uint32_t chosen;
+            bool chosen_preferred = true;
+            if (prefer && std::uniform_real_distribution<double>()(scratch.random) < PREFERRED_PLACEMENT_PROBABILITY) {
+                chosen = scratch.preferred[uniform_int_distribution<size_t>(
+                        0, scratch.preferred.size() - 1
+                )(scratch.random)];
+            } else {
+                // the candidates are ordered as the plain horizontal, the plain vertical and the preferred ones
+                auto ordinal = uniform_int_distribution<size_t>(0, candidate_count - 1)(scratch.random);
+                chosen_preferred = ordinal >= plain_count;
+                if (ordinal < plain_counts[0]) chosen = encode(
+                        cell_of(scratch.plain_anchors[0].find_nth(ordinal)), length, true
+                );
+                else if ((ordinal -= plain_counts[0]) < plain_counts[1]) chosen = encode(
+                        cell_of(scratch.plain_anchors[1].find_nth(ordinal)), length, false
+                );
+                else chosen = scratch.preferred[ordinal - plain_counts[1]];
+            }
+            const auto probability = prefer
+                    ? (1 - PREFERRED_PLACEMENT_PROBABILITY) / double(candidate_count)
+                      + (chosen_preferred ? PREFERRED_PLACEMENT_PROBABILITY / double(scratch.preferred.size()) : 0)
+                    : 1 / double(candidate_count);
+            weight /= double(anchor_count) * probability;
+
+            const auto start = chosen / length_bound_ / 2;
+            const bool horizontal = (chosen / length_bound_) % 2;
+            const auto step = horizontal ? size_t(1) : width_;
+            for (size_t i = 0; i < length; ++i) {
+                const auto knowledge = state_.cells[start + i * step];
+                if (knowledge == DAMAGED || knowledge == DESTROYED) ++covered_hits;
+            }
+            if (state_.cells[start] == DESTROYED) --scratch.destroyed_left[length];
+
+            // the halo is the rectangle around the ship clipped by the field
+            const auto x = start % width_, y = start / width_;
+            const auto first_x = x == 0 ? x : x - 1, first_y = y == 0 ? y : y - 1;
+            const auto last_x = std::min(width_ - 1, horizontal ? x + length : x + 1),
+                    last_y = std::min(height_ - 1, horizontal ? y + 1 : y + length);
+            for (auto row = first_y; row <= last_y; ++row)
+                scratch.blocked.set_run(valid_.index_of(first_x, row), last_x - first_x + 1);
+            scratch.placed.push_back(chosen);
+        }
+        // each hit should be covered as no ship covers the hits around the other ones
+        if (covered_hits != state_.hit_count) return false;
+
+        for (const auto &placement : scratch.placed) {
+            const auto length = placement % length_bound_, start = placement / length_bound_ / 2;
+            const auto step = (placement / length_bound_) % 2 ? size_t(1) : width_;
+            for (size_t i = 0; i < length; ++i) {
+                const auto cell = start + i * step;
+                if (state_.cells[cell] == UNKNOWN) scratch.hits[cell] += weight;
+            }
+        }
+
+        return true;
+    }
+
+    void MonteCarloRivalBot::run_sampler(SamplerScratch &scratch, const size_t &sample_limit,
+                                         const steady_clock::time_point &deadline) const {
+        std::fill(scratch.hits.begin(), scratch.hits.end(), 0);
+        scratch.samples = 0;
+
+        // inconsistent states have no layouts at all so the number of failed attempts is limited
+        const auto attempt_limit = 64 * std::max<size_t>(sample_limit, 1024);
+        for (size_t attempt = 0; attempt < attempt_limit; ++attempt) {
+            if (sample_limit != 0 && scratch.samples >= sample_limit) break;
+            if (attempt % 16 == 0 && steady_clock::now() >= deadline) break;
+
+            if (sample_layout(scratch)) ++scratch.samples;
+        }
+    }
+
+    /*
+     * Bot logic
+     */
+
+    Coordinate MonteCarloRivalBot::choose_target() {
+        choose_targets(1, targets_);
+
+        return targets_.front();
+    }
+
+    void MonteCarloRivalBot::choose_targets(const size_t &count, vector<Coordinate> &targets) {
+        choose_targets(count, targets, steady_clock::time_point::max());
+    }
+
+    SearchEffort MonteCarloRivalBot::choose_targets(const size_t &count, vector<Coordinate> &targets,
+                                                    const steady_clock::time_point &deadline) {
+        read_public_state();
+
+        const auto sampling_deadline = budget_.time.count() > 0
+                ? std::min(deadline, steady_clock::now() + budget_.time) : deadline;
+        const auto task_count = scratches_.size();
+        // the samples are split statically so that the result does not depend on the scheduling
+        const auto sample_share = [&](const size_t &task) {
+            return budget_.samples / task_count + (task < budget_.samples % task_count ? 1 : 0);
+        };
+        const auto sample = [&](const size_t &task) {
+            const auto share = sample_share(task);
+            if (budget_.samples != 0 && share == 0) {
+                std::fill(scratches_[task].hits.begin(), scratches_[task].hits.end(), 0);
+                scratches_[task].samples = 0;
+            } else run_sampler(scratches_[task], share, sampling_deadline);
+        };
+        if (task_count == 1) sample(0);
+        else thread_pool_->run_batch(task_count, sample);
+
+        SearchEffort effort;
+        std::fill(total_hits_.begin(), total_hits_.end(), 0);
+        for (const auto &scratch : scratches_) {
+            effort.evaluations += scratch.samples;
+            for (size_t i = 0; i < cell_count_; ++i) total_hits_[i] += scratch.hits[i];
+        }
+        // the clock is only read if the sampling is limited by time
+        effort.interrupted = (budget_.samples == 0 || effort.evaluations < budget_.samples)
+                             && sampling_deadline != steady_clock::time_point::max()
+                             && steady_clock::now() >= sampling_deadline;
+
+        const auto damaged_ship_continuation = [&]() -> optional<size_t> {
+            for (const auto &segment : state_.damaged_segments) for (const auto &direction : ALL_DIRECTIONS) {
+                if (segment.length > 1 && segment.horizontal != is_horizontal_direction(direction)) continue;
+
+                // segments are described by their left or lower end
+                const auto coordinate = segment.start.move(
+                        direction, direction == RIGHT || direction == UP ? int(segment.length) : 1
+                );
+                if (is_in_bounds(coordinate) && state_.cells[index_of(coordinate)] == UNKNOWN)
+                    return index_of(coordinate);
+            }
+
+            return std::nullopt;
+        };
+
+        targets.clear();
+        while (targets.size() < count) {
+            auto chosen = cell_count_;
+            double best_hits = 0;
+            size_t ties = 0;
+            for (size_t i = 0; i < cell_count_; ++i) {
+                if (state_.cells[i] != UNKNOWN) continue;
+
+                const auto hits = total_hits_[i];
+                if (chosen == cell_count_ || hits > best_hits) {
+                    best_hits = hits;
+                    chosen = i;
+                    ties = 1;
+                } else if (hits == best_hits && uniform_int_distribution<size_t>(0, ties++)(random_) == 0) chosen = i;
+            }
+            if (chosen == cell_count_) {
+                if (targets.empty()) throw runtime_error("The game has no free spots");
+                break;
+            }
+
+            // no layout could be sampled so at least continue the damaged ship if there is one
+            if (best_hits == 0) chosen = damaged_ship_continuation().value_or(chosen);
+
+            targets.emplace_back(int(chosen % width_), int(chosen / width_));
+            // the public state is read anew by the next move so the chosen cell is simply excluded from it
+            state_.cells[chosen] = EMPTY;
+        }
+
+        return effort;
+    }
+
+    void MonteCarloRivalBot::place_ships() {
+        BATTLESHIPS_INSTRUMENT(BOT_PLACE_SHIPS);
+        place_ships_randomly(own_field_, random_);
+    }
+
+    bool MonteCarloRivalBot::act(AttackCallback *attack_callback) {
+        BATTLESHIPS_INSTRUMENT(BOT_ACT);
+        return play_turn(std::nullopt, attack_callback);
+    }
+
+    bool MonteCarloRivalBot::act_within(const std::chrono::microseconds &shot_budget,
+                                        AttackCallback *attack_callback) {
+        BATTLESHIPS_INSTRUMENT(BOT_ACT);
+        return play_turn(shot_budget, attack_callback);
+    }
+
+    bool MonteCarloRivalBot::play_turn(const optional<std::chrono::microseconds> &shot_budget,
+                                       AttackCallback *attack_callback) {
+        attack_callback = EmptyAttackCallback::or_empty(attack_callback);
+
+        while (true) {
+            const auto effort = choose_targets(1, targets_, shot_budget.has_value()
+                    ? steady_clock::now() + shot_budget.value() : steady_clock::time_point::max());
+            if (shot_budget.has_value()) attack_callback->on_search(effort);
+
+            const auto attacked_coordinate = targets_.front();
+            const auto attack_status = rival_field_->attack(attacked_coordinate);
+            attack_callback->on_attack(attacked_coordinate, attack_status);
+            switch (attack_status) {
+                case GameField::EMPTY_ALREADY_ATTACKED:
+                case GameField::SHIP_ALREADY_ATTACKED: throw runtime_error(
+                        "Cell was expected to not be visited"
+                );
+                case GameField::MISS: return false;
+                case GameField::WIN: return true;
+                default: break;
+            }
+        }
+    }
+
+    ShotStream MonteCarloRivalBot::shots() {
+        while (true) {
+            const auto attack_status = co_yield choose_target();
+            switch (attack_status) {
+                case GameField::EMPTY_ALREADY_ATTACKED:
+                case GameField::SHIP_ALREADY_ATTACKED: throw runtime_error(
+                        "Cell was expected to not be visited"
+                );
+                case GameField::WIN: co_return;
+                default: break;
+            }
+        }
+    }
+
+    bool MonteCarloRivalBot::act_salvo(const size_t &shots, AttackCallback *attack_callback) {
+        BATTLESHIPS_INSTRUMENT(BOT_ACT);
+        attack_callback = EmptyAttackCallback::or_empty(attack_callback);
+
+        choose_targets(std::min(shots, rival_field_->count_not_visited()), targets_);
+        salvo_statuses_.resize(targets_.size());
+        rival_field_->attack_batch(targets_, salvo_statuses_);
+        for (size_t i = 0; i < targets_.size(); ++i) {
+            attack_callback->on_attack(targets_[i], salvo_statuses_[i]);
+            // the shots following the winning one are not counted
+            if (salvo_statuses_[i] == GameField::WIN) return true;
+        }
+
+        return false;
+    }
+}
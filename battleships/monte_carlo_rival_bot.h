@@ -0,0 +1,314 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "bitboard.h"
+#include "coroutine_rival_bot.h"
+#include "rival_bot.h"
+#include "random_engine.h"
+#include "thread_pool.h"
+
+using std::optional;
+using std::vector;
+
+namespace battleships {
+
+    /**
+     * @brief Amount of sampling performed per move, sampling stops once any of the limits is reached
+     */
+    struct SamplingBudget {
+
+        /**
+         * @brief Number of layouts sampled per move, {@code 0} for no limit
+         */
+        size_t samples = 2000;
+
+        /**
+         * @brief Time spent sampling per move, {@code 0} for no limit
+         */
+        std::chrono::microseconds time = std::chrono::microseconds::zero();
+    };
+
+    /**
+     * @brief Bot sampling complete fleet layouts consistent with the public state of the rival's field
+     * and attacking the cell occupied in the most of them.
+     *
+     * Layouts are drawn as the placement engine draws the fleets, that is placing the ships from the largest
+     * with each one anchored uniformly out of its legal anchors, but each ship is only anchored
+     * out of the placements consistent with the public state and those covering the damaged cells are preferred.
+     * Every layout is then weighted by the ratio of its probability to be generated by the engine
+     * to the probability of it being sampled, so the weighted hits follow the actual posterior of the layouts.
+     */
+    class MonteCarloRivalBot : public RivalBot, public CoroutineRivalBot {
+
+    protected:
+
+        enum CellKnowledge : uint8_t {
+            UNKNOWN, EMPTY, DAMAGED, DESTROYED
+        };
+
+        /**
+         * @brief Damaged but not yet destroyed ship segment
+         */
+        struct DamagedSegment {
+            Coordinate start;
+            size_t length;
+            /**
+             * @brief Whether the orientation is horizontal, meaningful only for segments longer than one cell
+             */
+            bool horizontal;
+        };
+
+        /**
+         * @brief Consistency of a ship's placement with the public state
+         */
+        enum PlacementKind : uint8_t {
+            /**
+             * @brief Placement which no consistent layout contains
+             */
+            INCONSISTENT,
+            /**
+             * @brief Placement covering only the undiscovered cells
+             */
+            UNDISCOVERED,
+            /**
+             * @brief Placement covering some damaged cells along with the undiscovered ones
+             */
+            DAMAGING,
+            /**
+             * @brief Placement of a destroyed ship
+             */
+            DESTROYING
+        };
+
+        /**
+         * @brief Public state of the rival's field shared by all the samplers
+         */
+        struct PublicState {
+            vector<CellKnowledge> cells;
+            /**
+             * @brief Cells which may be covered by a ship, i.e. all but the discovered empty ones
+             */
+            Bitboard usable;
+            /**
+             * @brief Undiscovered cells which are not adjacent to any damaged or destroyed ones
+             * so that the ships covering only those are consistent with the public state
+             */
+            Bitboard plain;
+            vector<DamagedSegment> damaged_segments;
+            /**
+             * @brief Encoded placements of the destroyed ships
+             */
+            vector<uint32_t> destroyed_ships;
+            /**
+             * @brief Counts of the destroyed ships indexed by their length
+             */
+            vector<size_t> destroyed_counts;
+            /**
+             * @brief Number of the damaged and the destroyed cells
+             */
+            size_t hit_count;
+        };
+
+        /**
+         * @brief Buffers owned by a single sampling task
+         */
+        struct SamplerScratch {
+            RandomEngine random;
+            /**
+             * @brief Cells covered by the halos of the ships placed so far
+             */
+            Bitboard blocked;
+            Bitboard free, cells, shifted, anchors;
+            /**
+             * @brief Anchors of the current ship covering only the plain cells indexed by the ship's verticality
+             */
+            Bitboard plain_anchors[2];
+            vector<size_t> destroyed_left;
+            /**
+             * @brief Encoded placements of the ships of the current layout
+             */
+            vector<uint32_t> placed;
+            /**
+             * @brief Encoded consistent placements of the current ship covering some hits,
+             * those being preferred over the plain ones
+             */
+            vector<uint32_t> preferred;
+            /**
+             * @brief Total weight of the sampled layouts in which the cell is occupied by a ship
+             */
+            vector<double> hits;
+            size_t samples;
+
+            explicit SamplerScratch(const uint64_t &seed) : random(seed), samples(0) {}
+        };
+
+        // Uninitialized members
+
+        GameField *const own_field_, *const rival_field_;
+
+        ThreadPool *const thread_pool_;
+
+        const size_t width_, height_, cell_count_;
+
+        /**
+         * @brief Bitboard with all the cells of the rival's field set
+         */
+        Bitboard valid_;
+
+        /**
+         * @brief Lengths of the rival's ships in the order of their placement (i.e. the largest first)
+         */
+        vector<size_t> fleet_;
+
+        /**
+         * @brief Numbers of the ships of the same length placed starting from each ship of the fleet
+         */
+        vector<size_t> remaining_of_length_;
+
+        /**
+         * @brief Bound of the ship lengths used to encode the placements
+         */
+        size_t length_bound_;
+
+        // Initialized members
+
+        RandomEngine random_;
+
+        SamplingBudget budget_;
+
+        PublicState state_;
+
+        vector<SamplerScratch> scratches_;
+
+        vector<double> total_hits_;
+
+        /**
+         * @brief Buffers of the targets of the current move and the results of the salvo
+         */
+        vector<Coordinate> targets_;
+        vector<GameField::AttackStatus> salvo_statuses_;
+
+        [[nodiscard]] inline size_t index_of(const Coordinate &coordinate) const noexcept {
+            return coordinate.y * width_ + coordinate.x;
+        }
+
+        [[nodiscard]] inline bool is_in_bounds(const Coordinate &coordinate) const noexcept {
+            return 0 <= coordinate.x && coordinate.x < width_ && 0 <= coordinate.y && coordinate.y < height_;
+        }
+
+        /**
+         * @brief Reads the public state of the rival's field into {@code state_}.
+         */
+        void read_public_state();
+
+        [[nodiscard]] inline uint32_t encode(const size_t &start, const size_t &length,
+                                             const bool &horizontal) const noexcept {
+            return uint32_t((start * 2 + horizontal) * length_bound_ + length);
+        }
+
+        /**
+         * @brief Checks whether the not blocked placement may be a part of a layout consistent with the public state,
+         * that is whether it covers no discovered empty cells, covers either a whole destroyed ship
+         * or some undiscovered cells and has no damaged or destroyed cells around it.
+         * The plain placements are all consistent so this is only needed for the other ones.
+         *
+         * @param start index of the ship's left or lower cell
+         * @param length length of the ship
+         * @param horizontal whether the ship is horizontal
+         * @return kind of the placement
+         */
+        [[nodiscard]] PlacementKind classify(const size_t &start, const size_t &length, const bool &horizontal) const;
+
+        /**
+         * @brief Samples a single layout consistent with the public state adding its weight to the hits of its cells.
+         *
+         * @return {@code true} if the layout has been sampled and {@code false} if the attempt has failed
+         */
+        bool sample_layout(SamplerScratch &scratch) const;
+
+        /**
+         * @brief Runs the sampler until its share of the budget is spent.
+         */
+        void run_sampler(SamplerScratch &scratch, const size_t &sample_limit,
+                         const std::chrono::steady_clock::time_point &deadline) const;
+
+        /**
+         * @brief Chooses the targets as {@link #choose_targets} does sampling until the budget is spent
+         * or the deadline is reached, whichever comes first.
+         *
+         * @param count number of the coordinates to choose
+         * @param targets vector to store the chosen coordinates in
+         * @param deadline time by which the sampling should stop
+         * @return search performed to choose the targets
+         */
+        SearchEffort choose_targets(const size_t &count, vector<Coordinate> &targets,
+                                    const std::chrono::steady_clock::time_point &deadline);
+
+        /**
+         * @brief Makes a turn reporting the search for each shot if it is limited by the budget.
+         *
+         * @param shot_budget time in which each shot should be chosen or an empty optional for no limit
+         * @param attack_callback callback notified on the searches and the shots
+         * @return {@code true} if the bot has won
+         */
+        bool play_turn(const optional<std::chrono::microseconds> &shot_budget, AttackCallback *attack_callback);
+
+    public:
+
+        /**
+         * @brief Creates a new bot.
+         *
+         * @param own_field field of this bot
+         * @param rival_field field of the rival attacked by this bot
+         * @param seed seed of this bot's random engines
+         * @param budget sampling budget used per move
+         * @param thread_pool pool on which the sampling is performed
+         */
+        explicit MonteCarloRivalBot(GameField *own_field, GameField *rival_field,
+                                    const uint64_t &seed = random_seed(),
+                                    const SamplingBudget &budget = SamplingBudget(),
+                                    ThreadPool *thread_pool = &ThreadPool::shared());
+
+        [[nodiscard]] const SamplingBudget &budget() const noexcept {
+            return budget_;
+        }
+
+        void set_budget(const SamplingBudget &budget) noexcept {
+            budget_ = budget;
+        }
+
+        /**
+         * @brief Chooses the coordinate to be attacked next by sampling the layouts.
+         *
+         * @return coordinate to attack
+         */
+        Coordinate choose_target();
+
+        /**
+         * @brief Chooses the distinct coordinates to be attacked next by sampling the layouts once,
+         * the ones occupied in the most of them come first.
+         *
+         * @param count number of the coordinates to choose, fewer are chosen if fewer cells are undiscovered
+         * @param targets vector to store the chosen coordinates in
+         */
+        void choose_targets(const size_t &count, vector<Coordinate> &targets);
+
+        void place_ships() override;
+
+        bool act(AttackCallback *attack_callback) override;
+
+        bool act_salvo(const size_t &shots, AttackCallback *attack_callback) override;
+
+        /**
+         * @brief Makes a turn sampling for each shot until the sampling budget or the shot's time budget is spent.
+         * The samples gathered by then choose the shot, those being the evaluations reported for it.
+         */
+        bool act_within(const std::chrono::microseconds &shot_budget, AttackCallback *attack_callback) override;
+
+        [[nodiscard]] ShotStream shots() override;
+    };
+}
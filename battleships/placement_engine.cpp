@@ -0,0 +1,99 @@
+#include "placement_engine.h"
+
+#include <algorithm>
+#include <random>
+
+using std::runtime_error;
+using std::uniform_int_distribution;
+
+namespace battleships {
+
+    namespace {
+
+        /**
+         * @brief Number of attempts to generate a fleet before giving up,
+         * an attempt fails only if some ship has no legal placement left
+         */
+        constexpr size_t FLEET_ATTEMPTS = 1024;
+    }
+
+    PlacementEngine::PlacementEngine(const GameConfiguration &configuration)
+            : configuration_(configuration),
+              valid_(Bitboard::full(configuration.field_width, configuration.field_height)) {
+        for (auto iterator = configuration.ships.rbegin(); iterator != configuration.ships.rend(); ++iterator)
+            fleet_.insert(fleet_.end(), iterator->second, iterator->first);
+    }
+
+    void PlacementEngine::block_halo(Bitboard &blocked, const size_t &size, const bool &vertical,
+                                     const size_t &anchor) const {
+        const auto width = valid_.width(), height = valid_.height(), stride = valid_.stride();
+        const auto x = anchor % stride, y = anchor / stride;
+
+        // the rectangle of the halo spans a cell more at each side unless it meets the edge of the field
+        const auto first_x = x == 0 ? x : x - 1, first_y = y == 0 ? y : y - 1;
+        const auto last_x = std::min(width - 1, x + (vertical ? 1 : size)),
+                last_y = std::min(height - 1, y + (vertical ? size : 1));
+
+        for (auto row = first_y; row <= last_y; ++row)
+            blocked.set_run(valid_.index_of(first_x, row), last_x - first_x + 1);
+    }
+
+    void PlacementEngine::generate(RandomEngine &random, vector<ShipPlacement> &placements) const {
+        const auto width = valid_.width(), height = valid_.height(), stride = valid_.stride();
+        Bitboard blocked(width, height), free(width, height), shifted(width, height),
+                horizontal(width, height), vertical(width, height);
+
+        for (size_t attempt = 0; attempt < FLEET_ATTEMPTS; ++attempt) {
+            blocked.clear();
+            placements.clear();
+
+            for (const auto &size : fleet_) {
+                free = valid_;
+                free.subtract(blocked);
+
+                // the anchor is legal if all the cells from it are free, guard bits stop horizontal ships at the edge
+                horizontal = free;
+                shifted = free;
+                for (size_t i = 1; i < size; ++i) {
+                    shifted.shift_down(1);
+                    horizontal &= shifted;
+                }
+                // single-celled ships would be counted twice otherwise
+                if (size == 1) vertical.clear();
+                else {
+                    vertical = free;
+                    shifted = free;
+                    for (size_t i = 1; i < size; ++i) {
+                        shifted.shift_down(stride);
+                        vertical &= shifted;
+                    }
+                }
+
+                const auto horizontal_count = horizontal.count(), total_count = horizontal_count + vertical.count();
+                if (total_count == 0) break;
+
+                const auto chosen = uniform_int_distribution<size_t>(0, total_count - 1)(random);
+                const auto is_vertical = chosen >= horizontal_count;
+                const auto anchor = is_vertical
+                        ? vertical.find_nth(chosen - horizontal_count) : horizontal.find_nth(chosen);
+
+                placements.push_back({valid_.coordinate_of(anchor), is_vertical ? UP : RIGHT, size});
+                block_halo(blocked, size, is_vertical, anchor);
+            }
+
+            if (placements.size() == fleet_.size()) return;
+        }
+
+        throw runtime_error("Unable to place the fleet at the field");
+    }
+
+    void PlacementEngine::place_ships(GameField *const field, RandomEngine &random) const {
+        vector<ShipPlacement> placements;
+        placements.reserve(fleet_.size());
+        generate(random, placements);
+
+        for (const auto &placement : placements)
+            if (!field->try_emplace_ship(placement.coordinate, placement.direction, placement.size))
+                throw runtime_error("The field refused the generated ship placement");
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bitboard.h"
+#include "game_configuration.h"
+#include "game_field.h"
+#include "random_engine.h"
+
+using std::vector;
+
+namespace battleships {
+
+    /**
+     * @brief Position of a single ship of a fleet
+     */
+    struct ShipPlacement {
+
+        /**
+         * @brief Left or lower cell of the ship
+         */
+        Coordinate coordinate;
+
+        /**
+         * @brief Direction in which the ship continues from its coordinate, either {@code RIGHT} or {@code UP}
+         */
+        Direction direction;
+
+        size_t size;
+    };
+
+    /**
+     * @brief Random fleet generator for a game configuration working on the bitboards of its field.
+     *
+     * Legal anchors of a ship are found for the whole field at once by intersecting the shifted masks
+     * of the free cells, after which one of them is chosen uniformly and its halo gets blocked.
+     * Engines are immutable once created and thus may be shared between threads. Those take memory proportional
+     * to the area of the field and the callers placing many fleets should keep the engine they need.
+     */
+    class PlacementEngine {
+
+        GameConfiguration configuration_;
+
+        Bitboard valid_;
+
+        /**
+         * @brief Lengths of all the ships of the fleet in the order of placement (i.e. the largest first)
+         */
+        vector<size_t> fleet_;
+
+        /**
+         * @brief Blocks the halo (the ship itself with the adjacent cells) of the placement.
+         * The halo of a straight ship is the rectangle around it clipped by the field
+         * so it is blocked row by row without any per-placement masks.
+         *
+         * @param blocked bitboard of the blocked cells
+         * @param size size of the ship
+         * @param vertical whether the ship is vertical
+         * @param anchor bit index of the ship's left or lower cell
+         */
+        void block_halo(Bitboard &blocked, const size_t &size, const bool &vertical, const size_t &anchor) const;
+
+    public:
+
+        /**
+         * @brief Creates a new placement engine taking memory proportional to the area of the field.
+         *
+         * @param configuration configuration of the game whose fleets are generated
+         */
+        explicit PlacementEngine(const GameConfiguration &configuration);
+
+        [[nodiscard]] const GameConfiguration &configuration() const noexcept {
+            return configuration_;
+        }
+
+        /**
+         * @brief Checks whether the fleets generated by this engine fit the configuration.
+         *
+         * @param configuration configuration to check
+         * @return {@code true} if the configuration has the same field size and ships and {@code false} otherwise
+         */
+        [[nodiscard]] bool has_configuration(const GameConfiguration &configuration) const noexcept {
+            return configuration_.field_width == configuration.field_width
+                   && configuration_.field_height == configuration.field_height
+                   && configuration_.ships == configuration.ships;
+        }
+
+        /**
+         * @brief Generates a random fleet layout.
+         *
+         * @param random random engine used to pick the positions
+         * @param placements vector to which the placements of the ships get written
+         * @throws runtime_error if no layout could be generated
+         */
+        void generate(RandomEngine &random, vector<ShipPlacement> &placements) const;
+
+        /**
+         * @brief Places a randomly generated fleet at the field.
+         *
+         * @param field field without ships at which the fleet should be placed
+         * @param random random engine used to pick the positions
+         * @throws runtime_error if no layout could be generated or the field refuses some ship
+         */
+        void place_ships(GameField *field, RandomEngine &random) const;
+    };
+}
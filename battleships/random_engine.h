@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+using std::random_device;
+
+namespace battleships {
+
+    /**
+     * @brief Mixes the given value using SplitMix64 finalizer.
+     *
+     * @param value value to be mixed
+     * @return mixed value
+     */
+    constexpr uint64_t mix_seed(uint64_t value) noexcept {
+        value += 0x9E3779B97F4A7C15u;
+        value = (value ^ (value >> 30u)) * 0xBF58476D1CE4E5B9u;
+        value = (value ^ (value >> 27u)) * 0x94D049BB133111EBu;
+        return value ^ (value >> 31u);
+    }
+
+    /**
+     * @brief Derives an independent seed for the given stream from the base seed.
+     * This is used to get per-game and per-bot seeds from a single seed of the simulation.
+     *
+     * @param seed base seed
+     * @param stream identifier of the stream
+     * @return seed of the stream
+     */
+    constexpr uint64_t derive_seed(const uint64_t &seed, const uint64_t &stream) noexcept {
+        return mix_seed(seed ^ mix_seed(stream));
+    }
+
+    /**
+     * @brief Creates a non-deterministic seed. This is the only place where {@code random_device} gets used.
+     *
+     * @return random seed
+     */
+    inline uint64_t random_seed() {
+        random_device random;
+        return (uint64_t(random()) << 32u) ^ uint64_t(random());
+    }
+
+    /**
+     * @brief xoshiro256** pseudo-random generator by David Blackman and Sebastiano Vigna.
+     * It satisfies <i>UniformRandomBitGenerator</i> so it can be used with all the standard distributions.
+     */
+    class Xoshiro256StarStar {
+
+        uint64_t state_[4]{};
+
+        [[nodiscard]] constexpr static uint64_t rotate_left(const uint64_t &value, const int &shift) noexcept {
+            return (value << shift) | (value >> (64 - shift));
+        }
+
+    public:
+
+        using result_type = uint64_t;
+
+        constexpr explicit Xoshiro256StarStar(const uint64_t &seed) noexcept {
+            this->seed(seed);
+        }
+
+        constexpr void seed(uint64_t seed) noexcept {
+            // state is filled by SplitMix64 as recommended by the authors so that it is never all zeroes
+            for (auto &word : state_) word = mix_seed(seed += 0x9E3779B97F4A7C15u);
+        }
+
+        [[nodiscard]] constexpr static result_type min() noexcept {
+            return std::numeric_limits<result_type>::min();
+        }
+
+        [[nodiscard]] constexpr static result_type max() noexcept {
+            return std::numeric_limits<result_type>::max();
+        }
+
+        constexpr result_type operator()() noexcept {
+            const auto result = rotate_left(state_[1] * 5, 7) * 9;
+            const auto shifted = state_[1] << 17u;
+
+            state_[2] ^= state_[0];
+            state_[3] ^= state_[1];
+            state_[1] ^= state_[2];
+            state_[0] ^= state_[3];
+
+            state_[2] ^= shifted;
+            state_[3] = rotate_left(state_[3], 45);
+
+            return result;
+        }
+    };
+
+    /**
+     * @brief Random engine used by the bots and the placement code
+     */
+    using RandomEngine = Xoshiro256StarStar;
+}
@@ -1,9 +1,29 @@
 #pragma once
 
+#include <chrono>
+
 #include "game_field.h"
 
 namespace battleships {
 
+    /**
+     * @brief Search performed by a bot to choose a single shot
+     */
+    struct SearchEffort {
+
+        /**
+         * @brief Amount of the search in the units of the bot: the layouts sampled by the Monte Carlo bot,
+         * the ship lengths whose placements have been weighed by the density bot and {@code 0} for the bots
+         * which do not search at all
+         */
+        size_t evaluations = 0;
+
+        /**
+         * @brief Whether the search has been cut short by the deadline and the best shot found by then is fired
+         */
+        bool interrupted = false;
+    };
+
     /**
      * @brief Bot responsible for playing against the player
      */
@@ -18,6 +38,13 @@ namespace battleships {
 
         public:
             virtual void on_attack(const Coordinate &coordinate, const GameField::AttackStatus &attack_status) = 0;
+
+            /**
+             * @brief Called by {@link RivalBot#act_within} once the next shot is chosen and before it is fired.
+             *
+             * @param effort search performed to choose the shot
+             */
+            virtual void on_search(const SearchEffort &) {}
         };
 
         /**
@@ -42,9 +69,51 @@ namespace battleships {
             void on_attack(const Coordinate &coordinate, const GameField::AttackStatus &attack_status) override {};
         };
 
+        /**
+         * @brief Attack callback reporting an empty search before each attack forwarded to the wrapped callback,
+         * used by the bots choosing their shots without any search.
+         */
+        class UnsearchedAttackCallback : public AttackCallback {
+
+            AttackCallback *const attack_callback_;
+
+        public:
+
+            explicit UnsearchedAttackCallback(AttackCallback *const attack_callback)
+                    : attack_callback_(EmptyAttackCallback::or_empty(attack_callback)) {}
+
+            void on_attack(const Coordinate &coordinate, const GameField::AttackStatus &attack_status) override {
+                attack_callback_->on_search(SearchEffort());
+                attack_callback_->on_attack(coordinate, attack_status);
+            }
+        };
+
+        virtual ~RivalBot() = default;
+
         virtual void place_ships() = 0;
 
         virtual bool act(AttackCallback *attack_callback) = 0;
+
+        /**
+         * @brief Fires a salvo of shots all of which are aimed before any of them is resolved.
+         * Unlike in the classic turns hitting a ship does not give the bot another shot.
+         *
+         * @param shots number of shots in the salvo, fewer are fired if fewer cells are left undiscovered
+         * @param attack_callback callback notified on the shots in the order they are resolved
+         * @return {@code true} if the bot has won
+         */
+        virtual bool act_salvo(const size_t &shots, AttackCallback *attack_callback) = 0;
+
+        /**
+         * @brief Makes a turn choosing each shot within the time budget. The search for a shot stops
+         * once its budget is spent and the best shot found by then is fired, so the bot gets weaker
+         * instead of slower as the budget shrinks.
+         *
+         * @param shot_budget time in which each shot should be chosen
+         * @param attack_callback callback notified on the search performed before each shot and on the shot itself
+         * @return {@code true} if the bot has won
+         */
+        virtual bool act_within(const std::chrono::microseconds &shot_budget, AttackCallback *attack_callback) = 0;
     };
 }
 
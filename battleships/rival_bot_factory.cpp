@@ -0,0 +1,32 @@
+#include "rival_bot_factory.h"
+
+#include "density_rival_bot.h"
+#include "monte_carlo_rival_bot.h"
+#include "simple_rival_bot.h"
+
+namespace battleships {
+
+    const vector<string> &rival_bot_names() {
+        static const vector<string> NAMES{"simple", "density", "monte-carlo"};
+        return NAMES;
+    }
+
+    unique_ptr<RivalBot> create_rival_bot(const string &name, GameField *const own_field, GameField *const rival_field,
+                                          const uint64_t &seed) {
+        if (name == "simple") return std::make_unique<SimpleRivalBot>(own_field, rival_field, seed);
+        if (name == "density") return std::make_unique<DensityRivalBot>(own_field, rival_field, seed);
+        if (name == "monte-carlo") return std::make_unique<MonteCarloRivalBot>(own_field, rival_field, seed);
+
+        return nullptr;
+    }
+
+    unique_ptr<CoroutineRivalBot> create_coroutine_rival_bot(const string &name, GameField *const own_field,
+                                                             GameField *const rival_field, const uint64_t &seed) {
+        // all of the bots yield their shots natively
+        if (name == "simple") return std::make_unique<SimpleRivalBot>(own_field, rival_field, seed);
+        if (name == "density") return std::make_unique<DensityRivalBot>(own_field, rival_field, seed);
+        if (name == "monte-carlo") return std::make_unique<MonteCarloRivalBot>(own_field, rival_field, seed);
+
+        return nullptr;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "coroutine_rival_bot.h"
+#include "rival_bot.h"
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace battleships {
+
+    /**
+     * @brief Gets the names of all the bot kinds which can be created by {@link #create_rival_bot}.
+     *
+     * @return names of the available bot kinds
+     */
+    [[nodiscard]] const vector<string> &rival_bot_names();
+
+    /**
+     * @brief Creates a bot of the given kind.
+     *
+     * @param name name of the bot kind
+     * @param own_field field of the created bot
+     * @param rival_field field of the rival attacked by the created bot
+     * @param seed seed of the created bot's random engine
+     * @return created bot or an empty pointer if there is no bot kind with the given name
+     */
+    [[nodiscard]] unique_ptr<RivalBot> create_rival_bot(const string &name,
+                                                        GameField *own_field, GameField *rival_field,
+                                                        const uint64_t &seed);
+
+    /**
+     * @brief Creates a coroutine bot of the given kind playing the same shots as the bot created by
+     * {@link #create_rival_bot} with the same arguments.
+     *
+     * @param name name of the bot kind
+     * @param own_field field of the created bot
+     * @param rival_field field of the rival attacked by the created bot
+     * @param seed seed of the created bot's random engine
+     * @return created bot or an empty pointer if there is no bot kind with the given name
+     */
+    [[nodiscard]] unique_ptr<CoroutineRivalBot> create_coroutine_rival_bot(const string &name,
+                                                                          GameField *own_field, GameField *rival_field,
+                                                                          const uint64_t &seed);
+}
@@ -0,0 +1,48 @@
+#include "self_play.h"
+
+#include <stdexcept>
+
+using std::runtime_error;
+
+namespace battleships {
+
+    namespace {
+
+        /**
+         * @brief Attack callback counting the shots performed and forwarding them to the observer
+         */
+        class CountingAttackCallback : public RivalBot::AttackCallback {
+
+            RivalBot::AttackCallback *const observer_;
+
+        public:
+            size_t shots = 0;
+
+            explicit CountingAttackCallback(RivalBot::AttackCallback *const observer)
+                    : observer_(RivalBot::EmptyAttackCallback::or_empty(observer)) {}
+
+            void on_attack(const Coordinate &coordinate, const GameField::AttackStatus &attack_status) override {
+                ++shots;
+                observer_->on_attack(coordinate, attack_status);
+            }
+        };
+    }
+
+    SelfPlayResult play_bots_against_each_other(RivalBot &first, RivalBot &second, const size_t &turn_limit,
+                                                RivalBot::AttackCallback *const first_observer,
+                                                RivalBot::AttackCallback *const second_observer,
+                                                const size_t &salvo_shots) {
+        CountingAttackCallback first_callback(first_observer), second_callback(second_observer);
+        const auto act = [&](RivalBot &bot, CountingAttackCallback &callback) {
+            return salvo_shots == 0 ? bot.act(&callback) : bot.act_salvo(salvo_shots, &callback);
+        };
+
+        for (size_t turn = 0; turn < turn_limit; ++turn) {
+            if (turn % 2 == 0) {
+                if (act(first, first_callback)) return {true, first_callback.shots, second_callback.shots};
+            } else if (act(second, second_callback)) return {false, first_callback.shots, second_callback.shots};
+        }
+
+        throw runtime_error("Game has not finished in " + std::to_string(turn_limit) + " turns");
+    }
+}
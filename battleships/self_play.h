@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+#include "rival_bot.h"
+
+namespace battleships {
+
+    /**
+     * @brief Result of a game played by two bots against each other
+     */
+    struct SelfPlayResult {
+
+        /**
+         * @brief {@code true} if the first bot has won the game and {@code false} if the second one has
+         */
+        bool first_won;
+
+        /**
+         * @brief Number of shots performed by the first bot
+         */
+        size_t first_shots;
+
+        /**
+         * @brief Number of shots performed by the second bot
+         */
+        size_t second_shots;
+
+        [[nodiscard]] size_t winner_shots() const noexcept {
+            return first_won ? first_shots : second_shots;
+        }
+    };
+
+    /**
+     * @brief Plays a game between the two bots whose ships are expected to be already placed.
+     * The first bot makes the first turn.
+     *
+     * @param first bot playing first
+     * @param second bot playing second
+     * @param turn_limit maximal number of turns after which the game is considered broken
+     * @param first_observer optional callback notified on attacks of the first bot
+     * @param second_observer optional callback notified on attacks of the second bot
+     * @param salvo_shots number of shots fired per turn in the salvo mode or {@code 0} for the classic turns
+     * @return result of the game
+     */
+    SelfPlayResult play_bots_against_each_other(RivalBot &first, RivalBot &second, const size_t &turn_limit,
+                                                RivalBot::AttackCallback *first_observer = nullptr,
+                                                RivalBot::AttackCallback *second_observer = nullptr,
+                                                const size_t &salvo_shots = 0);
+}
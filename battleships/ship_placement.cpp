@@ -0,0 +1,50 @@
+#include "ship_placement.h"
+
+#include "placement_engine.h"
+
+#include <optional>
+#include <random>
+#include <string>
+
+using std::bernoulli_distribution;
+using std::optional;
+using std::runtime_error;
+using std::to_string;
+using std::uniform_int_distribution;
+
+namespace battleships {
+
+    void place_ship_randomly(GameField *const field, const size_t &ship_size, RandomEngine &random) {
+        const auto width = field->get_configuration().field_width,
+                height = field->get_configuration().field_height;
+
+        auto original_coordinate = Coordinate(
+                int(uniform_int_distribution<size_t>(0, width - 1)(random)),
+                int(uniform_int_distribution<size_t>(0, height - 1)(random))
+        );
+        field->locate_not_visited_spot(original_coordinate, random_direction(random), bernoulli_distribution()(random));
+
+        auto direction = random_direction(random);
+        for (int deltaX = 0; deltaX < width; ++deltaX) for (int deltaY = 0; deltaY < height; ++deltaY) {
+            const auto tested_coordinate = Coordinate(
+                    (original_coordinate.x + deltaX) % int(width), (original_coordinate.y + deltaY) % int(height)
+            );
+            for (int i = 0; i < 4; ++i) {
+                if (field->try_emplace_ship(tested_coordinate, direction, ship_size)) return;
+                direction = rotate_direction_counter_clockwise(direction);
+            }
+        }
+
+        throw runtime_error("Unable to place " + to_string(ship_size) + "-celled ship at the field");
+    }
+
+    void place_ships_randomly(GameField *const field, RandomEngine &random) {
+        // a single engine is kept per thread so that the placements need neither locks nor a registry
+        // of all the configurations ever seen, it gets replaced once another configuration is placed
+        thread_local optional<PlacementEngine> engine;
+
+        const auto &configuration = field->get_configuration();
+        if (!engine || !engine->has_configuration(configuration)) engine.emplace(configuration);
+        engine->place_ships(field, random);
+    }
+}
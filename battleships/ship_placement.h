@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+#include "game_field.h"
+#include "random_engine.h"
+
+namespace battleships {
+
+    /**
+     * @brief Places a ship of the given size at a random position of the field.
+     *
+     * @param field field at which the ship should be placed
+     * @param ship_size size of the placed ship
+     * @param random random engine used to pick the position
+     * @throws runtime_error if there is no position at which the ship can be placed
+     */
+    void place_ship_randomly(GameField *field, const size_t &ship_size, RandomEngine &random);
+
+    /**
+     * @brief Places all the ships of the field's configuration at random positions
+     * using the {@link PlacementEngine} of the configuration cached by the calling thread.
+     *
+     * @param field field without ships at which the ships should be placed
+     * @param random random engine used to pick the positions
+     * @throws runtime_error if some ship cannot be placed
+     */
+    void place_ships_randomly(GameField *field, RandomEngine &random);
+}
@@ -3,7 +3,6 @@
 #include <random>
 #include <stdexcept>
 
-using std::random_device;
 using std::bernoulli_distribution;
 using std::invalid_argument;
 using std::runtime_error;
@@ -24,7 +23,8 @@ namespace battleships {
         }
     }
 
-    inline static ShipPosition random_ship_position(random_device &random) {
+    template<typename R>
+    inline static ShipPosition random_ship_position(R &random) {
         return ship_position_bool_distribution(random) ? VERTICAL : HORIZONTAL;
     }
 }
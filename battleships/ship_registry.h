@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "coordinate.h"
+#include "direction.h"
+
+using std::vector;
+
+namespace battleships {
+
+    /**
+     * @brief Ship placed at a field
+     */
+    struct RegisteredShip {
+
+        /**
+         * @brief Coordinate of the ship's first cell
+         */
+        Coordinate coordinate;
+
+        /**
+         * @brief Direction in which the ship's cells follow its first one
+         */
+        Direction direction;
+
+        size_t size;
+
+        /**
+         * @brief Number of the ship's cells which have been hit
+         */
+        size_t hits = 0;
+
+        [[nodiscard]] inline bool is_sunk() const noexcept {
+            return hits == size;
+        }
+
+        /**
+         * @brief Gets the coordinate of the ship's cell.
+         *
+         * @param index index of the cell starting from the first one
+         * @return coordinate of the cell
+         */
+        [[nodiscard]] inline Coordinate cell(const size_t &index) const noexcept {
+            return coordinate.move(direction, static_cast<int>(index));
+        }
+    };
+
+    /**
+     * @brief Registry of the ships placed at a field so that each of its ship cells may refer to its ship by an id.
+     */
+    class ShipRegistry {
+
+        vector<RegisteredShip> ships_;
+
+    public:
+
+        /**
+         * @brief Type of the ids of the ships, small enough to be stored per cell
+         */
+        using Id = uint32_t;
+
+        /**
+         * @brief Id which is not given to any ship
+         */
+        constexpr static Id NO_SHIP = Id(-1);
+
+        /**
+         * @brief Registers the new ship.
+         *
+         * @param coordinate coordinate of the ship's first cell
+         * @param direction direction in which the ship's cells follow its first one
+         * @param size number of the ship's cells
+         * @return id of the registered ship
+         */
+        inline Id add(const Coordinate &coordinate, const Direction &direction, const size_t &size) {
+            ships_.push_back({coordinate, direction, size});
+
+            return Id(ships_.size() - 1);
+        }
+
+        /**
+         * @brief Counts a hit of the ship.
+         *
+         * @param id id of the hit ship
+         * @return {@code true} if the ship got sunk by this hit and {@code false} otherwise
+         */
+        inline bool hit(const Id &id) noexcept {
+            auto &ship = ships_[id];
+
+            return ++ship.hits == ship.size;
+        }
+
+        /**
+         * @brief Undoes a hit of the ship.
+         *
+         * @param id id of the ship whose hit is undone
+         */
+        inline void unhit(const Id &id) noexcept {
+            --ships_[id].hits;
+        }
+
+        [[nodiscard]] inline const RegisteredShip &operator[](const Id &id) const noexcept {
+            return ships_[id];
+        }
+
+        [[nodiscard]] inline size_t size() const noexcept {
+            return ships_.size();
+        }
+
+        [[nodiscard]] inline vector<RegisteredShip>::const_iterator begin() const noexcept {
+            return ships_.begin();
+        }
+
+        [[nodiscard]] inline vector<RegisteredShip>::const_iterator end() const noexcept {
+            return ships_.end();
+        }
+
+        inline void clear() noexcept {
+            ships_.clear();
+        }
+    };
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "coordinate.h"
+#include "game_field.h"
+
+using std::optional;
+using std::runtime_error;
+
+namespace battleships {
+
+    /**
+     * @brief Coroutine producing the shots of a bot one by one.
+     *
+     * Each shot is a suspension point at which the bot yields the coordinate it aims at
+     * and which is resumed with the result of the shot, that is {@code const auto status = co_yield coordinate;}.
+     * The shots are resolved by the caller so the bot never blocks on its rival and any number of the bots
+     * may be interleaved on a single thread. The coroutine ends once the bot has won.
+     */
+    class ShotStream {
+
+    public:
+
+        class promise_type {
+
+            friend class ShotStream;
+
+            /**
+             * @brief Coordinate of the shot the bot is suspended at
+             */
+            optional<Coordinate> target_;
+
+            /**
+             * @brief Result of the shot with which the bot gets resumed
+             */
+            GameField::AttackStatus status_ = GameField::MISS;
+
+            std::exception_ptr exception_;
+
+            /**
+             * @brief Awaiter suspending the bot at its shot until the result of the shot is known
+             */
+            struct ShotAwaiter {
+
+                promise_type &promise;
+
+                [[nodiscard]] bool await_ready() const noexcept {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<promise_type>) const noexcept {}
+
+                [[nodiscard]] GameField::AttackStatus await_resume() const noexcept {
+                    return promise.status_;
+                }
+            };
+
+        public:
+
+            [[nodiscard]] ShotStream get_return_object() noexcept {
+                return ShotStream(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            // the bot does not run until its first shot is requested
+            [[nodiscard]] std::suspend_always initial_suspend() const noexcept {
+                return {};
+            }
+
+            [[nodiscard]] std::suspend_always final_suspend() const noexcept {
+                return {};
+            }
+
+            [[nodiscard]] ShotAwaiter yield_value(const Coordinate &coordinate) noexcept {
+                target_ = coordinate;
+                return ShotAwaiter{*this};
+            }
+
+            void return_void() noexcept {
+                target_.reset();
+            }
+
+            void unhandled_exception() noexcept {
+                target_.reset();
+                exception_ = std::current_exception();
+            }
+        };
+
+    private:
+
+        std::coroutine_handle<promise_type> handle_;
+
+        bool started_ = false;
+
+        explicit ShotStream(const std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+        /**
+         * @brief Runs the bot until its next shot or its end rethrowing the exception thrown by it if any.
+         */
+        void run() {
+            started_ = true;
+            handle_.resume();
+            if (handle_.promise().exception_) std::rethrow_exception(std::exchange(handle_.promise().exception_, {}));
+        }
+
+        void start_if_needed() {
+            if (!started_) run();
+        }
+
+    public:
+
+        ShotStream(ShotStream &&other) noexcept
+                : handle_(std::exchange(other.handle_, {})), started_(other.started_) {}
+
+        ShotStream &operator=(ShotStream &&other) noexcept {
+            if (this != &other) {
+                if (handle_) handle_.destroy();
+                handle_ = std::exchange(other.handle_, {});
+                started_ = other.started_;
+            }
+
+            return *this;
+        }
+
+        ShotStream(const ShotStream &) = delete;
+
+        ShotStream &operator=(const ShotStream &) = delete;
+
+        ~ShotStream() {
+            if (handle_) handle_.destroy();
+        }
+
+        /**
+         * @brief Checks whether the bot has no shots left, starting it if it has not yet been started.
+         *
+         * @return {@code true} if the bot has ended and {@code false} if it is suspended at a shot
+         */
+        [[nodiscard]] bool done() {
+            start_if_needed();
+
+            return handle_.done();
+        }
+
+        /**
+         * @brief Gets the coordinate of the shot the bot is suspended at, starting it if it has not yet been started.
+         *
+         * @return coordinate aimed at by the bot
+         * @throws runtime_error if the bot has no shots left
+         */
+        [[nodiscard]] Coordinate target() {
+            start_if_needed();
+            if (handle_.done()) throw runtime_error("Bot has no shots left");
+
+            return *handle_.promise().target_;
+        }
+
+        /**
+         * @brief Resumes the bot with the result of its current shot and runs it until its next shot or its end.
+         *
+         * @param status result of the shot
+         * @throws runtime_error if the bot has no shots left
+         */
+        void resolve(const GameField::AttackStatus &status) {
+            start_if_needed();
+            if (handle_.done()) throw runtime_error("Bot has no shots left");
+
+            handle_.promise().status_ = status;
+            run();
+        }
+    };
+}
@@ -1,19 +1,40 @@
 #pragma once
 
+#include <stdexcept>
+
 #include "game.h"
+#include "game_field_factory.h"
 #include "simple_game_field.h"
 
+using std::invalid_argument;
+
 namespace battleships {
     class SimpleGame : public Game {
 
         const GameConfiguration configuration_;
         GameField *field_1_, *field_2_;
 
+        [[nodiscard]] static const GameConfiguration &validated(const GameConfiguration &configuration) {
+            if (!configuration.are_ships_valid())
+                throw invalid_argument("Ships of the configuration cannot be placed at its field");
+
+            return configuration;
+        }
+
     public:
 
-        explicit SimpleGame(const GameConfiguration &configuration) :
-                configuration_(configuration),
-                field_1_(new SimpleGameField(configuration)), field_2_(new SimpleGameField(configuration)) {}
+        /**
+         * @brief Creates a new game.
+         *
+         * @param configuration configuration of the game
+         * @param field_factory factory used to create both fields of the game
+         * @throws invalid_argument if the ships of the configuration cannot be placed at its field
+         */
+        explicit SimpleGame(const GameConfiguration &configuration,
+                            const GameFieldFactory *const field_factory
+                            = TypedGameFieldFactory<SimpleGameField>::instance()) :
+                configuration_(validated(configuration)),
+                field_1_(field_factory->create(configuration)), field_2_(field_factory->create(configuration)) {}
 
         ~SimpleGame() override {
             delete field_1_;
@@ -32,41 +53,45 @@ namespace battleships {
             return field_2_;
         }
 
-        void print_to_console() const noexcept override {
+        /**
+         * @brief Resets both fields of the game so that it may be played again.
+         */
+        void reset() noexcept {
+            field_1_->reset();
+            field_2_->reset();
+        }
+
+        void draw_to(ConsoleFrame &frame) const override {
             const auto width = configuration_.field_width, height = configuration_.field_height;
+            string icons_1, icons_2;
+            field_1_->get_public_icons(icons_1);
+            field_2_->get_public_icons(icons_2);
+
+            string line;
             // draw upper border
             {
-                cout << ' ';
-                auto letter = 'A';
-                for (size_t i = 0; i < width * 2 + 1; i++) cout << (i % 2 == 0 ? '|' : letter++);
-            }
-            cout << "   ";
-            {
-                cout << ' ';
+                string border(" ");
                 auto letter = 'A';
-                for (size_t i = 0; i < width * 2 + 1; i++) cout << (i % 2 == 0 ? '|' : letter++);
+                for (size_t i = 0; i < width * 2 + 1; i++) border += i % 2 == 0 ? '|' : letter++;
+                line = border + "   " + border;
             }
-            cout << "\n";
+            frame.write(0, 0, line);
 
-            {
-                auto number = 0;
-                for (size_t y = 0; y < height; y++) {
-                    cout << number << '|';
-                    for (size_t x = 0; x < width; x++)cout
-                            << field_1_->get_public_icon_at(Coordinate(x, y)) << '|';
-                    cout << "   " << number++ << '|';
-                    for (size_t x = 0; x < width; x++) cout
-                            << field_2_->get_public_icon_at(Coordinate(x, y)) << '|';
-                    cout << "\n";
-                }
+            for (size_t y = 0; y < height; y++) {
+                const auto number = std::to_string(y);
+                line = number + '|';
+                for (size_t x = 0; x < width; x++) (line += icons_1[y * width + x]) += '|';
+                line += "   " + number + '|';
+                for (size_t x = 0; x < width; x++) (line += icons_2[y * width + x]) += '|';
+                frame.write(0, y + 1, line);
             }
 
             // draw lower border
-            cout << ' ';
-            for (size_t i = 0; i < width * 2 + 1; i++) cout << "¯";
-            cout << "    ";
-            for (size_t i = 0; i < width * 2 + 1; i++) cout << "¯";
-            cout << endl;
+            line = ' ';
+            for (size_t i = 0; i < width * 2 + 1; i++) line += "¯";
+            line += "    ";
+            for (size_t i = 0; i < width * 2 + 1; i++) line += "¯";
+            frame.write(0, height + 1, line);
         }
     };
 }
@@ -1,6 +1,7 @@
 #include "simple_game_field.h"
 
 #include "container_util.h"
+#include "instrumentation.h"
 #include <tuple>
 #include <set>
 
@@ -17,22 +18,8 @@ namespace battleships {
      */
 
     SimpleGameField::SimpleGameField(const GameConfiguration &configuration)
-            : configuration_(configuration), cells_(new GameFieldCell **[configuration_.field_width]) {
-        for (size_t x = 0; x < configuration_.field_width; x++) {
-            const auto column = cells_[x] = new GameFieldCell *[configuration.field_height];
-
-            for (size_t y = 0; y < configuration.field_height; y++) column[y] = new EmptyGameFieldCell;
-        }
-    }
-
-    SimpleGameField::~SimpleGameField() {
-        for (size_t x = 0; x < configuration_.field_width; x++) {
-            const auto line = cells_[x];
-            for (size_t y = 0; y < configuration_.field_height; y++) delete line[y];
-            delete[] line;
-        }
-        delete[] cells_;
-    }
+            : configuration_(configuration), cells_(configuration.field_width * configuration.field_height),
+              not_visited_(configuration.field_width, configuration.field_height) {}
 
     /*
      * Data access
@@ -48,8 +35,11 @@ namespace battleships {
 
     void SimpleGameField::try_make_discovered(const Coordinate &coordinate) {
         if (is_in_bounds(coordinate)) {
-            const auto cell = get_cell_at(coordinate);
-            if (cell->is_empty()) cell->discover();
+            auto &cell = get_current_cell_at(coordinate);
+            if (cell.is_empty() && !cell.discovered) {
+                cell.discovered = true;
+                journal_.record_discovery(coordinate, not_visited_.remove(coordinate));
+            }
         }
     }
 
@@ -64,48 +54,15 @@ namespace battleships {
     bool SimpleGameField::attempt_destroy_ship(const Coordinate &coordinate) {
         const auto cell = get_cell_at(coordinate);
 
-        if (cell->is_empty()) throw runtime_error("Attempt to destroy a cell not being a ship");
-
-        const auto ship_cell = (ShipGameFieldCell *) cell;
+        if (cell.is_empty()) throw runtime_error("Attempt to destroy a cell not being a ship");
 
-        const auto position = ship_cell->get_position();
-        if (position == NONE) {
-            surround_destroyed_ship_cell(coordinate); // simply destroy the current point as it is a small ship
-            return true;
-        }
-
-        // map of other cells which correspond to this ship
-        map<Coordinate, GameFieldCell *> destroyed_cells;
-        {
-            size_t ship_cells_left = ship_cell->get_ship_size() - 1;
-            auto direction = position == VERTICAL ? UP : RIGHT;
-            for (size_t i = 0; i < 2; i++) { // go in both directions
-                if (ship_cells_left == 0) break; // there is no need to test for any other ship cells
-                auto tested_coordinate = coordinate;
-                while (true) {
-                    tested_coordinate.move(direction, 1); // mark the current cell as the one destroyed
-                    if (!is_in_bounds(tested_coordinate)) break; // border reached
-
-                    const auto tested_cell = get_cell_at(tested_coordinate);
-                    if (tested_cell->is_empty()) break; // end of ship reached
-                    if (tested_cell->is_discovered()) {
-                        destroyed_cells.insert(pair<Coordinate, GameFieldCell *>(tested_coordinate, tested_cell));
-                        if (--ship_cells_left == 0) break; // there is no need to test for any other ship cells
-                    } else return false; // the ship is not yet fully destroyed
-                }
-
-                direction = invert_direction(direction);
-            }
-        }
+        const auto ship_id = cell.ship_id;
+        journal_.record_hit(ship_id);
+        if (!ships_.hit(ship_id)) return false; // the ship is not yet fully destroyed
 
-        // destroy the attacked cell of the ship
-        ship_cell->discover();
-        surround_destroyed_ship_cell(coordinate);
-        // destroy each other cells of this ship
-        for (const auto &destroyed_cell : destroyed_cells) {
-            destroyed_cell.second->discover();
-            surround_destroyed_ship_cell(destroyed_cell.first);
-        }
+        // all the cells of the ship have already been discovered by the attacks
+        const auto &ship = ships_[ship_id];
+        for (size_t i = 0; i < ship.size; ++i) surround_destroyed_ship_cell(ship.cell(i));
 
         return true;
     }
@@ -116,14 +73,16 @@ namespace battleships {
 
 
     GameField::AttackStatus SimpleGameField::attack(const Coordinate &coordinate) {
+        BATTLESHIPS_INSTRUMENT(FIELD_ATTACK);
         check_bounds(coordinate);
 
-        const auto cell = get_cell_at(coordinate);
+        auto &cell = get_current_cell_at(coordinate);
 
-        if (cell->is_discovered()) return cell->is_empty() ? EMPTY_ALREADY_ATTACKED : SHIP_ALREADY_ATTACKED;
-        cell->discover();
+        if (cell.discovered) return cell.is_empty() ? EMPTY_ALREADY_ATTACKED : SHIP_ALREADY_ATTACKED;
+        cell.discovered = true;
+        journal_.record_discovery(coordinate, not_visited_.remove(coordinate));
 
-        if (cell->is_empty()) return MISS;
+        if (cell.is_empty()) return MISS;
 
         --ship_cells_alive_;
 
@@ -133,23 +92,25 @@ namespace battleships {
     bool SimpleGameField::is_discovered(const Coordinate &coordinate) const {
         check_bounds(coordinate);
 
-        return get_cell_at(coordinate)->is_discovered();
+        return get_cell_at(coordinate).discovered;
     }
 
     bool SimpleGameField::can_be_attacked(const Coordinate &coordinate) const {
-        return !is_out_of_bounds(coordinate) && !get_cell_at(coordinate)->is_discovered();
+        return !is_out_of_bounds(coordinate) && !get_cell_at(coordinate).discovered;
     }
 
     bool SimpleGameField::try_emplace_ship(const Coordinate &base_coordinate,
                                            const Direction &direction, const size_t &size) {
+        BATTLESHIPS_INSTRUMENT(FIELD_TRY_EMPLACE_SHIP);
 
         check_bounds(base_coordinate);
+        journal_.check_not_recording();
         // check if the ship firs according to the borders
 
         if (!can_place_at(base_coordinate)) return false;
 
         if (size == 1) {
-            set_cell_at(base_coordinate, new ShipGameFieldCell(size, NONE));
+            get_current_cell_at(base_coordinate).ship_id = ships_.add(base_coordinate, direction, size);
             ++ship_cells_alive_;
 
             return true;
@@ -166,10 +127,8 @@ namespace battleships {
         }
 
         // to start from
-        for (size_t i = 0; i < size; ++i)
-            set_cell_at(base_coordinate.move(direction, i), new ShipGameFieldCell(
-                    size, is_vertical_direction(direction) ? VERTICAL : HORIZONTAL
-            ));
+        const auto ship_id = ships_.add(base_coordinate, direction, size);
+        for (size_t i = 0; i < size; ++i) get_current_cell_at(base_coordinate.move(direction, i)).ship_id = ship_id;
         ship_cells_alive_ += size;
 
         return true;
@@ -179,41 +138,44 @@ namespace battleships {
      * Misc
      */
 
-    void SimpleGameField::print_to_console() const noexcept {
+    void SimpleGameField::draw_to(ConsoleFrame &frame) const {
         const auto width = configuration_.field_width, height = configuration_.field_height;
+        string line;
         // draw upper border
         {
-            cout << ' ';
+            line = ' ';
             auto letter = 'A';
-            for (size_t i = 0; i < width * 2 + 1; i++) cout << (i % 2 == 0 ? '|' : letter++);
+            for (size_t i = 0; i < width * 2 + 1; i++) line += i % 2 == 0 ? '|' : letter++;
         }
-        cout << "\n";
+        frame.write(0, 0, line);
 
-        {
-            auto number = 0;
-            for (size_t y = 0; y < height; y++) {
-                cout << number++ << '|';
-                for (size_t x = 0; x < width; x++) {
-                    cout << cells_[x][y]->private_icon() << '|';
-                }
-                cout << "\n";
-            }
+        for (size_t y = 0; y < height; y++) {
+            line = to_string(y) + '|';
+            for (size_t x = 0; x < width; x++) (line += get_cell_at(Coordinate(x, y)).private_icon()) += '|';
+            frame.write(0, y + 1, line);
         }
 
         // draw lower border
-        cout << ' ';
-        for (size_t i = 0; i < width * 2 + 1; i++) cout << "¯";
-        cout << endl;
+        line = ' ';
+        for (size_t i = 0; i < width * 2 + 1; i++) line += "¯";
+        frame.write(0, height + 1, line);
     }
 
     char SimpleGameField::get_public_icon_at(const Coordinate &coordinate) const {
         check_bounds(coordinate);
 
-        return get_cell_at(coordinate)->public_icon();
+        return get_cell_at(coordinate).public_icon();
+    }
+
+    void SimpleGameField::get_public_icons(string &icons) const {
+        icons.resize(configuration_.field_width * configuration_.field_height);
+        for (size_t y = 0; y < configuration_.field_height; y++) for (size_t x = 0; x < configuration_.field_width; x++)
+            icons[y * configuration_.field_width + x] = get_cell_at(Coordinate(x, y)).public_icon();
     }
 
     void SimpleGameField::locate_not_visited_spot(Coordinate &coordinate, Direction direction,
                                                   const bool &clockwise) const {
+        BATTLESHIPS_INSTRUMENT(FIELD_LOCATE_NOT_VISITED_SPOT);
         if (is_discovered(coordinate)) {
             size_t step_count = 0;
 
@@ -254,20 +216,37 @@ namespace battleships {
     }
 
     void SimpleGameField::reset() noexcept {
-        for (size_t x = 0; x < configuration_.field_width; x++) for (size_t y = 0;
-                y < configuration_.field_width; y++) set_cell_at(
-                        Coordinate(x, y), new EmptyGameFieldCell
-        );
+        if (++generation_ == 0) {
+            // the generations have wrapped around so the cells of the old ones have to be outdated explicitly
+            for (auto &cell : cells_) cell.generation = 0;
+            generation_ = 1;
+        }
+        ships_.clear();
+        not_visited_.reset();
+        ship_cells_alive_ = 0;
+        journal_.clear();
+    }
+
+    void SimpleGameField::push_checkpoint() {
+        journal_.push_checkpoint(ship_cells_alive_);
+    }
+
+    void SimpleGameField::rollback() {
+        ship_cells_alive_ = journal_.rollback(ships_, [this](const Coordinate &coordinate, const uint32_t &position) {
+            get_current_cell_at(coordinate).discovered = false;
+            not_visited_.restore(coordinate, position);
+        });
     }
 
     bool SimpleGameField::can_place_near(const Coordinate &coordinate) const {
-        return is_out_of_bounds(coordinate) || get_cell_at(coordinate)->is_empty();
+        return is_out_of_bounds(coordinate) || get_cell_at(coordinate).is_empty();
     }
 
     bool SimpleGameField::can_place_at(const Coordinate &coordinate) const {
+        BATTLESHIPS_INSTRUMENT(FIELD_CAN_PLACE_AT);
         check_bounds(coordinate);
 
-        if (!get_cell_at(coordinate)->is_empty()) return false;
+        if (!get_cell_at(coordinate).is_empty()) return false;
 
         // check each side
         for (const auto &tested_direction : ALL_DIRECTIONS) {
@@ -282,4 +261,12 @@ namespace battleships {
 
         return true;
     }
+
+    size_t SimpleGameField::count_not_visited() const noexcept {
+        return not_visited_.size();
+    }
+
+    Coordinate SimpleGameField::random_not_visited_spot(RandomEngine &random) const {
+        return not_visited_.random(random);
+    }
 }
\ No newline at end of file
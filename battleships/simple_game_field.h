@@ -1,27 +1,83 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "game_field.h"
 #include "game_configuration.h"
+#include "attack_journal.h"
 #include "coordinate.h"
-#include "game_field_cell.h"
+#include "free_cell_index.h"
+#include "ship_registry.h"
 
 using std::string;
 using std::to_string;
+using std::vector;
 
 namespace battleships {
 
+    /**
+     * @brief Game field storing its cells in a flat row-major array.
+     *
+     * Each cell is stamped with the generation in which it was last written and the cells of the older generations
+     * are treated as empty and not discovered ones, so that the cells are reset in constant time
+     * and the field allocates nothing once its ship registry has grown to the size of the fleet.
+     */
     class SimpleGameField : public GameField {
 
     protected:
 
+        struct Cell {
+            /**
+             * @brief Generation in which the cell was written
+             */
+            uint32_t generation = 0;
+            /**
+             * @brief Id of the ship occupying the cell or {@code ShipRegistry::NO_SHIP} if the cell is empty
+             */
+            ShipRegistry::Id ship_id = ShipRegistry::NO_SHIP;
+            bool discovered = false;
+
+            [[nodiscard]] inline bool is_empty() const noexcept {
+                return ship_id == ShipRegistry::NO_SHIP;
+            }
+
+            [[nodiscard]] inline char private_icon() const noexcept {
+                return is_empty() ? '~' : '#';
+            }
+
+            [[nodiscard]] inline char public_icon() const noexcept {
+                return discovered ? private_icon() : '.';
+            }
+        };
+
         const GameConfiguration configuration_;
 
-        GameFieldCell ***cells_;
+        /**
+         * @brief Cells of the field by their numbers (i.e. {@code y * width + x})
+         */
+        vector<Cell> cells_;
+
+        /**
+         * @brief Current generation of the cells which is never {@code 0} so that the initial cells are all outdated
+         */
+        uint32_t generation_ = 1;
+
+        /**
+         * @brief Ships placed at the field referred to by their cells
+         */
+        ShipRegistry ships_;
+
+        /**
+         * @brief Cells which have not been discovered yet
+         */
+        FreeCellIndex not_visited_;
 
         size_t ship_cells_alive_ = 0;
 
+        AttackJournal journal_;
+
         inline void check_bounds(const Coordinate &coordinate) const noexcept(false) {
             if (is_out_of_bounds(coordinate))
                 throw out_of_range(
@@ -30,14 +86,27 @@ namespace battleships {
                 );
         }
 
-        [[nodiscard]] inline GameFieldCell *get_cell_at(const Coordinate &coordinate) const {
-            return cells_[coordinate.x][coordinate.y];
+        /**
+         * @brief Gets the cell at the given point reading an outdated one as empty and not discovered.
+         *
+         * @param coordinate coordinate of the cell in the bounds of the field
+         * @return current state of the cell
+         */
+        [[nodiscard]] inline Cell get_cell_at(const Coordinate &coordinate) const noexcept {
+            const auto &cell = cells_[coordinate.y * configuration_.field_width + coordinate.x];
+            return cell.generation == generation_ ? cell : Cell{generation_};
         }
 
-        inline void set_cell_at(const Coordinate &coordinate, GameFieldCell *const value) {
-            auto &cell = cells_[coordinate.x][coordinate.y];
-            delete cell;
-            cell = value;
+        /**
+         * @brief Gets the cell at the given point for modification making it empty and not discovered if it is outdated.
+         *
+         * @param coordinate coordinate of the cell in the bounds of the field
+         * @return cell of the current generation
+         */
+        [[nodiscard]] inline Cell &get_current_cell_at(const Coordinate &coordinate) noexcept {
+            auto &cell = cells_[coordinate.y * configuration_.field_width + coordinate.x];
+            if (cell.generation != generation_) cell = Cell{generation_};
+            return cell;
         }
 
         inline void try_make_discovered(const Coordinate &coordinate);
@@ -45,7 +114,7 @@ namespace battleships {
         inline void surround_destroyed_ship_cell(const Coordinate &coordinate);
 
         /**
-         * @brief Attempts to destroy the ship by attacking the given point.
+         * @brief Counts the hit of the ship cell at the given point destroying the ship if it has no cells left.
          * @param coordinate coordinate of the point attacked
          * @return {@code true} if the ship was fully destroyed by the attack and {@code false} otherwise
          */
@@ -59,8 +128,6 @@ namespace battleships {
 
         explicit SimpleGameField(const GameConfiguration &configuration);
 
-        ~SimpleGameField() override;
-
         /*
          * Data access
          */
@@ -86,10 +153,12 @@ namespace battleships {
          * Misc
          */
 
-        void print_to_console() const noexcept override;
+        void draw_to(ConsoleFrame &frame) const override;
 
         [[nodiscard]] char get_public_icon_at(const Coordinate &coordinate) const override;
 
+        void get_public_icons(string &icons) const override;
+
         [[nodiscard]] inline bool is_in_bounds(const Coordinate &coordinate) const noexcept override {
             return (0 <= coordinate.x && coordinate.x < configuration_.field_width)
                    && (0 <= coordinate.y && coordinate.y < configuration_.field_height);
@@ -102,8 +171,24 @@ namespace battleships {
 
         void reset() noexcept override;
 
+        void push_checkpoint() override;
+
+        void rollback() override;
+
         [[nodiscard]] bool can_place_at(const Coordinate &coordinate) const override;
 
         void locate_not_visited_spot(Coordinate &coordinate, Direction direction, const bool &clockwise) const override;
+
+        [[nodiscard]] size_t count_not_visited() const noexcept override;
+
+        [[nodiscard]] Coordinate random_not_visited_spot(RandomEngine &random) const override;
+
+        [[nodiscard]] const ShipRegistry &get_ships() const noexcept override {
+            return ships_;
+        }
+
+        [[nodiscard]] GameField *clone() const override {
+            return new SimpleGameField(*this);
+        }
     };
 }
@@ -0,0 +1,43 @@
+#include "simple_game_pool.h"
+
+namespace battleships {
+
+    void SimpleGamePool::Return::operator()(SimpleGame *const game) const noexcept {
+        unique_ptr<SimpleGame> owned(game);
+        if (pool_ == nullptr) return;
+
+        std::lock_guard<mutex> lock(pool_->guard_);
+        try {
+            pool_->idle_games_.push_back(std::move(owned));
+        } catch (const std::bad_alloc &) {
+            // the game is simply destroyed if it cannot be kept
+        }
+    }
+
+    SimpleGamePool::SimpleGamePool(const GameConfiguration &configuration, const GameFieldFactory *const field_factory)
+            : configuration_(configuration), field_factory_(field_factory) {
+        if (!configuration.are_ships_valid())
+            throw invalid_argument("Ships of the configuration cannot be placed at its field");
+    }
+
+    SimpleGamePool::Lease SimpleGamePool::acquire() {
+        unique_ptr<SimpleGame> game;
+        {
+            std::lock_guard<mutex> lock(guard_);
+            if (!idle_games_.empty()) {
+                game = std::move(idle_games_.back());
+                idle_games_.pop_back();
+            }
+        }
+
+        if (game) game->reset();
+        else game = std::make_unique<SimpleGame>(configuration_, field_factory_);
+
+        return Lease(game.release(), Return(this));
+    }
+
+    size_t SimpleGamePool::idle_count() {
+        std::lock_guard<mutex> lock(guard_);
+        return idle_games_.size();
+    }
+}
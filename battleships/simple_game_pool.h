@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "game_configuration.h"
+#include "game_field_factory.h"
+#include "simple_game.h"
+#include "simple_game_field.h"
+
+using std::mutex;
+using std::unique_ptr;
+using std::vector;
+
+namespace battleships {
+
+    /**
+     * @brief Pool of the games of a single configuration which are reused by the games played one after another
+     * so that the memory of their fields is only allocated once per concurrently played game.
+     *
+     * The pool may be shared by multiple threads and must outlive all of the games leased from it.
+     */
+    class SimpleGamePool {
+
+        /**
+         * @brief Deleter of the leased games returning those to the pool
+         */
+        class Return {
+
+            SimpleGamePool *pool_ = nullptr;
+
+        public:
+
+            Return() = default;
+
+            explicit Return(SimpleGamePool *const pool) noexcept : pool_(pool) {}
+
+            void operator()(SimpleGame *game) const noexcept;
+        };
+
+        const GameConfiguration configuration_;
+
+        const GameFieldFactory *const field_factory_;
+
+        mutex guard_;
+
+        /**
+         * @brief Games returned to the pool and not leased again yet
+         */
+        vector<unique_ptr<SimpleGame>> idle_games_;
+
+    public:
+
+        /**
+         * @brief Game leased from the pool which is returned to it once released
+         */
+        using Lease = unique_ptr<SimpleGame, Return>;
+
+        /**
+         * @brief Creates an empty pool.
+         *
+         * @param configuration configuration of the pooled games
+         * @param field_factory factory used to create the fields of the pooled games
+         * @throws invalid_argument if the ships of the configuration cannot be placed at its field
+         */
+        explicit SimpleGamePool(const GameConfiguration &configuration,
+                                const GameFieldFactory *field_factory
+                                = TypedGameFieldFactory<SimpleGameField>::instance());
+
+        SimpleGamePool(const SimpleGamePool &) = delete;
+
+        SimpleGamePool &operator=(const SimpleGamePool &) = delete;
+
+        /**
+         * @brief Leases a game reusing one returned to the pool if there is any.
+         *
+         * @return game whose both fields are empty
+         */
+        [[nodiscard]] Lease acquire();
+
+        /**
+         * @brief Gets the number of the games returned to the pool and not leased again yet.
+         *
+         * @return number of the idle games
+         */
+        [[nodiscard]] size_t idle_count();
+    };
+}
@@ -1,49 +1,196 @@
 #include "simple_rival_bot.h"
 
-#include "container_util.h"
+#include <algorithm>
+#include <cstdlib>
+
 #include "game_field.h"
+#include "instrumentation.h"
+#include "ship_placement.h"
 
 using std::invalid_argument;
 using std::runtime_error;
 using std::to_string;
-using common_util::not_contains;
-using common_util::get_random;
 
 namespace battleships {
 
-    void SimpleRivalBot::place_ship_randomly(const size_t &ship_size) {
-        auto original_coordinate = random_own_coordinate();
-        locate_not_visited_spot(original_coordinate, own_field_);
+    void SimpleRivalBot::place_ships() {
+        BATTLESHIPS_INSTRUMENT(BOT_PLACE_SHIPS);
+        place_ships_randomly(own_field_, random_);
+    }
+
+    bool SimpleRivalBot::act(AttackCallback *attack_callback) {
+        BATTLESHIPS_INSTRUMENT(BOT_ACT);
+        return attacked_ship_coordinate_.has_value()
+               ? continue_attack(EmptyAttackCallback::or_empty(attack_callback))
+               : random_attack(EmptyAttackCallback::or_empty(attack_callback));
+    }
+
+    bool SimpleRivalBot::act_within(const std::chrono::microseconds &, AttackCallback *attack_callback) {
+        UnsearchedAttackCallback unsearched_attack_callback(attack_callback);
+        return act(&unsearched_attack_callback);
+    }
 
-        const auto width = own_field_->get_configuration().field_width,
-                height = own_field_->get_configuration().field_height;
+    bool SimpleRivalBot::act_salvo(const size_t &shots, AttackCallback *attack_callback) {
+        BATTLESHIPS_INSTRUMENT(BOT_ACT);
+        attack_callback = EmptyAttackCallback::or_empty(attack_callback);
 
-        auto direction = random_direction(random_);
-        for (int deltaX = 0; deltaX < width; ++deltaX) for (int deltaY = 0; deltaY < height; ++deltaY) {
-            const auto tested_coordinate = Coordinate(
-                    (original_coordinate.x + deltaX) % int(width), (original_coordinate.y + deltaY) % int(height)
-            );
-            for (int i = 0; i < 4; ++i) {
-                if (own_field_->try_emplace_ship(tested_coordinate, direction, ship_size)) return;
-                direction = rotate_direction_counter_clockwise(direction);
-            }
+        // the cells continuing the ship being finished are aimed first and the rest of the salvo is random
+        const auto count = std::min(shots, rival_field_->count_not_visited());
+        salvo_targets_.clear();
+        if (attacked_ship_coordinate_.has_value()) for (const auto &direction : ALL_DIRECTIONS) {
+            if (ship_direction_ != NONE && (ship_direction_ == HORIZONTAL) != is_horizontal_direction(direction))
+                continue;
+
+            const auto continuation = find_continuation(attacked_ship_coordinate_.value(), direction);
+            if (continuation.has_value()) salvo_targets_.push_back(continuation.value());
+        }
+        std::shuffle(salvo_targets_.begin(), salvo_targets_.end(), random_);
+        if (salvo_targets_.size() > count)
+            salvo_targets_.erase(salvo_targets_.begin() + ptrdiff_t(count), salvo_targets_.end());
+        while (salvo_targets_.size() < count) {
+            const auto target = rival_field_->random_not_visited_spot(random_);
+            if (std::find(salvo_targets_.begin(), salvo_targets_.end(), target) == salvo_targets_.end())
+                salvo_targets_.push_back(target);
         }
 
-        throw runtime_error("Unable to place " + to_string(ship_size) + "-celled ship at the field");
-    }
+        salvo_statuses_.resize(count);
+        rival_field_->attack_batch(salvo_targets_, salvo_statuses_);
+        for (size_t i = 0; i < count; ++i) {
+            const auto &target = salvo_targets_[i];
+            attack_callback->on_attack(target, salvo_statuses_[i]);
+            // the shots following the winning one are not counted
+            if (salvo_statuses_[i] == GameField::WIN) {
+                handle_ship_destruction();
+                unfinished_hits_.clear();
+                return true;
+            }
+            if (salvo_statuses_[i] != GameField::DAMAGE_SHIP) continue;
 
-    void SimpleRivalBot::place_ships() {
-        const auto ships = own_field_->get_configuration().ships;
-        for (auto iterator = ships.rbegin(); iterator != ships.rend(); ++iterator) {
-            const auto entry = *iterator;
-            for (size_t shipId = 0; shipId < entry.second; ++shipId) place_ship_randomly(entry.first);
+            if (!attacked_ship_coordinate_.has_value()) attacked_ship_coordinate_ = target;
+            else if (ship_direction_ == NONE && std::abs(target.x - attacked_ship_coordinate_->x)
+                                                + std::abs(target.y - attacked_ship_coordinate_->y) == 1)
+                ship_direction_ = target.y == attacked_ship_coordinate_->y ? HORIZONTAL : VERTICAL;
+            else unfinished_hits_.push_back(target);
         }
+
+        // the ships hit by the salvos are finished one by one
+        std::erase_if(unfinished_hits_, [this](const Coordinate &hit) { return is_ship_destroyed(hit); });
+        if (attacked_ship_coordinate_.has_value() && is_ship_destroyed(attacked_ship_coordinate_.value()))
+            handle_ship_destruction();
+        if (!attacked_ship_coordinate_.has_value() && !unfinished_hits_.empty()) {
+            attacked_ship_coordinate_ = unfinished_hits_.front();
+            unfinished_hits_.erase(unfinished_hits_.begin());
+        }
+
+        return false;
     }
 
-    bool SimpleRivalBot::act(AttackCallback *attack_callback) {
-        return attacked_ship_coordinate_.has_value()
-               ? continue_attack(EmptyAttackCallback::or_empty(attack_callback))
-               : random_attack(EmptyAttackCallback::or_empty(attack_callback));
+    ShotStream SimpleRivalBot::shots() {
+        while (true) {
+            if (!attacked_ship_coordinate_.has_value()) {
+                const auto attacked_coordinate = rival_field_->random_not_visited_spot(random_);
+                const auto attack_status = co_yield attacked_coordinate;
+                switch (attack_status) {
+                    case GameField::EMPTY_ALREADY_ATTACKED:
+                    case GameField::SHIP_ALREADY_ATTACKED: throw runtime_error(
+                            "Cell was expected to not be visited"
+                    );
+                    case GameField::MISS: break;
+                    // multi-celled ship
+                    case GameField::DAMAGE_SHIP: {
+                        attacked_ship_coordinate_ = attacked_coordinate;
+                        break;
+                    }
+                    // single-celled ship destruction
+                    case GameField::DESTROY_SHIP: break;
+                    case GameField::WIN: {
+                        handle_ship_destruction();
+                        co_return;
+                    }
+                }
+                continue;
+            }
+
+            const auto initial_coordinate = attacked_ship_coordinate_.value();
+
+            //  attempt an attack to reveal the direction
+            if (ship_direction_ == NONE) {
+                const auto attack_direction = random_available_attack_direction(initial_coordinate);
+                const auto attack_status = co_yield initial_coordinate.move(attack_direction, 1);
+                switch (attack_status) {
+                    case GameField::EMPTY_ALREADY_ATTACKED:
+                    case GameField::SHIP_ALREADY_ATTACKED: throw runtime_error(
+                            "Attempt to attack an already attacked point"
+                    );
+                    case GameField::MISS: continue;
+                    case GameField::DESTROY_SHIP: {
+                        handle_ship_destruction();
+                        continue;
+                    }
+                    case GameField::WIN: {
+                        handle_ship_destruction();
+                        co_return;
+                    }
+                    case GameField::DAMAGE_SHIP: {
+                        ship_direction_ = is_horizontal_direction(attack_direction) ? HORIZONTAL : VERTICAL;
+                        break;
+                    }
+                }
+            }
+
+            // attempt to attack a ship according to its axis
+            const auto attack_direction = ship_direction_ == VERTICAL
+                    ? random_vertical_direction(random_) : random_horizontal_direction(random_);
+
+            auto attacked_coordinate = initial_coordinate.move(attack_direction, 1);
+
+            bool direction_inverted = false, ship_attacked = true;
+            while (ship_attacked) {
+
+                if (rival_field_->is_out_of_bounds(attacked_coordinate)) {
+                    if (direction_inverted) throw runtime_error("Could not find an appropriate point to attack");
+
+                    attacked_coordinate = initial_coordinate.move(attack_direction, -1);
+                    direction_inverted = true;
+                }
+
+                if (rival_field_->is_discovered(attacked_coordinate)) {
+                    // continue as it is fine to meet the attacked ship point
+                    if (rival_field_->get_public_icon_at(attacked_coordinate) != '#') {
+                        if (direction_inverted) throw runtime_error("Could not find an appropriate point to attack");
+
+                        attacked_coordinate = initial_coordinate; // this will get moved later
+                        direction_inverted = true;
+                    }
+                    attacked_coordinate.move(attack_direction, direction_inverted ? -1 : 1);
+                    continue;
+                }
+
+                const auto attack_status = co_yield attacked_coordinate;
+                switch (attack_status) {
+                    case GameField::EMPTY_ALREADY_ATTACKED:
+                    case GameField::SHIP_ALREADY_ATTACKED: throw runtime_error(
+                            "Cell was expected to not be visited"
+                    );
+                    case GameField::MISS: {
+                        ship_attacked = false;
+                        break;
+                    }
+                    case GameField::DAMAGE_SHIP: break; // simply continue the attack in this direction
+                    case GameField::DESTROY_SHIP: {
+                        handle_ship_destruction();
+                        ship_attacked = false;
+                        break;
+                    }
+                    case GameField::WIN: {
+                        handle_ship_destruction();
+                        co_return;
+                    }
+                }
+
+                attacked_coordinate.move(attack_direction, direction_inverted ? -1 : 1);
+            }
+        }
     }
 
     bool SimpleRivalBot::continue_attack(AttackCallback *const attack_callback) {
@@ -129,8 +276,7 @@ namespace battleships {
 
     bool SimpleRivalBot::random_attack(AttackCallback *const attack_callback) {
         while (true) {
-            auto attacked_coordinate = random_own_coordinate();
-            locate_not_visited_spot(attacked_coordinate, rival_field_);
+            const auto attacked_coordinate = rival_field_->random_not_visited_spot(random_);
 
             const auto attack_status = rival_field_->attack(attacked_coordinate);
             attack_callback->on_attack(attacked_coordinate, attack_status);
@@ -143,7 +289,7 @@ namespace battleships {
                 case GameField::DAMAGE_SHIP: {
                     // Multi-celled ship
                     attacked_ship_coordinate_ = attacked_coordinate;
-                    continue_attack(attack_callback);
+                    return continue_attack(attack_callback);
                 }
                 /* single-celled ship destruction */
                 case GameField::DESTROY_SHIP: continue;
@@ -176,4 +322,19 @@ namespace battleships {
 
         throw runtime_error("No available attack direction for coordinate " + coordinate.to_string());
     }
+
+    optional<Coordinate> SimpleRivalBot::find_continuation(const Coordinate &coordinate,
+                                                           const Direction &direction) const {
+        auto cell = coordinate.move(direction, 1);
+        while (rival_field_->is_in_bounds(cell) && rival_field_->is_discovered(cell)
+               && rival_field_->get_public_icon_at(cell) == '#') cell.move(direction, 1);
+
+        return rival_field_->can_be_attacked(cell) ? optional(cell) : std::nullopt;
+    }
+
+    bool SimpleRivalBot::is_ship_destroyed(const Coordinate &coordinate) const {
+        return std::none_of(std::begin(ALL_DIRECTIONS), std::end(ALL_DIRECTIONS), [&](const Direction &direction) {
+            return find_continuation(coordinate, direction).has_value();
+        });
+    }
 }
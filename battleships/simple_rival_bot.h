@@ -1,23 +1,22 @@
 #pragma once
 
-#include <random>
 #include <set>
 #include <optional>
+#include <vector>
 
+#include "coroutine_rival_bot.h"
 #include "rival_bot.h"
 #include "direction.h"
+#include "random_engine.h"
 #include "ship_position.h"
 
-using std::default_random_engine;
-using std::random_device;
-using std::bernoulli_distribution;
-using std::uniform_int_distribution;
 using std::optional;
 using std::set;
+using std::vector;
 
 namespace battleships {
 
-    class SimpleRivalBot : RivalBot {
+    class SimpleRivalBot : public RivalBot, public CoroutineRivalBot {
 
     protected:
 
@@ -31,31 +30,20 @@ namespace battleships {
 
         ShipPosition ship_direction_ = NONE;
 
-        random_device random_;
+        /**
+         * @brief Damaged cells of the other ships hit by the salvos which are finished after the current one
+         */
+        vector<Coordinate> unfinished_hits_;
 
+        /**
+         * @brief Buffers of the targets of the current salvo and their results
+         */
+        vector<Coordinate> salvo_targets_;
+        vector<GameField::AttackStatus> salvo_statuses_;
 
-        /* non-const */ bernoulli_distribution free_spot_lookup_side_random_distribution_;
-        /* non-const */ uniform_int_distribution<size_t> own_x_random_distribution_, own_y_random_distribution_,
-                rival_x_random_distribution_, rival_y_random_distribution_;
-        /* non-const */ uniform_int_distribution<int8_t> direction_random_distribution_;
+        const uint64_t seed_;
 
-        inline Coordinate random_own_coordinate() {
-            return Coordinate(own_x_random_distribution_(random_), own_y_random_distribution_(random_));
-        }
-
-        inline Coordinate random_rival_coordinate() {
-            return Coordinate(rival_x_random_distribution_(random_), rival_y_random_distribution_(random_));
-        }
-
-        inline void locate_not_visited_spot(/* mut */ Coordinate &coordinate, const GameField *const game_field) {
-            game_field->locate_not_visited_spot(
-                    coordinate,
-                    random_direction(random_),
-                    free_spot_lookup_side_random_distribution_(random_)
-            );
-        }
-
-        void place_ship_randomly(const size_t &ship_size);
+        RandomEngine random_;
 
         bool continue_attack(AttackCallback *attack_callback);
 
@@ -65,19 +53,64 @@ namespace battleships {
 
         Direction random_available_attack_direction(const Coordinate &coordinate);
 
+        /**
+         * @brief Finds the cell which may continue the damaged ship in the given direction,
+         * that is the first undiscovered cell reached from the ship's cell through its damaged cells.
+         *
+         * @param coordinate coordinate of the ship's damaged cell
+         * @param direction direction to look in
+         * @return coordinate of the found cell or an empty optional if there is none in this direction
+         */
+        [[nodiscard]] optional<Coordinate> find_continuation(const Coordinate &coordinate,
+                                                             const Direction &direction) const;
+
+        /**
+         * @brief Checks whether the ship containing the damaged cell is destroyed,
+         * that is whether it cannot be continued in any direction as the field discovers the surroundings of those.
+         *
+         * @param coordinate coordinate of the ship's damaged cell
+         * @return {@code true} if the ship is destroyed and {@code false} otherwise
+         */
+        [[nodiscard]] bool is_ship_destroyed(const Coordinate &coordinate) const;
+
     public:
 
-        explicit SimpleRivalBot(GameField *const own_field, GameField *const rival_field)
-                : own_field_(own_field), rival_field_(rival_field),
-                  own_x_random_distribution_(0, own_field_->get_configuration().field_width - 1),
-                  own_y_random_distribution_(0, own_field_->get_configuration().field_height - 1),
-                  rival_x_random_distribution_(0, rival_field_->get_configuration().field_width - 1),
-                  rival_y_random_distribution_(0, rival_field_->get_configuration().field_height - 1),
-                  direction_random_distribution_(0, 3) {}
+        /**
+         * @brief Creates a new bot.
+         *
+         * @param own_field field of this bot
+         * @param rival_field field of the rival attacked by this bot
+         * @param seed seed of this bot's random engine, the same seed leads to the same behaviour
+         */
+        explicit SimpleRivalBot(GameField *const own_field, GameField *const rival_field,
+                                const uint64_t &seed = random_seed())
+                : own_field_(own_field), rival_field_(rival_field), seed_(seed), random_(seed) {}
+
+        /**
+         * @brief Gets the seed of this bot's random engine which can be used to replay its behaviour.
+         *
+         * @return seed of this bot
+         */
+        [[nodiscard]] uint64_t seed() const noexcept {
+            return seed_;
+        }
 
         void place_ships() override;
 
         bool act(AttackCallback *attack_callback) override;
+
+        bool act_salvo(const size_t &shots, AttackCallback *attack_callback) override;
+
+        /**
+         * @brief Makes a turn as {@link #act} does as the shots of this bot are chosen without any search.
+         */
+        bool act_within(const std::chrono::microseconds &shot_budget, AttackCallback *attack_callback) override;
+
+        /**
+         * @brief Starts the shots of this bot which are the same as those made by its turns.
+         * The cells already attacked are passed by looking at the rival's field instead of being shot at.
+         */
+        [[nodiscard]] ShotStream shots() override;
     };
 }
 
@@ -0,0 +1,179 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+using std::exception_ptr;
+using std::unique_lock;
+
+namespace battleships {
+
+    namespace {
+
+        /**
+         * @brief Pool whose worker is the current thread if any
+         */
+        thread_local const ThreadPool *current_pool = nullptr;
+
+        /**
+         * @brief Index of the current thread among the workers of {@code current_pool}
+         */
+        thread_local size_t current_pool_worker = 0;
+    }
+
+    ThreadPool::ThreadPool(const size_t &thread_count) {
+        const auto count = std::max<size_t>(1, thread_count);
+        queues_.reserve(count);
+        for (size_t i = 0; i < count; ++i) queues_.push_back(std::make_unique<TaskQueue>());
+
+        workers_.reserve(count);
+        for (size_t i = 0; i < count; ++i) workers_.emplace_back(&ThreadPool::work, this, i);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        task_available_.notify_all();
+        for (auto &worker : workers_) worker.join();
+    }
+
+    ThreadPool &ThreadPool::shared() {
+        /**
+         * @brief Lazily created shared pool
+         */
+        static ThreadPool INSTANCE(std::max(1u, thread::hardware_concurrency()));
+        return INSTANCE;
+    }
+
+    size_t ThreadPool::current_worker() const noexcept {
+        return current_pool == this ? current_pool_worker : queues_.size();
+    }
+
+    bool ThreadPool::take_task(const size_t &worker, function<void()> &task) {
+        if (pending_tasks_.load(std::memory_order_acquire) == 0) return false;
+
+        const auto queue_count = queues_.size();
+        if (worker < queue_count) {
+            auto &queue = *queues_[worker];
+            std::lock_guard<mutex> lock(queue.guard);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                pending_tasks_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // the victims are visited starting from the following worker so that the thieves don't contend for one queue
+        const auto first_victim = worker < queue_count ? worker + 1 : 0;
+        for (size_t i = 0; i < queue_count; ++i) {
+            const auto victim = (first_victim + i) % queue_count;
+            if (victim == worker) continue;
+
+            auto &queue = *queues_[victim];
+            std::lock_guard<mutex> lock(queue.guard);
+            if (queue.tasks.empty()) continue;
+
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            pending_tasks_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool ThreadPool::run_pending_task(const size_t &worker) {
+        function<void()> task;
+        if (!take_task(worker, task)) return false;
+
+        task();
+        return true;
+    }
+
+    void ThreadPool::work(const size_t index) {
+        current_pool = this;
+        current_pool_worker = index;
+
+        while (true) {
+            if (run_pending_task(index)) continue;
+
+            unique_lock<mutex> lock(mutex_);
+            task_available_.wait(lock, [this] {
+                return pending_tasks_.load(std::memory_order_acquire) != 0 || stopping_;
+            });
+            // the pending tasks are completed before stopping
+            if (stopping_ && pending_tasks_.load(std::memory_order_acquire) == 0) return;
+        }
+    }
+
+    void ThreadPool::push(vector<function<void()>> &&tasks) {
+        const auto task_count = tasks.size(), worker = current_worker();
+        if (worker < queues_.size()) {
+            auto &queue = *queues_[worker];
+            std::lock_guard<mutex> lock(queue.guard);
+            for (auto &task : tasks) queue.tasks.push_back(std::move(task));
+            pending_tasks_.fetch_add(task_count, std::memory_order_release);
+        } else for (auto &task : tasks) {
+            auto &queue = *queues_[next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size()];
+            std::lock_guard<mutex> lock(queue.guard);
+            queue.tasks.push_back(std::move(task));
+            pending_tasks_.fetch_add(1, std::memory_order_release);
+        }
+
+        // the sleeping workers check the pending tasks under this lock so none of them misses the notification
+        { std::lock_guard<mutex> lock(mutex_); }
+        if (task_count == 1) task_available_.notify_one();
+        else task_available_.notify_all();
+    }
+
+    void ThreadPool::submit(function<void()> task) {
+        vector<function<void()>> tasks;
+        tasks.push_back(std::move(task));
+        push(std::move(tasks));
+    }
+
+    void ThreadPool::run_batch(const size_t &task_count, const function<void(size_t)> &task) {
+        if (task_count == 0) return;
+
+        // state shared with the submitted tasks, it lives on this stack frame as it is awaited before returning
+        size_t tasks_left = task_count;
+        exception_ptr failure;
+        mutex batch_mutex;
+        condition_variable batch_completed;
+
+        vector<function<void()>> tasks;
+        tasks.reserve(task_count);
+        for (size_t index = 0; index < task_count; ++index) tasks.emplace_back([&, index] {
+            exception_ptr task_failure;
+            try {
+                task(index);
+            } catch (...) {
+                task_failure = std::current_exception();
+            }
+
+            std::lock_guard<mutex> lock(batch_mutex);
+            if (task_failure && !failure) failure = task_failure;
+            if (--tasks_left == 0) batch_completed.notify_all();
+        });
+        push(std::move(tasks));
+
+        const auto worker = current_worker();
+        while (true) {
+            {
+                std::lock_guard<mutex> lock(batch_mutex);
+                if (tasks_left == 0) break;
+            }
+            if (run_pending_task(worker)) continue;
+
+            unique_lock<mutex> lock(batch_mutex);
+            batch_completed.wait(lock, [&] { return tasks_left == 0; });
+            break;
+        }
+
+        std::lock_guard<mutex> lock(batch_mutex);
+        if (failure) std::rethrow_exception(failure);
+    }
+}
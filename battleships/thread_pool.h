@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::atomic;
+using std::condition_variable;
+using std::deque;
+using std::function;
+using std::mutex;
+using std::thread;
+using std::unique_ptr;
+using std::vector;
+
+namespace battleships {
+
+    /**
+     * @brief Fixed-size pool of worker threads executing submitted tasks with work stealing.
+     *
+     * Each worker has its own deque of tasks: the tasks submitted by a worker are pushed to its deque and it takes
+     * the newest of them first, while the idle workers steal the oldest tasks of the others. The tasks submitted
+     * from outside of the pool are spread over the deques. This keeps the load balanced when some tasks take much
+     * longer than the others, the tasks spawned by them being picked up by whichever workers are free.
+     */
+    class ThreadPool {
+
+        /**
+         * @brief Deque of the tasks of a single worker
+         */
+        struct TaskQueue {
+            mutex guard;
+            deque<function<void()>> tasks;
+        };
+
+        vector<unique_ptr<TaskQueue>> queues_;
+
+        vector<thread> workers_;
+
+        /**
+         * @brief Number of the tasks in all the queues
+         */
+        atomic<size_t> pending_tasks_{0};
+
+        /**
+         * @brief Index of the queue to which the next task submitted from outside of the pool is pushed
+         */
+        atomic<size_t> next_queue_{0};
+
+        /**
+         * @brief Lock guarding the sleep of the idle workers
+         */
+        mutex mutex_;
+
+        condition_variable task_available_;
+
+        bool stopping_ = false;
+
+        void work(size_t index);
+
+        /**
+         * @brief Gets the index of the calling worker of this pool.
+         *
+         * @return index of the worker or the number of the workers if the caller is not one of those
+         */
+        [[nodiscard]] size_t current_worker() const noexcept;
+
+        /**
+         * @brief Takes a task from the worker's own queue or steals one from the other queues.
+         *
+         * @param worker index of the worker taking the task or the number of the workers if the caller is not one
+         * @param task task to move the taken one to
+         * @return {@code true} if a task was taken and {@code false} if all the queues were empty
+         */
+        bool take_task(const size_t &worker, function<void()> &task);
+
+        /**
+         * @brief Executes a single queued task if there is one.
+         *
+         * @param worker index of the worker executing the task or the number of the workers if the caller is not one
+         * @return {@code true} if a task was executed and {@code false} if all the queues were empty
+         */
+        bool run_pending_task(const size_t &worker);
+
+        /**
+         * @brief Pushes the tasks to the queue of the calling worker or spreads them over the queues if it is not one.
+         */
+        void push(vector<function<void()>> &&tasks);
+
+    public:
+
+        /**
+         * @brief Creates a new thread pool.
+         *
+         * @param thread_count number of worker threads, at least one is always created
+         */
+        explicit ThreadPool(const size_t &thread_count);
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /**
+         * @brief Waits for all the submitted tasks to complete and stops the workers.
+         */
+        ~ThreadPool();
+
+        /**
+         * @brief Gets the pool shared by all the users which do not need a dedicated one.
+         * It has as many workers as there are hardware threads.
+         *
+         * @return shared thread pool
+         */
+        [[nodiscard]] static ThreadPool &shared();
+
+        [[nodiscard]] size_t size() const noexcept {
+            return workers_.size();
+        }
+
+        /**
+         * @brief Submits the task to be executed by some worker.
+         *
+         * @param task task to execute
+         */
+        void submit(function<void()> task);
+
+        /**
+         * @brief Executes the task for each index from {@code 0} to {@code task_count - 1} and waits for completion.
+         * The calling thread helps with executing queued tasks while waiting so this may be called from the pool's
+         * own tasks. The first exception thrown by any of the tasks is rethrown.
+         *
+         * @param task_count number of times to execute the task
+         * @param task task accepting its index
+         */
+        void run_batch(const size_t &task_count, const function<void(size_t)> &task);
+    };
+}
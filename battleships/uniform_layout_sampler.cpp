@@ -0,0 +1,299 @@
+#include "uniform_layout_sampler.h"
+
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <random>
+
+using std::invalid_argument;
+using std::map;
+using std::runtime_error;
+using std::uniform_int_distribution;
+
+namespace battleships {
+
+    namespace {
+
+        /*
+         * Profile cell codes: {@code VERTICAL + k} is the lowest cell of a ship of length {@code k}
+         * which may still continue downwards (single cells also start this way),
+         * {@code max_ship_length + k} is the rightmost cell of a horizontal ship of length {@code k}
+         * which may still continue to the right and {@code OCCUPIED} is any other ship cell
+         */
+
+        constexpr uint64_t EMPTY = 0, OCCUPIED = 1, VERTICAL = 1;
+
+        [[nodiscard]] LayoutCount random_below(RandomEngine &random, const LayoutCount &bound) {
+            if ((bound >> 64u) == 0) return uniform_int_distribution<uint64_t>(0, uint64_t(bound) - 1)(random);
+
+            // rejection sampling over the smallest power of two covering the bound
+            const auto high_mask = ~uint64_t(0) >> std::countl_zero(uint64_t((bound - 1) >> 64u));
+            while (true) {
+                const auto high = random() & high_mask, low = random();
+                const auto value = (LayoutCount(high) << 64u) | low;
+                if (value < bound) return value;
+            }
+        }
+    }
+
+    string layout_count_to_string(LayoutCount count) {
+        string digits;
+        do {
+            digits.push_back(char('0' + int(count % 10)));
+            count /= 10;
+        } while (count != 0);
+        std::reverse(digits.begin(), digits.end());
+
+        return digits;
+    }
+
+    UniformLayoutSampler::UniformLayoutSampler(const GameConfiguration &configuration)
+            : configuration_(configuration),
+              transposed_(configuration.field_height < configuration.field_width) {
+        // narrow fields are processed by columns so that there are less profiles
+        line_length_ = transposed_ ? configuration.field_height : configuration.field_width;
+        line_count_ = transposed_ ? configuration.field_width : configuration.field_height;
+        if (line_length_ == 0) throw invalid_argument("The field should not be empty");
+
+        max_ship_length_ = configuration.ships.empty() ? 0 : configuration.ships.rbegin()->first;
+        if (!configuration.ships.empty() && configuration.ships.begin()->first == 0)
+            throw invalid_argument("Ships should not be empty");
+        cell_bits_ = std::bit_width(std::max<size_t>(2 * max_ship_length_, 1));
+        if (line_length_ * cell_bits_ > 64) throw invalid_argument("The field is too wide for the fleet");
+
+        fleet_.assign(max_ship_length_ + 1, 0);
+        count_radices_.assign(max_ship_length_ + 1, 0);
+        fleet_states_ = 1;
+        size_t initial_fleet_state = 0;
+        for (size_t length = 1; length <= max_ship_length_; ++length) {
+            const auto entry = configuration.ships.find(length);
+            fleet_[length] = entry == configuration.ships.end() ? 0 : entry->second;
+
+            count_radices_[length] = fleet_states_;
+            initial_fleet_state += fleet_[length] * fleet_states_;
+            if (__builtin_mul_overflow(fleet_states_, fleet_[length] + 1, &fleet_states_))
+                throw invalid_argument("The fleet is too large");
+        }
+
+        // collect the profiles reachable at each of the boundaries with the transitions between those
+        map<vector<size_t>, uint32_t> completed_ship_kinds;
+        boundaries_.resize(line_count_ + 1);
+        boundaries_[0].profiles.push_back(0);
+        for (size_t line = 0; line < line_count_; ++line) {
+            auto &boundary = boundaries_[line];
+            auto &next_profiles = boundaries_[line + 1].profiles;
+            unordered_map<uint64_t, uint32_t> next_indices;
+
+            boundary.transition_offsets.reserve(boundary.profiles.size() + 1);
+            for (const auto &profile : boundary.profiles) {
+                boundary.transition_offsets.push_back(boundary.transitions.size());
+                for_each_line_content(profile, [&](const LineContent &content) {
+                    const auto next_index = next_indices.emplace(content.profile, next_profiles.size());
+                    if (next_index.second) next_profiles.push_back(content.profile);
+
+                    const auto kind = completed_ship_kinds.emplace(
+                            content.completed_ships, completed_ship_kinds.size()
+                    );
+                    boundary.transitions.push_back({content.cells, next_index.first->second, kind.first->second});
+                });
+            }
+            boundary.transition_offsets.push_back(boundary.transitions.size());
+        }
+
+        fleet_transitions_.resize(completed_ship_kinds.size() * fleet_states_);
+        for (const auto &kind : completed_ship_kinds)
+            for (size_t fleet_state = 0; fleet_state < fleet_states_; ++fleet_state) {
+                auto next_fleet_state = fleet_state;
+                for (size_t length = 1; length <= max_ship_length_; ++length) {
+                    const auto completed = kind.first[length];
+                    if (ships_left(fleet_state, length) < completed) {
+                        next_fleet_state = fleet_states_;
+                        break;
+                    }
+                    next_fleet_state -= completed * count_radices_[length];
+                }
+                fleet_transitions_[kind.second * fleet_states_ + fleet_state] = uint32_t(next_fleet_state);
+            }
+
+        // the layout is complete after the last line once its vertical ships are all the ships left
+        {
+            auto &last = boundaries_[line_count_];
+            last.completions.assign(last.profiles.size() * fleet_states_, 0);
+            vector<size_t> completed_ships(max_ship_length_ + 1);
+            for (size_t index = 0; index < last.profiles.size(); ++index) {
+                std::fill(completed_ships.begin(), completed_ships.end(), 0);
+                bool fits = true;
+                size_t fleet_state = 0;
+                for (size_t i = 0; i < line_length_; ++i) {
+                    const auto cell = cell_at(last.profiles[index], i);
+                    if (cell <= VERTICAL) continue;
+
+                    const auto length = cell - VERTICAL;
+                    fits &= ++completed_ships[length] <= fleet_[length];
+                    fleet_state += count_radices_[length];
+                }
+                if (fits) last.completions[index * fleet_states_ + fleet_state] = 1;
+            }
+        }
+
+        // count the completions of each profile from the last lines to the first ones
+        for (auto line = line_count_; line-- > 0;) {
+            auto &boundary = boundaries_[line];
+            boundary.completions.assign(boundary.profiles.size() * fleet_states_, 0);
+
+            for (size_t index = 0; index < boundary.profiles.size(); ++index)
+                for (auto transition = boundary.transition_offsets[index];
+                     transition < boundary.transition_offsets[index + 1]; ++transition)
+                    for (size_t fleet_state = 0; fleet_state < fleet_states_; ++fleet_state) {
+                        auto &count = boundary.completions[index * fleet_states_ + fleet_state];
+                        const auto added = completions_after(line, boundary.transitions[transition], fleet_state);
+                        if (count + added < count) throw runtime_error("The fleet has too many layouts to count");
+                        count += added;
+                    }
+        }
+
+        initial_fleet_state_ = initial_fleet_state;
+        if (layout_count() == 0) throw runtime_error("The fleet has no legal layouts");
+    }
+
+    /*
+     * Line enumeration
+     */
+
+    template<typename C>
+    void UniformLayoutSampler::for_each_line_content(const uint64_t &profile, C &&consumer) const {
+        vector<size_t> completed_ships(max_ship_length_ + 1, 0);
+        const auto is_vertical = [this](const uint64_t &cell) {
+            return cell > VERTICAL && cell <= VERTICAL + max_ship_length_;
+        };
+        const auto is_horizontal = [this](const uint64_t &cell) { return cell > VERTICAL + max_ship_length_; };
+
+        // the profile holds the cells of this line before the offset and the cells of the previous one after it
+        const auto visit = [&](const auto &self, const size_t &offset, const uint64_t &current,
+                               const bool &up_left_occupied, const uint64_t &cells) -> void {
+            if (offset == line_length_) {
+                consumer(LineContent{cells, current, completed_ships});
+                return;
+            }
+
+            const auto up = cell_at(current, offset),
+                    left = offset == 0 ? EMPTY : cell_at(current, offset - 1),
+                    up_right = offset + 1 == line_length_ ? EMPTY : cell_at(current, offset + 1);
+
+            for (const auto occupied : {false, true}) {
+                size_t completed_lengths[3], completed_count = 0;
+                const auto complete = [&](const size_t &length) {
+                    completed_lengths[completed_count++] = length;
+                    return ++completed_ships[length] <= fleet_[length];
+                };
+
+                auto next = current;
+                bool legal = true;
+                if (occupied) {
+                    // ships never touch each other even by the corners
+                    if (up_left_occupied || up_right != EMPTY) continue;
+
+                    if (up != EMPTY) {
+                        if (!is_vertical(up) || left != EMPTY || up - VERTICAL == max_ship_length_) continue;
+                        next = with_cell(next, offset, up + 1);
+                    } else if (left != EMPTY) {
+                        // only single cells and horizontal ships may be continued to the right
+                        if (left != VERTICAL + 1 && !is_horizontal(left)) continue;
+
+                        const auto length = (left == VERTICAL + 1 ? 1 : left - max_ship_length_) + 1;
+                        if (length > max_ship_length_) continue;
+                        next = with_cell(with_cell(next, offset - 1, OCCUPIED), offset, max_ship_length_ + length);
+                    } else next = with_cell(next, offset, VERTICAL + 1);
+                } else {
+                    if (is_vertical(up)) legal &= complete(up - VERTICAL);
+                    if (is_horizontal(left)) {
+                        legal &= complete(left - max_ship_length_);
+                        next = with_cell(next, offset - 1, OCCUPIED);
+                    }
+                    next = with_cell(next, offset, EMPTY);
+                }
+
+                // the line is over so the horizontal ship at its end is complete
+                if (offset + 1 == line_length_ && is_horizontal(cell_at(next, offset))) {
+                    legal &= complete(cell_at(next, offset) - max_ship_length_);
+                    next = with_cell(next, offset, OCCUPIED);
+                }
+
+                if (legal) self(self, offset + 1, next, up != EMPTY, cells | (uint64_t(occupied) << offset));
+                for (size_t i = 0; i < completed_count; ++i) --completed_ships[completed_lengths[i]];
+            }
+        };
+        visit(visit, 0, profile, false, 0);
+    }
+
+    /*
+     * Sampling
+     */
+
+    LayoutCount UniformLayoutSampler::layout_count() const {
+        return boundaries_[0].completions[initial_fleet_state_];
+    }
+
+    size_t UniformLayoutSampler::profile_count() const noexcept {
+        size_t count = 0;
+        for (const auto &boundary : boundaries_) count += boundary.profiles.size();
+
+        return count;
+    }
+
+    void UniformLayoutSampler::sample(RandomEngine &random, Bitboard &layout) const {
+        layout.clear();
+
+        size_t profile = 0, fleet_state = initial_fleet_state_;
+        for (size_t line = 0; line < line_count_; ++line) {
+            const auto &boundary = boundaries_[line];
+            const auto first = boundary.transitions.begin() + ptrdiff_t(boundary.transition_offsets[profile]),
+                    last = boundary.transitions.begin() + ptrdiff_t(boundary.transition_offsets[profile + 1]);
+
+            // the number of completions of the profile is the sum of those of its transitions
+            auto chosen = random_below(random, boundary.completions[profile * fleet_states_ + fleet_state]);
+            auto transition = first;
+            for (; transition + 1 != last; ++transition) {
+                const auto count = completions_after(line, *transition, fleet_state);
+                if (chosen < count) break;
+
+                chosen -= count;
+            }
+
+            profile = transition->next_profile;
+            fleet_state = fleet_transitions_[transition->completed_ships * fleet_states_ + fleet_state];
+            for (size_t offset = 0; offset < line_length_; ++offset) if ((transition->cells >> offset) & 1u)
+                layout.set(transposed_ ? line : offset, transposed_ ? offset : line);
+        }
+    }
+
+    void UniformLayoutSampler::sample(RandomEngine &random, vector<ShipPlacement> &placements) const {
+        const auto width = configuration_.field_width, height = configuration_.field_height;
+        Bitboard layout(width, height);
+        sample(random, layout);
+
+        placements.clear();
+        for (size_t y = 0; y < height; ++y) for (size_t x = 0; x < width; ++x) {
+            // ships are described by their left or lower cells
+            if (!layout.test(x, y) || (x != 0 && layout.test(x - 1, y)) || (y != 0 && layout.test(x, y - 1))) continue;
+
+            const auto horizontal = x + 1 != width && layout.test(x + 1, y);
+            size_t size = 1;
+            while (horizontal ? x + size != width && layout.test(x + size, y)
+                              : y + size != height && layout.test(x, y + size)) ++size;
+
+            placements.push_back({
+                    Coordinate(static_cast<int>(x), static_cast<int>(y)), horizontal ? RIGHT : UP, size
+            });
+        }
+    }
+
+    void UniformLayoutSampler::place_ships(GameField *const field, RandomEngine &random) const {
+        vector<ShipPlacement> placements;
+        sample(random, placements);
+
+        for (const auto &placement : placements)
+            if (!field->try_emplace_ship(placement.coordinate, placement.direction, placement.size))
+                throw runtime_error("The field refused the sampled ship placement");
+    }
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bitboard.h"
+#include "game_configuration.h"
+#include "game_field.h"
+#include "placement_engine.h"
+#include "random_engine.h"
+
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+namespace battleships {
+
+    /**
+     * @brief Number of fleet layouts, those easily exceed 64 bits for larger fields
+     */
+    using LayoutCount = unsigned __int128;
+
+    /**
+     * @brief Converts the layout count to its decimal representation.
+     *
+     * @param count count to convert
+     * @return decimal representation of the count
+     */
+    [[nodiscard]] string layout_count_to_string(LayoutCount count);
+
+    /**
+     * @brief Generator drawing fleet layouts uniformly over all the legal layouts of a configuration.
+     *
+     * The field is processed line by line (i.e. by rows or by columns of narrow fields) keeping the profile
+     * of the last line as the state. For each profile reachable at each line boundary the numbers of ways
+     * to complete the layout are counted once on creation for all the possible counts of the ships left.
+     * Sampling then picks each line out of all its legal contents with the probability proportional
+     * to the number of layouts continuing it, so no layouts are ever rejected.
+     *
+     * Samplers are immutable once created and thus may be shared between threads.
+     */
+    class UniformLayoutSampler {
+
+        /**
+         * @brief Legal content of a line following some profile
+         */
+        struct LineTransition {
+
+            /**
+             * @brief Bits of the occupied cells of the line
+             */
+            uint64_t cells;
+
+            /**
+             * @brief Index of the profile after the line at the next boundary
+             */
+            uint32_t next_profile;
+
+            /**
+             * @brief Index of the counts of the ships completed by the line in {@code fleet_transitions_}
+             */
+            uint32_t completed_ships;
+        };
+
+        /**
+         * @brief Profiles reachable at a line boundary with their transitions and the numbers of their completions
+         */
+        struct Boundary {
+
+            vector<uint64_t> profiles;
+
+            /**
+             * @brief Ranges of the transitions of each profile in {@code transitions}
+             */
+            vector<size_t> transition_offsets;
+
+            vector<LineTransition> transitions;
+
+            /**
+             * @brief Numbers of completions indexed by {@code profile_index * fleet_states_ + fleet_state}
+             */
+            vector<LayoutCount> completions;
+        };
+
+        /**
+         * @brief Legal content of a line reported while enumerating those
+         */
+        struct LineContent {
+
+            uint64_t cells;
+
+            /**
+             * @brief Profile after the line
+             */
+            uint64_t profile;
+
+            /**
+             * @brief Counts of the ships completed by the line indexed by their length
+             */
+            const vector<size_t> &completed_ships;
+        };
+
+        GameConfiguration configuration_;
+
+        /**
+         * @brief Length of the processed lines and the number of those
+         */
+        size_t line_length_, line_count_;
+
+        /**
+         * @brief Whether the lines are the columns of the field
+         */
+        bool transposed_;
+
+        size_t max_ship_length_;
+
+        /**
+         * @brief Number of bits used by a single profile cell
+         */
+        size_t cell_bits_;
+
+        /**
+         * @brief Number of ships of each length indexed by it
+         */
+        vector<size_t> fleet_;
+
+        /**
+         * @brief Weights of the counts of the ships left in the mixed-radix packed counts indexed by the ship length
+         */
+        vector<size_t> count_radices_;
+
+        /**
+         * @brief Number of the possible packed counts of the ships left
+         */
+        size_t fleet_states_;
+
+        size_t initial_fleet_state_;
+
+        /**
+         * @brief Packed counts of the ships left after completing the ships of each kind met by the transitions
+         * indexed by {@code completed_ships * fleet_states_ + fleet_state}, {@code fleet_states_} if there are
+         * not enough ships left
+         */
+        vector<uint32_t> fleet_transitions_;
+
+        /**
+         * @brief Boundaries before each of the lines and after the last one
+         */
+        vector<Boundary> boundaries_;
+
+        [[nodiscard]] inline uint64_t cell_at(const uint64_t &profile, const size_t &index) const noexcept {
+            return (profile >> (index * cell_bits_)) & ((uint64_t(1) << cell_bits_) - 1);
+        }
+
+        [[nodiscard]] inline uint64_t with_cell(const uint64_t &profile, const size_t &index,
+                                                const uint64_t &cell) const noexcept {
+            const auto shift = index * cell_bits_;
+            return (profile & ~(((uint64_t(1) << cell_bits_) - 1) << shift)) | (cell << shift);
+        }
+
+        [[nodiscard]] inline size_t ships_left(const size_t &fleet_state, const size_t &length) const noexcept {
+            return fleet_state / count_radices_[length] % (fleet_[length] + 1);
+        }
+
+        /**
+         * @brief Calls the consumer with each legal content of the line following the profile.
+         *
+         * @param profile profile after the previous line
+         * @param consumer consumer accepting {@link LineContent}
+         */
+        template<typename C>
+        void for_each_line_content(const uint64_t &profile, C &&consumer) const;
+
+        /**
+         * @brief Gets the number of completions of the layout after the transition.
+         */
+        [[nodiscard]] inline LayoutCount completions_after(const size_t &line, const LineTransition &transition,
+                                                           const size_t &fleet_state) const noexcept {
+            const auto next_fleet_state = fleet_transitions_[transition.completed_ships * fleet_states_ + fleet_state];
+            return next_fleet_state == fleet_states_ ? 0 : boundaries_[line + 1].completions[
+                    transition.next_profile * fleet_states_ + next_fleet_state
+            ];
+        }
+
+    public:
+
+        /**
+         * @brief Creates a new sampler counting the layouts of the configuration.
+         *
+         * @param configuration configuration of the game whose layouts are sampled
+         * @throws invalid_argument if the configuration's fleet or field are not supported
+         * @throws runtime_error if the configuration has no legal layouts or too many of those
+         */
+        explicit UniformLayoutSampler(const GameConfiguration &configuration);
+
+        [[nodiscard]] const GameConfiguration &configuration() const noexcept {
+            return configuration_;
+        }
+
+        /**
+         * @brief Gets the number of all the legal layouts of the configuration.
+         *
+         * @return number of layouts
+         */
+        [[nodiscard]] LayoutCount layout_count() const;
+
+        /**
+         * @brief Gets the number of profiles reachable at the line boundaries.
+         *
+         * @return number of profiles
+         */
+        [[nodiscard]] size_t profile_count() const noexcept;
+
+        /**
+         * @brief Samples a layout.
+         *
+         * @param random random engine used for sampling
+         * @param layout bitboard of the field's dimensions to which the ship cells get written
+         */
+        void sample(RandomEngine &random, Bitboard &layout) const;
+
+        /**
+         * @brief Samples a layout.
+         *
+         * @param random random engine used for sampling
+         * @param placements vector to which the placements of the ships get written
+         */
+        void sample(RandomEngine &random, vector<ShipPlacement> &placements) const;
+
+        /**
+         * @brief Places a uniformly sampled fleet at the field.
+         *
+         * @param field field without ships at which the fleet should be placed
+         * @param random random engine used for sampling
+         * @throws runtime_error if the field refuses some ship
+         */
+        void place_ships(GameField *field, RandomEngine &random) const;
+    };
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "battleships/bitboard_game_field.h"
+#include "battleships/chunked_game_field.h"
+#include "battleships/coordinate.h"
+#include "battleships/fixed_game_field.h"
+#include "battleships/game_configuration.h"
+#include "battleships/placement_engine.h"
+#include "battleships/random_engine.h"
+#include "battleships/ship_placement.h"
+#include "battleships/simple_game_field.h"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::function;
+using std::string;
+using std::vector;
+
+using battleships::BitboardGameField;
+using battleships::ChunkedGameField;
+using battleships::ClassicGameField;
+using battleships::Coordinate;
+using battleships::GameConfiguration;
+using battleships::GameField;
+using battleships::PlacementEngine;
+using battleships::RandomEngine;
+using battleships::SimpleGameField;
+
+/**
+ * @brief Options of the benchmark
+ */
+struct BenchmarkOptions {
+    size_t game_count = 100000;
+    uint64_t seed = 1;
+    /**
+     * @brief Width and height of the large field measured with the chunked field, {@code 0} to skip it
+     */
+    size_t large_size = 10000;
+    size_t large_shots = 1000000;
+};
+
+void print_usage() {
+    cerr << "Usage: battleships_field_benchmark [--games N] [--seed S] [--large-size N] [--large-shots N]" << endl;
+}
+
+bool parse_options(const int argc, char **argv, BenchmarkOptions &options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const string option = argv[i], value = argv[i + 1];
+
+        if (option == "--games") options.game_count = std::max<size_t>(1, std::stoul(value));
+        else if (option == "--seed") options.seed = std::stoull(value);
+        else if (option == "--large-size") options.large_size = std::stoul(value);
+        else if (option == "--large-shots") options.large_shots = std::stoul(value);
+        else return false;
+    }
+
+    return argc % 2 == 1;
+}
+
+/**
+ * @brief Runs the action the given number of times and prints the throughput of the operations performed by it.
+ *
+ * @param name name of the measurement
+ * @param unit name of the operations counted
+ * @param repetitions number of times to run the action
+ * @param action action returning the number of the operations it has performed
+ */
+void measure(const string &name, const string &unit, const size_t &repetitions, const function<size_t()> &action) {
+    size_t operations = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; ++i) operations += action();
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(2)
+         << std::setw(10) << double(operations) / elapsed / 1e6 << "M " << unit << "/s" << std::setprecision(0)
+         << std::setw(10) << elapsed * 1e9 / double(operations) << " ns each" << endl;
+}
+
+int main(const int argc, char **argv) {
+    BenchmarkOptions options;
+    try {
+        if (!parse_options(argc, argv, options)) {
+            print_usage();
+            return 1;
+        }
+    } catch (const std::logic_error &) {
+        print_usage();
+        return 1;
+    }
+
+    const auto configuration = GameConfiguration::classic();
+    const PlacementEngine engine(configuration);
+    const auto cell_count = configuration.field_width * configuration.field_height;
+    cout << "Games per measurement: " << options.game_count << " at " << configuration.field_width << 'x'
+         << configuration.field_height << endl;
+
+    // the same orders of the attacks are used for all the fields
+    vector<vector<Coordinate>> attack_orders(64);
+    {
+        RandomEngine random(options.seed);
+        vector<Coordinate> cells;
+        for (size_t y = 0; y < configuration.field_height; ++y)
+            for (size_t x = 0; x < configuration.field_width; ++x)
+                cells.emplace_back(static_cast<int>(x), static_cast<int>(y));
+        for (auto &order : attack_orders) {
+            std::shuffle(cells.begin(), cells.end(), random);
+            order = cells;
+        }
+    }
+
+    const auto measure_field = [&](const string &field_name, GameField *const field) {
+        {
+            RandomEngine random(options.seed);
+            measure(field_name + ", placement", "fleets", options.game_count, [&] {
+                field->reset();
+                engine.place_ships(field, random);
+                return size_t(1);
+            });
+        }
+        {
+            RandomEngine random(options.seed);
+            size_t game = 0;
+            measure(field_name + ", placement and attacks", "games", options.game_count, [&] {
+                field->reset();
+                engine.place_ships(field, random);
+                for (const auto &coordinate : attack_orders[game++ % attack_orders.size()])
+                    if (field->attack(coordinate) == GameField::WIN) break;
+                return size_t(1);
+            });
+        }
+        {
+            RandomEngine random(options.seed);
+            field->reset();
+            engine.place_ships(field, random);
+            measure(field_name + ", placement checks", "checks", options.game_count, [&] {
+                size_t free_cells = 0;
+                for (int x = 0; x < int(configuration.field_width); ++x)
+                    for (int y = 0; y < int(configuration.field_height); ++y)
+                        free_cells += field->can_place_at(Coordinate(x, y));
+                // keeps the checks from being optimized out
+                return cell_count + (free_cells > cell_count);
+            });
+        }
+    };
+    SimpleGameField simple_field(configuration);
+    measure_field("simple field", &simple_field);
+    BitboardGameField bitboard_field(configuration);
+    measure_field("bitboard field", &bitboard_field);
+    ClassicGameField fixed_field(configuration);
+    measure_field("fixed field", &fixed_field);
+
+    if (options.large_size != 0) {
+        // the classic fleet at a field so large that only the chunked field's memory does not grow with its area
+        auto large_configuration = configuration;
+        large_configuration.field_width = large_configuration.field_height = options.large_size;
+        cout << "Large field: " << options.large_size << 'x' << options.large_size << ", "
+             << options.large_shots << " random shots" << endl;
+
+        ChunkedGameField field(large_configuration);
+        RandomEngine random(options.seed);
+        measure("chunked field, placement", "ships", 1, [&] {
+            size_t ship_count = 0;
+            for (auto ships = large_configuration.ships.rbegin(); ships != large_configuration.ships.rend(); ++ships)
+                for (size_t i = 0; i < ships->second; ++i, ++ship_count)
+                    battleships::place_ship_randomly(&field, ships->first, random);
+            return ship_count;
+        });
+        measure("chunked field, random attacks", "shots", 1, [&] {
+            size_t shots = 0;
+            while (shots < options.large_shots && field.count_not_visited() != 0) {
+                ++shots;
+                if (field.attack(field.random_not_visited_spot(random)) == GameField::WIN) break;
+            }
+            return shots;
+        });
+        cout << "Chunks stored: " << field.chunk_count() << " taking "
+             << field.chunk_count() * ChunkedGameField::CHUNK_BYTES / 1024 << " KiB" << endl;
+    }
+
+    return 0;
+}
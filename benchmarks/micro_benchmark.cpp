@@ -0,0 +1,664 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "battleships/bitboard_game_field.h"
+#include "battleships/chunked_game_field.h"
+#include "battleships/console_renderer.h"
+#include "battleships/fixed_game_field.h"
+#include "battleships/game_configuration.h"
+#include "battleships/game_field_snapshot.h"
+#include "battleships/game_field_factory.h"
+#include "battleships/placement_engine.h"
+#include "battleships/random_engine.h"
+#include "battleships/ship_placement.h"
+#include "battleships/simple_game.h"
+#include "battleships/simple_game_pool.h"
+#include "battleships/simple_game_field.h"
+#include "battleships/simple_rival_bot.h"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::function;
+using std::pair;
+using std::runtime_error;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+using battleships::BitboardGameField;
+using battleships::ChunkedGameField;
+using battleships::ClassicGameField;
+using battleships::ConsoleRenderer;
+using battleships::Coordinate;
+using battleships::GameConfiguration;
+using battleships::GameField;
+using battleships::GameFieldFactory;
+using battleships::PlacementEngine;
+using battleships::RandomEngine;
+using battleships::SimpleGame;
+using battleships::SimpleGamePool;
+using battleships::SimpleGameField;
+using battleships::SimpleRivalBot;
+using battleships::TypedGameFieldFactory;
+
+using Clock = std::chrono::steady_clock;
+
+/*
+ * Allocation counting
+ */
+
+/**
+ * @brief Number of the allocations made by the process, the benchmarks are run by a single thread
+ */
+size_t allocation_count = 0;
+
+void *operator new(const size_t size) {
+    ++allocation_count;
+    if (const auto pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *const pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *const pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+/*
+ * Options
+ */
+
+/**
+ * @brief Options of the benchmark suite
+ */
+struct BenchmarkOptions {
+    size_t trial_count = 10;
+    /**
+     * @brief Minimal duration of each trial
+     */
+    std::chrono::milliseconds trial_duration{20};
+    /**
+     * @brief Substring of the names of the benchmarks to run, all of those are run if it is empty
+     */
+    string filter;
+    string field = "simple";
+    const GameFieldFactory *field_factory = TypedGameFieldFactory<SimpleGameField>::instance();
+    /**
+     * @brief Path of the baseline to compare the results with if not empty
+     */
+    string baseline_path;
+    /**
+     * @brief Path to save the results as the new baseline to if not empty
+     */
+    string save_baseline_path;
+    /**
+     * @brief Slowdown of the fastest trial relatively to the baseline's one
+     * above which the benchmark is considered to have regressed
+     */
+    double threshold = 0.1;
+};
+
+void print_usage() {
+    cerr << "Usage: battleships_micro_benchmark [--trials N] [--trial-ms MS] [--filter TEXT]"
+            " [--field simple|bitboard|fixed|chunked] [--baseline PATH] [--save-baseline PATH]"
+            " [--threshold PERCENT]" << endl
+         << "Exits with 2 if some benchmark has regressed compared to the baseline" << endl;
+}
+
+bool parse_options(const int argc, char **argv, BenchmarkOptions &options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const string option = argv[i], value = argv[i + 1];
+
+        if (option == "--trials") options.trial_count = std::max<size_t>(2, std::stoul(value));
+        else if (option == "--trial-ms") options.trial_duration = std::chrono::milliseconds(std::stoul(value));
+        else if (option == "--filter") options.filter = value;
+        else if (option == "--field") {
+            if (value == "simple") options.field_factory = TypedGameFieldFactory<SimpleGameField>::instance();
+            else if (value == "bitboard") options.field_factory = TypedGameFieldFactory<BitboardGameField>::instance();
+            else if (value == "fixed") options.field_factory = TypedGameFieldFactory<ClassicGameField>::instance();
+            else if (value == "chunked") options.field_factory = TypedGameFieldFactory<ChunkedGameField>::instance();
+            else return false;
+            options.field = value;
+        } else if (option == "--baseline") options.baseline_path = value;
+        else if (option == "--save-baseline") options.save_baseline_path = value;
+        else if (option == "--threshold") options.threshold = std::stod(value) / 100;
+        else return false;
+    }
+
+    return argc % 2 == 1;
+}
+
+/*
+ * Harness
+ */
+
+/**
+ * @brief Timer of a batch of operations which only counts the time and the allocations while it is resumed,
+ * so that the preparation of the operations is not measured.
+ */
+class BatchTimer {
+
+    Clock::duration elapsed_{};
+
+    size_t allocations_ = 0;
+
+    Clock::time_point started_;
+
+    size_t allocations_at_start_ = 0;
+
+public:
+
+    inline void resume() noexcept {
+        allocations_at_start_ = allocation_count;
+        started_ = Clock::now();
+    }
+
+    inline void pause() noexcept {
+        elapsed_ += Clock::now() - started_;
+        allocations_ += allocation_count - allocations_at_start_;
+    }
+
+    [[nodiscard]] inline Clock::duration elapsed() const noexcept {
+        return elapsed_;
+    }
+
+    [[nodiscard]] inline size_t allocations() const noexcept {
+        return allocations_;
+    }
+};
+
+/**
+ * @brief Benchmark of a single operation
+ */
+struct Benchmark {
+    string name;
+    /**
+     * @brief Function performing a batch of the operations which only keeps the timer resumed while performing those
+     * and returns their number
+     */
+    function<size_t(BatchTimer &)> run_batch;
+};
+
+struct BenchmarkResult {
+    string name;
+    double ns_per_op = 0, stddev_ns = 0, min_ns = 0, allocations_per_op = 0;
+};
+
+/**
+ * @brief Runs the trials of the benchmark each performing its batches until the trial's duration is reached.
+ */
+[[nodiscard]] BenchmarkResult run_benchmark(const BenchmarkOptions &options, const Benchmark &benchmark) {
+    vector<double> ns_per_op;
+    double allocations_per_op = 0;
+    // the first trial warms the caches up and is not counted
+    for (size_t trial = 0; trial <= options.trial_count; ++trial) {
+        BatchTimer timer;
+        size_t operations = 0;
+        while (timer.elapsed() < options.trial_duration) operations += benchmark.run_batch(timer);
+
+        if (trial == 0) continue;
+        ns_per_op.push_back(double(std::chrono::duration_cast<std::chrono::nanoseconds>(timer.elapsed()).count())
+                            / double(operations));
+        allocations_per_op = double(timer.allocations()) / double(operations);
+    }
+
+    BenchmarkResult result{benchmark.name};
+    for (const auto value : ns_per_op) result.ns_per_op += value / double(ns_per_op.size());
+    for (const auto value : ns_per_op)
+        result.stddev_ns += (value - result.ns_per_op) * (value - result.ns_per_op) / double(ns_per_op.size() - 1);
+    result.stddev_ns = std::sqrt(result.stddev_ns);
+    result.min_ns = *std::min_element(ns_per_op.begin(), ns_per_op.end());
+    result.allocations_per_op = allocations_per_op;
+
+    return result;
+}
+
+/*
+ * Baseline
+ */
+
+/**
+ * @brief Value of the JSON document limited to what the baselines use: objects, strings and numbers
+ */
+struct JsonValue {
+    double number = 0;
+    string text;
+    vector<pair<string, JsonValue>> members;
+
+    [[nodiscard]] const JsonValue *find(const string &key) const {
+        for (const auto &member : members) if (member.first == key) return &member.second;
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Parser of the JSON documents throwing {@code runtime_error} on malformed ones
+ */
+class JsonParser {
+
+    const string &text_;
+
+    size_t position_ = 0;
+
+    void skip_whitespace() {
+        while (position_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[position_]))) ++position_;
+    }
+
+    [[noreturn]] void fail(const string &expected) const {
+        throw runtime_error("Malformed JSON at " + std::to_string(position_) + ": expected " + expected);
+    }
+
+    void expect(const char &character) {
+        skip_whitespace();
+        if (position_ == text_.size() || text_[position_] != character) fail(string(1, character));
+        ++position_;
+    }
+
+    [[nodiscard]] string parse_string() {
+        expect('"');
+        string value;
+        while (position_ < text_.size() && text_[position_] != '"') {
+            if (text_[position_] == '\\' && ++position_ == text_.size()) break;
+            value += text_[position_++];
+        }
+        expect('"');
+
+        return value;
+    }
+
+public:
+
+    explicit JsonParser(const string &text) : text_(text) {}
+
+    [[nodiscard]] JsonValue parse_value() {
+        skip_whitespace();
+        if (position_ == text_.size()) fail("value");
+
+        JsonValue value;
+        const auto first = text_[position_];
+        if (first == '{') {
+            ++position_;
+            skip_whitespace();
+            if (position_ < text_.size() && text_[position_] == '}') {
+                ++position_;
+                return value;
+            }
+            do {
+                auto key = parse_string();
+                expect(':');
+                value.members.emplace_back(std::move(key), parse_value());
+                skip_whitespace();
+            } while (position_ < text_.size() && text_[position_] == ',' && ++position_);
+            expect('}');
+        } else if (first == '"') value.text = parse_string();
+        else {
+            size_t length;
+            try {
+                value.number = std::stod(text_.substr(position_, 32), &length);
+            } catch (const std::logic_error &) {
+                fail("number");
+            }
+            position_ += length;
+        }
+
+        return value;
+    }
+
+    [[nodiscard]] JsonValue parse_document() {
+        auto value = parse_value();
+        skip_whitespace();
+        if (position_ != text_.size()) fail("end of the document");
+
+        return value;
+    }
+};
+
+void save_baseline(const BenchmarkOptions &options, const vector<BenchmarkResult> &results) {
+    std::ofstream out(options.save_baseline_path);
+    out << std::setprecision(6) << "{\n  \"field\": \"" << options.field << "\",\n  \"benchmarks\": {\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto &result = results[i];
+        out << "    \"" << result.name << "\": {\"ns_per_op\": " << result.ns_per_op
+            << ", \"stddev_ns\": " << result.stddev_ns << ", \"min_ns\": " << result.min_ns
+            << ", \"allocations_per_op\": " << result.allocations_per_op << '}'
+            << (i + 1 == results.size() ? "\n" : ",\n");
+    }
+    out << "  }\n}\n";
+
+    if (!out) throw runtime_error("Cannot write the baseline to " + options.save_baseline_path);
+}
+
+[[nodiscard]] JsonValue load_baseline(const string &path) {
+    std::ifstream in(path);
+    if (!in) throw runtime_error("Cannot read the baseline " + path);
+
+    std::stringstream text;
+    text << in.rdbuf();
+    auto baseline = JsonParser(text.str()).parse_document();
+    if (!baseline.find("benchmarks")) throw runtime_error("Baseline " + path + " has no benchmarks");
+
+    return baseline;
+}
+
+/*
+ * Benchmarks
+ */
+
+/**
+ * @brief Stream buffer discarding everything written to it
+ */
+class NullBuffer : public std::streambuf {
+
+protected:
+
+    int_type overflow(const int_type character) override {
+        return traits_type::not_eof(character);
+    }
+
+    std::streamsize xsputn(const char *, const std::streamsize count) override {
+        return count;
+    }
+};
+
+/**
+ * @brief Cells of the ships placed at the field split by their role in the attack benchmarks
+ */
+struct FleetCells {
+    vector<Coordinate> empty;
+    /**
+     * @brief All cells of the ships but their last ones, attacking those only damages the ships
+     */
+    vector<Coordinate> damaging;
+    /**
+     * @brief Last cells of the ships, attacking those once the others are hit sinks the ships
+     */
+    vector<Coordinate> sinking;
+};
+
+[[nodiscard]] FleetCells fleet_cells_of(const GameField *const field) {
+    const auto configuration = field->get_configuration();
+    FleetCells cells;
+    vector<bool> occupied(configuration.field_width * configuration.field_height, false);
+    for (const auto &ship : field->get_ships()) {
+        for (size_t i = 0; i < ship.size; ++i) {
+            const auto cell = ship.cell(i);
+            occupied[cell.y * configuration.field_width + cell.x] = true;
+            (i + 1 == ship.size ? cells.sinking : cells.damaging).push_back(cell);
+        }
+    }
+    for (size_t y = 0; y < configuration.field_height; ++y)
+        for (size_t x = 0; x < configuration.field_width; ++x)
+            if (!occupied[y * configuration.field_width + x])
+                cells.empty.emplace_back(static_cast<int>(x), static_cast<int>(y));
+
+    return cells;
+}
+
+/**
+ * @brief Checks that the benchmarked operation has done what it is expected to.
+ *
+ * @throws runtime_error if it has not
+ */
+void check(const bool &condition, const char *const expectation) {
+    if (!condition) throw runtime_error(string("Benchmarked operation failed: ") + expectation);
+}
+
+[[nodiscard]] vector<Benchmark> create_benchmarks(const BenchmarkOptions &options,
+                                                  const GameConfiguration &configuration) {
+    const auto factory = options.field_factory;
+    // the state is shared by the benchmarks' batches and is only used by a single one at a time
+    const auto field = std::shared_ptr<GameField>(factory->create(configuration));
+    const auto rival_field = std::shared_ptr<GameField>(factory->create(configuration));
+    const auto random = std::make_shared<RandomEngine>(1);
+    const auto engine = std::make_shared<const PlacementEngine>(configuration);
+
+    // places a new fleet at the field outside of the measured time
+    const auto prepare_fleet = [=] {
+        field->reset();
+        engine->place_ships(field.get(), *random);
+        return fleet_cells_of(field.get());
+    };
+
+    return {
+            {"field_construct_destroy", [=](BatchTimer &timer) {
+                constexpr size_t COUNT = 16;
+                timer.resume();
+                for (size_t i = 0; i < COUNT; ++i) delete factory->create(configuration);
+                timer.pause();
+                return COUNT;
+            }},
+            {"field_reset", [=](BatchTimer &timer) {
+                constexpr size_t COUNT = 16;
+                timer.resume();
+                for (size_t i = 0; i < COUNT; ++i) field->reset();
+                timer.pause();
+                return COUNT;
+            }},
+            {"game_pool_acquire", [=](BatchTimer &timer) {
+                constexpr size_t COUNT = 16;
+                static SimpleGamePool games(configuration, factory);
+                timer.resume();
+                for (size_t i = 0; i < COUNT; ++i) check(games.acquire()->field_1()->count_not_visited() != 0,
+                                                          "acquired game is reset");
+                timer.pause();
+                return COUNT;
+            }},
+            {"field_attack_miss", [=](BatchTimer &timer) {
+                const auto cells = prepare_fleet();
+                timer.resume();
+                for (const auto &cell : cells.empty) check(field->attack(cell) == GameField::MISS, "attack misses");
+                timer.pause();
+                return cells.empty.size();
+            }},
+            {"field_attack_batch_miss", [=](BatchTimer &timer) {
+                const auto cells = prepare_fleet();
+                vector<GameField::AttackStatus> statuses(cells.empty.size());
+                timer.resume();
+                field->attack_batch(cells.empty, statuses);
+                timer.pause();
+                check(std::all_of(statuses.begin(), statuses.end(), [](const GameField::AttackStatus &status) {
+                    return status == GameField::MISS;
+                }), "batch attack misses");
+                return cells.empty.size();
+            }},
+            {"field_attack_hit", [=](BatchTimer &timer) {
+                const auto cells = prepare_fleet();
+                timer.resume();
+                for (const auto &cell : cells.damaging)
+                    check(field->attack(cell) == GameField::DAMAGE_SHIP, "attack damages the ship");
+                timer.pause();
+                return cells.damaging.size();
+            }},
+            {"field_attack_sink", [=](BatchTimer &timer) {
+                const auto cells = prepare_fleet();
+                for (const auto &cell : cells.damaging) static_cast<void>(field->attack(cell));
+                timer.resume();
+                for (const auto &cell : cells.sinking) {
+                    const auto status = field->attack(cell);
+                    check(status == GameField::DESTROY_SHIP || status == GameField::WIN, "attack sinks the ship");
+                }
+                timer.pause();
+                return cells.sinking.size();
+            }},
+            {"field_attack_rollback", [=](BatchTimer &timer) {
+                const auto cells = prepare_fleet();
+                for (const auto &cell : cells.damaging) static_cast<void>(field->attack(cell));
+                timer.resume();
+                // each sinking attack is tried and rolled back so the ships stay afloat
+                for (const auto &cell : cells.sinking) {
+                    field->push_checkpoint();
+                    const auto status = field->attack(cell);
+                    field->rollback();
+                    check(status == GameField::DESTROY_SHIP || status == GameField::WIN, "attack sinks the ship");
+                }
+                timer.pause();
+                check(!field->is_discovered(cells.sinking.front()), "attack is rolled back");
+                return cells.sinking.size();
+            }},
+            {"field_can_place_at", [=](BatchTimer &timer) {
+                static_cast<void>(prepare_fleet());
+                size_t free_cells = 0;
+                timer.resume();
+                for (int x = 0; x < int(configuration.field_width); ++x)
+                    for (int y = 0; y < int(configuration.field_height); ++y)
+                        free_cells += field->can_place_at(Coordinate(x, y));
+                timer.pause();
+                check(free_cells < configuration.field_width * configuration.field_height, "ships block some cells");
+                return configuration.field_width * configuration.field_height;
+            }},
+            {"field_snapshot", [=](BatchTimer &timer) {
+                constexpr size_t COUNT = 16;
+                static_cast<void>(prepare_fleet());
+                timer.resume();
+                for (size_t i = 0; i < COUNT; ++i) check(field->snapshot() != nullptr, "snapshot is taken");
+                timer.pause();
+                return COUNT;
+            }},
+            {"field_fork", [=](BatchTimer &timer) {
+                constexpr size_t COUNT = 16;
+                static_cast<void>(prepare_fleet());
+                const auto snapshot = field->snapshot();
+                timer.resume();
+                for (size_t i = 0; i < COUNT; ++i) check(snapshot->fork() != nullptr, "field is forked");
+                timer.pause();
+                return COUNT;
+            }},
+            {"field_place_ships", [=](BatchTimer &timer) {
+                field->reset();
+                timer.resume();
+                battleships::place_ships_randomly(field.get(), *random);
+                timer.pause();
+                return size_t(1);
+            }},
+            {"simple_bot_game", [=](BatchTimer &timer) {
+                field->reset();
+                rival_field->reset();
+                engine->place_ships(rival_field.get(), *random);
+                SimpleRivalBot bot(field.get(), rival_field.get(), (*random)());
+                timer.resume();
+                while (!bot.act(nullptr)) {}
+                timer.pause();
+                return size_t(1);
+            }},
+            {"render_game", [=](BatchTimer &timer) {
+                static NullBuffer null_buffer;
+                static std::ostream null_stream(&null_buffer);
+                static SimpleGame game(configuration, factory);
+                static ConsoleRenderer renderer(null_stream);
+                static const auto prepared = [&] {
+                    engine->place_ships(game.field_1(), *random);
+                    engine->place_ships(game.field_2(), *random);
+                    for (int i = 0; i < 30; ++i)
+                        static_cast<void>(game.field_2()->attack(game.field_2()->random_not_visited_spot(*random)));
+                    return true;
+                }();
+                static_cast<void>(prepared);
+
+                timer.resume();
+                renderer.invalidate();
+                renderer.present(game);
+                timer.pause();
+                return size_t(1);
+            }},
+    };
+}
+
+int main(const int argc, char **argv) {
+    BenchmarkOptions options;
+    try {
+        if (!parse_options(argc, argv, options)) {
+            print_usage();
+            return 1;
+        }
+    } catch (const std::logic_error &) {
+        print_usage();
+        return 1;
+    }
+
+    try {
+        const auto baseline = options.baseline_path.empty() ? JsonValue() : load_baseline(options.baseline_path);
+        const auto baseline_benchmarks = baseline.find("benchmarks");
+        if (baseline_benchmarks) {
+            const auto baseline_field = baseline.find("field");
+            if (baseline_field && baseline_field->text != options.field)
+                cerr << "The baseline has been measured with the " << baseline_field->text << " field" << endl;
+        }
+
+        const auto configuration = GameConfiguration::classic();
+        cout << "Field: " << options.field << ", " << options.trial_count << " trial(s) of at least "
+             << options.trial_duration.count() << " ms each" << endl
+             << std::left << std::setw(26) << "benchmark" << std::right << std::setw(12) << "ns/op"
+             << std::setw(10) << "stddev" << std::setw(12) << "min ns/op" << std::setw(11) << "allocs/op";
+        if (baseline_benchmarks) cout << std::setw(14) << "baseline min" << std::setw(9) << "change";
+        cout << endl;
+
+        vector<BenchmarkResult> results;
+        size_t regressions = 0;
+        for (const auto &benchmark : create_benchmarks(options, configuration)) {
+            if (benchmark.name.find(options.filter) == string::npos) continue;
+
+            const auto result = run_benchmark(options, benchmark);
+            results.push_back(result);
+            cout << std::left << std::setw(26) << result.name << std::right << std::fixed << std::setprecision(1)
+                 << std::setw(12) << result.ns_per_op
+                 << std::setw(9) << 100 * result.stddev_ns / result.ns_per_op << '%'
+                 << std::setw(12) << result.min_ns << std::setprecision(2) << std::setw(11)
+                 << result.allocations_per_op;
+
+            if (baseline_benchmarks) {
+                const auto previous = baseline_benchmarks->find(result.name);
+                // the fastest trial is the least affected by the noise of the machine so it is the one compared
+                const auto previous_ns = previous ? previous->find("min_ns") : nullptr;
+                const auto previous_allocations = previous ? previous->find("allocations_per_op") : nullptr;
+                if (!previous_ns) cout << std::setw(14) << '-' << std::setw(9) << "new";
+                else {
+                    const auto change = result.min_ns / previous_ns->number - 1;
+                    // the allocations do not depend on the timing so any growth of those is a regression
+                    const auto regressed = change > options.threshold
+                                           || (previous_allocations
+                                               && result.allocations_per_op > previous_allocations->number + 1e-6);
+                    cout << std::setprecision(1) << std::setw(14) << previous_ns->number << std::showpos
+                         << std::setw(8) << 100 * change << '%' << std::noshowpos;
+                    if (regressed) {
+                        cout << "  REGRESSION";
+                        ++regressions;
+                    }
+                }
+            }
+            cout << endl;
+        }
+
+        if (!options.save_baseline_path.empty()) {
+            save_baseline(options, results);
+            cout << "Saved the baseline to " << options.save_baseline_path << endl;
+        }
+        if (regressions != 0) {
+            cout << regressions << " benchmark(s) regressed by more than " << 100 * options.threshold
+                 << "% or allocate more than the baseline" << endl;
+            return 2;
+        }
+    } catch (const std::runtime_error &error) {
+        cerr << error.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "battleships/bitboard_game_field.h"
+#include "battleships/game_configuration.h"
+#include "battleships/placement_engine.h"
+#include "battleships/random_engine.h"
+#include "battleships/ship_placement.h"
+#include "battleships/simple_game_field.h"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::function;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+using battleships::BitboardGameField;
+using battleships::GameConfiguration;
+using battleships::GameField;
+using battleships::PlacementEngine;
+using battleships::RandomEngine;
+using battleships::ShipPlacement;
+using battleships::SimpleGameField;
+
+/**
+ * @brief Options of the benchmark
+ */
+struct BenchmarkOptions {
+    size_t fleet_count = 200000;
+    uint64_t seed = 1;
+};
+
+void print_usage() {
+    cerr << "Usage: battleships_placement_benchmark [--fleets N] [--seed S]" << endl;
+}
+
+bool parse_options(const int argc, char **argv, BenchmarkOptions &options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const string option = argv[i], value = argv[i + 1];
+
+        if (option == "--fleets") options.fleet_count = std::max<size_t>(1, std::stoul(value));
+        else if (option == "--seed") options.seed = std::stoull(value);
+        else return false;
+    }
+
+    return argc % 2 == 1;
+}
+
+/**
+ * @brief Places the fleet ship by ship using the scanning placement.
+ */
+void place_ships_by_scanning(GameField *const field, RandomEngine &random) {
+    const auto ships = field->get_configuration().ships;
+    for (auto iterator = ships.rbegin(); iterator != ships.rend(); ++iterator)
+        for (size_t shipId = 0; shipId < iterator->second; ++shipId)
+            battleships::place_ship_randomly(field, iterator->first, random);
+}
+
+/**
+ * @brief Runs the action the given number of times and prints its throughput.
+ */
+void measure(const string &name, const size_t &fleet_count, const function<void()> &action) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < fleet_count; ++i) action();
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(0)
+         << std::setw(12) << double(fleet_count) / elapsed << " fleets/s" << std::setprecision(3)
+         << std::setw(10) << elapsed * 1e6 / double(fleet_count) << " us/fleet" << endl;
+}
+
+int main(const int argc, char **argv) {
+    BenchmarkOptions options;
+    try {
+        if (!parse_options(argc, argv, options)) {
+            print_usage();
+            return 1;
+        }
+    } catch (const std::logic_error &) {
+        print_usage();
+        return 1;
+    }
+
+    const auto configuration = GameConfiguration::classic();
+    const PlacementEngine engine(configuration);
+    cout << "Fleets per measurement: " << options.fleet_count << endl;
+
+    {
+        RandomEngine random(options.seed);
+        vector<ShipPlacement> placements;
+        measure("engine (layout only)", options.fleet_count, [&] { engine.generate(random, placements); });
+    }
+
+    const auto measure_field = [&](const string &field_name, GameField *const field) {
+        RandomEngine random(options.seed);
+        measure("scanning, " + field_name, options.fleet_count, [&] {
+            field->reset();
+            place_ships_by_scanning(field, random);
+        });
+        measure("engine, " + field_name, options.fleet_count, [&] {
+            field->reset();
+            engine.place_ships(field, random);
+        });
+    };
+    SimpleGameField simple_field(configuration);
+    measure_field("simple field", &simple_field);
+    BitboardGameField bitboard_field(configuration);
+    measure_field("bitboard field", &bitboard_field);
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "battleships/bitboard.h"
+#include "battleships/game_configuration.h"
+#include "battleships/layout_corpus.h"
+#include "battleships/random_engine.h"
+#include "battleships/uniform_layout_sampler.h"
+
+using std::atomic;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::mutex;
+using std::ofstream;
+using std::string;
+using std::thread;
+using std::vector;
+
+using battleships::Bitboard;
+using battleships::GameConfiguration;
+using battleships::LayoutCorpusHeader;
+using battleships::RandomEngine;
+using battleships::UniformLayoutSampler;
+
+/**
+ * @brief Number of layouts generated from a single seed, chunks are what gets distributed between the workers
+ */
+constexpr uint64_t LAYOUTS_PER_CHUNK = 1u << 16u;
+
+/**
+ * @brief Options of the generation
+ */
+struct GenerationOptions {
+    uint64_t layout_count = 1000000;
+    size_t thread_count = std::max(1u, thread::hardware_concurrency());
+    /**
+     * @brief Base seed from which the seeds of all chunks are derived
+     */
+    uint64_t seed = battleships::random_seed();
+    string output;
+    /**
+     * @brief Configuration whose fleet the layouts are drawn for
+     */
+    GameConfiguration configuration = GameConfiguration::classic();
+};
+
+void print_usage() {
+    cerr << "Usage: battleships_layout_generator --output FILE [--configuration SPEC] [--layouts N] [--threads N]"
+            " [--seed S]" << endl
+         << "The configuration is either 'classic' or 'WIDTHxHEIGHT:LENGTH*COUNT,...' (e.g. '8x8:1*3,2*2,3*1')" << endl;
+}
+
+bool parse_options(const int argc, char **argv, GenerationOptions &options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const string option = argv[i], value = argv[i + 1];
+
+        if (option == "--layouts") options.layout_count = std::stoull(value);
+        else if (option == "--threads") options.thread_count = std::max<size_t>(1, std::stoul(value));
+        else if (option == "--seed") options.seed = std::stoull(value);
+        else if (option == "--output") options.output = value;
+        else if (option == "--configuration") options.configuration = GameConfiguration::parse(value);
+        else return false;
+    }
+
+    return argc % 2 == 1 && !options.output.empty();
+}
+
+/**
+ * @brief Generates the chunks claimed by this worker writing each one at its place in the file.
+ */
+void generate(const GenerationOptions &options, const UniformLayoutSampler &sampler, const LayoutCorpusHeader &header,
+              atomic<uint64_t> &next_chunk, ofstream &out, mutex &out_mutex) {
+    const auto &configuration = sampler.configuration();
+    const auto layout_size = header.layout_size();
+    const auto chunk_count = (options.layout_count + LAYOUTS_PER_CHUNK - 1) / LAYOUTS_PER_CHUNK;
+
+    Bitboard layout(configuration.field_width, configuration.field_height);
+    vector<uint8_t> buffer(LAYOUTS_PER_CHUNK * layout_size);
+    while (true) {
+        const auto chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= chunk_count) break;
+
+        // each chunk has its own seed so the file does not depend on the number of workers
+        RandomEngine random(battleships::derive_seed(options.seed, chunk));
+        const auto first_layout = chunk * LAYOUTS_PER_CHUNK,
+                layouts = std::min(LAYOUTS_PER_CHUNK, options.layout_count - first_layout);
+        for (uint64_t i = 0; i < layouts; ++i) {
+            sampler.sample(random, layout);
+            battleships::pack_layout(layout, buffer.data() + i * layout_size);
+        }
+
+        std::lock_guard<mutex> lock(out_mutex);
+        out.seekp(std::streamoff(header.size() + first_layout * layout_size));
+        out.write(reinterpret_cast<const char *>(buffer.data()), std::streamsize(layouts * layout_size));
+    }
+}
+
+int main(const int argc, char **argv) {
+    GenerationOptions options;
+    try {
+        if (!parse_options(argc, argv, options)) {
+            print_usage();
+            return 1;
+        }
+    } catch (const std::logic_error &) {
+        print_usage();
+        return 1;
+    }
+    const auto &configuration = options.configuration;
+
+    const auto counting_start = std::chrono::steady_clock::now();
+    const UniformLayoutSampler sampler(configuration);
+    const std::chrono::duration<double> counting_elapsed = std::chrono::steady_clock::now() - counting_start;
+
+    cout << std::fixed << std::setprecision(2)
+         << "Legal layouts: " << battleships::layout_count_to_string(sampler.layout_count())
+         << " (counted in " << counting_elapsed.count() << " s)" << endl
+         << "Seed: " << options.seed << endl;
+
+    const auto header = LayoutCorpusHeader::of(configuration, options.layout_count, options.seed);
+
+    ofstream out(options.output, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        cerr << "Unable to open " << options.output << endl;
+        return 1;
+    }
+    header.write_to(out);
+
+    atomic<uint64_t> next_chunk(0);
+    mutex out_mutex;
+    const auto start = std::chrono::steady_clock::now();
+    {
+        vector<thread> workers;
+        workers.reserve(options.thread_count);
+        for (size_t i = 0; i < options.thread_count; ++i) workers.emplace_back(
+                generate, std::cref(options), std::cref(sampler), std::cref(header),
+                std::ref(next_chunk), std::ref(out), std::ref(out_mutex)
+        );
+        for (auto &worker : workers) worker.join();
+    }
+    out.close();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (!out) {
+        cerr << "Unable to write " << options.output << endl;
+        return 1;
+    }
+
+    cout << "Layouts written: " << options.layout_count << " (" << header.layout_size() << " bytes each) to "
+         << options.output << " on " << options.thread_count << " thread(s)" << endl
+         << "Elapsed: " << elapsed.count() << " s" << endl
+         << "Throughput: " << double(options.layout_count) / elapsed.count() << " layouts/s" << endl;
+
+    return 0;
+}
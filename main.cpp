@@ -1,8 +1,12 @@
 #include "battleships/simple_game_field.h"
 
+#include <algorithm>
+#include <cctype>
 #include <string>
+#include <vector>
 
 #include "util/cli_util.h"
+#include "battleships/console_renderer.h"
 #include "battleships/coordinate.h"
 #include "battleships/game_configuration.h"
 #include "battleships/simple_game.h"
@@ -11,9 +15,10 @@
 using std::cin;
 using std::cout;
 using std::endl;
-using std::pair;
 using std::string;
+using std::vector;
 
+using battleships::ConsoleRenderer;
 using battleships::Coordinate;
 using battleships::Direction;
 using battleships::GameConfiguration;
@@ -24,23 +29,22 @@ using battleships::SimpleRivalBot;
 using battleships::RivalBot;
 
 Coordinate read_coordinate_safely(const size_t &width, const size_t &height) {
-    size_t x, y;
-    do {
-        char x_char;
-        cin >> x_char;
-        x = x_char - 'A';
-        cin >> y;
-    } while ((x < 0 || x >= width) || (y < 0 || y >= height));
-
-    return Coordinate(x, y);
+    while (true) {
+        string text, row;
+        if (!(cin >> text)) throw runtime_error("Input has ended");
+        // the column and the row may also be entered separately
+        const auto is_column = std::all_of(text.begin(), text.end(), [](const char &c) {
+            return std::isalpha(static_cast<unsigned char>(c)) != 0;
+        });
+        if (is_column && cin >> row) text += row;
+
+        const auto coordinate = Coordinate::parse(text);
+        if (coordinate && size_t(coordinate->x) < width && size_t(coordinate->y) < height) return *coordinate;
+    }
 }
 
 GameConfiguration default_game_configuration() {
-    GameConfiguration configuration(10, 10, 4);
-
-    for (size_t i = 1; i <= 4; i++) configuration.ships.insert(pair(i, 4 - i + 1));
-
-    return configuration;
+    return GameConfiguration::classic();
 }
 
 void read_player_field(GameField *const game_field) {
@@ -100,9 +104,11 @@ bool play_against_real_rival() {
     read_player_field(game.field_2());
     cli::clear();
 
+    // only the changed cells get redrawn after each shot
+    ConsoleRenderer renderer;
     bool first_player_turn = true;
     while (true) {
-        game.print_to_console();
+        renderer.present(game);
 
         cout << (first_player_turn ? "<< Player 1 >>" : "<< Player 2 >>") << endl;
 
@@ -115,23 +121,23 @@ bool play_against_real_rival() {
                     continue;
                 }
                 case GameField::MISS: {
-                    game.print_to_console();
-                    cout << "> Player " << (first_player_turn ? "1" : "2") << " missed" << endl;
+                    renderer.log(string("> Player ") + (first_player_turn ? "1" : "2") + " missed");
+                    renderer.present(game);
                     break;
                 }
                 case GameField::DAMAGE_SHIP: {
-                    game.print_to_console();
-                    cout << "> Player " << (first_player_turn ? "1" : "2") << " has hit a ship!" << endl;
+                    renderer.log(string("> Player ") + (first_player_turn ? "1" : "2") + " has hit a ship!");
+                    renderer.present(game);
                     continue;
                 }
                 case GameField::DESTROY_SHIP: {
-                    game.print_to_console();
-                    cout << "> Player " << (first_player_turn ? "1" : "2") << " has destroyed a ship!" << endl;
+                    renderer.log(string("> Player ") + (first_player_turn ? "1" : "2") + " has destroyed a ship!");
+                    renderer.present(game);
                     continue;
                 }
                 case GameField::WIN: {
-                    game.print_to_console();
-                    cout << "> Player " << (first_player_turn ? "1" : "2") << " has won this game!" << endl;
+                    renderer.log(string("> Player ") + (first_player_turn ? "1" : "2") + " has won this game!");
+                    renderer.present(game);
                     return first_player_turn;
                 }
                 default:
@@ -144,7 +150,125 @@ bool play_against_real_rival() {
     }
 }
 
-bool play_against_bot_rival() {
+/**
+ * @brief Attack callback presenting the shots of the bot to the player
+ */
+class BotAttackCallback : public RivalBot::AttackCallback {
+    Game *game_;
+    ConsoleRenderer *renderer_;
+    /**
+     * @brief Whether the bot fires salvos whose shots may land at the cells discovered by the previous ones
+     */
+    bool salvo_;
+public:
+    explicit BotAttackCallback(Game *game, ConsoleRenderer *renderer, const bool &salvo)
+            : game_(game), renderer_(renderer), salvo_(salvo) {}
+
+    void on_attack(const Coordinate &coordinate, const GameField::AttackStatus &attack_status) override {
+        renderer_->log("> Bot attacks " + coordinate.to_string());
+        switch (attack_status) {
+            case GameField::MISS: {
+                renderer_->log("> Bot has missed!");
+                break;
+            }
+            case GameField::DAMAGE_SHIP: {
+                renderer_->log("> Bot has hit your ship!");
+                break;
+            }
+            case GameField::DESTROY_SHIP: {
+                renderer_->log("> Bot has destroyed your ship!");
+                break;
+            }
+            case GameField::WIN: {
+                renderer_->log("> Bot has won this game!");
+                break;
+            }
+            case GameField::EMPTY_ALREADY_ATTACKED:
+            case GameField::SHIP_ALREADY_ATTACKED: {
+                if (salvo_) {
+                    renderer_->log("> Bot's shot has landed at an already discovered point");
+                    break;
+                }
+                throw runtime_error(
+                        "Bot attacked an already attacked coordinate"
+                );
+            }
+            default:
+                throw runtime_error("Unknown attack status");
+        }
+        // the messages of the previous shots stay in the log below the frame
+        renderer_->present(*game_);
+    };
+};
+
+/**
+ * @brief Reads the salvo of the player and fires it at the bot's field.
+ *
+ * @param game game being played
+ * @param bot_field field of the bot
+ * @param renderer renderer of the game
+ * @param shots number of shots in the salvo
+ * @return {@code true} if the player has won
+ */
+bool fire_player_salvo(Game &game, GameField *const bot_field, ConsoleRenderer &renderer, const size_t &shots) {
+    const auto configuration = bot_field->get_configuration();
+    const auto count = std::min(shots, bot_field->count_not_visited());
+
+    vector<Coordinate> coordinates;
+    while (coordinates.size() < count) {
+        cout << "Enter the coordinate to attack [" << coordinates.size() + 1 << '/' << count << ']' << endl;
+        const auto coordinate = read_coordinate_safely(configuration.field_width, configuration.field_height);
+        if (bot_field->is_discovered(coordinate)
+            || std::find(coordinates.begin(), coordinates.end(), coordinate) != coordinates.end()) {
+            cout << "> This point has already been attacked" << endl;
+            continue;
+        }
+        coordinates.push_back(coordinate);
+    }
+
+    // all the shots are resolved at once so the results are reported only after the whole salvo is aimed
+    vector<GameField::AttackStatus> statuses(count);
+    bot_field->attack_batch(coordinates, statuses);
+    for (size_t i = 0; i < count; ++i) {
+        const auto prefix = "> " + coordinates[i].to_string() + ": ";
+        switch (statuses[i]) {
+            case GameField::EMPTY_ALREADY_ATTACKED:
+            case GameField::SHIP_ALREADY_ATTACKED: {
+                renderer.log(prefix + "the point has already been discovered by the salvo");
+                break;
+            }
+            case GameField::MISS: {
+                renderer.log(prefix + "you've missed");
+                break;
+            }
+            case GameField::DAMAGE_SHIP: {
+                renderer.log(prefix + "you've hit a ship!");
+                break;
+            }
+            case GameField::DESTROY_SHIP: {
+                renderer.log(prefix + "you've destroyed a ship!");
+                break;
+            }
+            case GameField::WIN: {
+                renderer.log(prefix + "you have won this game!");
+                renderer.present(game);
+                return true;
+            }
+            default: throw invalid_argument("Unknown player-attack status");
+        }
+    }
+    renderer.present(game);
+
+    return false;
+}
+
+/**
+ * @brief Plays the game against the bot.
+ *
+ * @param salvo_shots number of shots fired per turn in the salvo mode or {@code 0} for the classic turns
+ * @return {@code true} if the player has won
+ */
+bool play_against_bot_rival(const size_t &salvo_shots) {
     SimpleGame game(default_game_configuration());
     // get the configuration object after the game is created in case it gets modified
     const auto configuration = game.configuration();
@@ -156,48 +280,18 @@ bool play_against_bot_rival() {
     read_player_field(player_field);
     rival.place_ships();
 
-    class BotAttackCallback : public RivalBot::AttackCallback {
-        Game *game_;
-    public:
-        explicit BotAttackCallback(Game *game) : game_(game) {}
+    // only the changed cells get redrawn after each shot
+    ConsoleRenderer renderer;
+    BotAttackCallback attack_callback(&game, &renderer, salvo_shots != 0);
 
-        void on_attack(const Coordinate &coordinate, const GameField::AttackStatus &attack_status) override {
-            cout << "> Bot attacks " << coordinate.to_string() << endl;
-            switch (attack_status) {
-                case GameField::MISS: {
-                    cout << "> Bot has missed!" << endl;
-                    break;
-                }
-                case GameField::DAMAGE_SHIP: {
-                    cout << "> Bot has hit your ship!" << endl;
-                    break;
-                }
-                case GameField::DESTROY_SHIP: {
-                    cout << "> Bot has destroyed your ship!" << endl;
-                    break;
-                }
-                case GameField::WIN: {
-                    cout << "> Bot has won this game!" << endl;
-                    break;
-                }
-                case GameField::EMPTY_ALREADY_ATTACKED:
-                case GameField::SHIP_ALREADY_ATTACKED:
-                    throw runtime_error(
-                            "Bot attacked an already attacked coordinate"
-                    );
-                default:
-                    throw runtime_error("Unknown attack status");
-            }
-            game_->print_to_console();
-        };
-    } attack_callback(&game);
-
-    cout << "The game has started!" << endl;
-    game.print_to_console();
+    renderer.log("The game has started!");
+    renderer.present(game);
 
     bool player_turn = true;
     while (true) {
-        if (player_turn) while (true) {
+        if (player_turn && salvo_shots != 0) {
+            if (fire_player_salvo(game, bot_field, renderer, salvo_shots)) return true;
+        } else if (player_turn) while (true) {
             cout << "Enter the coordinate to attack" << endl;
             const auto coordinate = read_coordinate_safely(configuration.field_width, configuration.field_height);
             const auto attack_status = bot_field->attack(coordinate);
@@ -208,40 +302,58 @@ bool play_against_bot_rival() {
                     continue;
                 }
                 case GameField::MISS: {
-                    game.print_to_console();
-                    cout << "> You've missed" << endl;
+                    renderer.log("> You've missed");
+                    renderer.present(game);
                     break;
                 }
                 case GameField::DAMAGE_SHIP: {
-                    game.print_to_console();
-                    cout << "> You've hit a ship!" << endl;
+                    renderer.log("> You've hit a ship!");
+                    renderer.present(game);
                     continue;
                 }
                 case GameField::DESTROY_SHIP: {
-                    game.print_to_console();
-                    cout << "> You've destroyed a ship!" << endl;
+                    renderer.log("> You've destroyed a ship!");
+                    renderer.present(game);
                     continue;
                 }
                 case GameField::WIN: {
-                    game.print_to_console();
-                    cout << "> You have won this game!" << endl;
+                    renderer.log("> You have won this game!");
+                    renderer.present(game);
                     return true;
                 }
                 default: throw invalid_argument("Unknown player-attack status");
             }
             break;
-        } else if (rival.act(&attack_callback)) return false;
+        } else if (salvo_shots != 0 ? rival.act_salvo(salvo_shots, &attack_callback)
+                                    : rival.act(&attack_callback)) return false;
 
         player_turn = !player_turn;
     }
 }
 
+/**
+ * @brief Reads the number of shots fired per turn in the salvo mode.
+ *
+ * @return positive number of shots
+ */
+size_t read_salvo_shots() {
+    while (true) {
+        cout << "> Enter the number of shots fired per turn" << endl;
+        string text;
+        if (!(cin >> text)) throw runtime_error("Input has ended");
+        if (!text.empty() && text.size() <= 3 && std::all_of(text.begin(), text.end(), [](const char &c) {
+            return std::isdigit(static_cast<unsigned char>(c)) != 0;
+        }) && std::stoul(text) != 0) return std::stoul(text);
+    }
+}
+
 int main() {
     cli::print_logo();
 
     while (true) {
         cout << "Wanna play?" << endl << endl
-             << "Enter `(p)layer` to play against the player, `(b)ot` to play against the bot"
+             << "Enter `(p)layer` to play against the player, `(b)ot` to play against the bot,"
+                " `(s)alvo` to play against the bot firing several shots per turn"
                 " or `(e)xit` or `(q)uit`to exit" << endl;
         string input;
         cin >> input;
@@ -249,7 +361,10 @@ int main() {
             if (play_against_real_rival()) cli::print_player1_win_message();
             else cli::print_player2_win_message();
         } else if (input == "b" || input == "bot") {
-            if (play_against_bot_rival()) cli::print_win_message();
+            if (play_against_bot_rival(0)) cli::print_win_message();
+            else cli::print_loose_message();
+        } else if (input == "s" || input == "salvo") {
+            if (play_against_bot_rival(read_salvo_shots())) cli::print_win_message();
             else cli::print_loose_message();
         } else if (input == "e" || input == "q" || input == "exit" || input == "quit") return 0;
     }
@@ -0,0 +1,139 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "battleships/bitboard_game_field.h"
+#include "battleships/game_field_factory.h"
+#include "battleships/game_record.h"
+#include "battleships/simple_game_field.h"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+using std::unique_ptr;
+
+using battleships::BitboardGameField;
+using battleships::GameField;
+using battleships::GameFieldFactory;
+using battleships::GameRecord;
+using battleships::GameRecordReader;
+using battleships::SimpleGameField;
+using battleships::TypedGameFieldFactory;
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Options of the inspection
+ */
+struct InspectionOptions {
+    string input;
+    /**
+     * @brief Whether each game should be replayed into the fields to verify its moves
+     */
+    bool verify = false;
+    const GameFieldFactory *field_factory = TypedGameFieldFactory<BitboardGameField>::instance();
+};
+
+void print_usage() {
+    cerr << "Usage: battleships_record_inspector FILE [--verify] [--field simple|bitboard]" << endl;
+}
+
+bool parse_options(const int argc, char **argv, InspectionOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        const string option = argv[i];
+        if (option == "--verify") options.verify = true;
+        else if (option == "--field" && i + 1 < argc) {
+            const string value = argv[++i];
+            if (value == "simple") options.field_factory = TypedGameFieldFactory<SimpleGameField>::instance();
+            else if (value == "bitboard") options.field_factory = TypedGameFieldFactory<BitboardGameField>::instance();
+            else return false;
+        } else if (options.input.empty() && option.rfind("--", 0) != 0) options.input = option;
+        else return false;
+    }
+
+    return !options.input.empty();
+}
+
+/**
+ * @brief Statistics of the recorded games gathered by a single scan of their moves
+ */
+struct RecordStatistics {
+    size_t games = 0, moves = 0;
+    size_t winners[3]{};
+    /**
+     * @brief Number of the moves by their attack status
+     */
+    size_t statuses[GameField::WIN + 1]{};
+};
+
+int main(const int argc, char **argv) {
+    InspectionOptions options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return 1;
+    }
+
+    try {
+        const GameRecordReader reader(options.input);
+
+        RecordStatistics statistics;
+        const auto start = Clock::now();
+        for (const auto record : reader) {
+            ++statistics.games;
+            ++statistics.winners[record.winner()];
+            const auto moves = record.moves();
+            statistics.moves += moves.size();
+            for (const auto move : moves) ++statistics.statuses[move.status];
+        }
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        static const char *const STATUS_NAMES[] = {
+                "empty already attacked", "ship already attacked", "miss", "damage", "destroy", "win"
+        };
+        cout << std::fixed << std::setprecision(2)
+             << "Games: " << statistics.games << " (first won " << statistics.winners[GameRecord::FIRST]
+             << ", second won " << statistics.winners[GameRecord::SECOND]
+             << ", unfinished " << statistics.winners[GameRecord::UNFINISHED] << ')' << endl
+             << "Moves: " << statistics.moves << endl;
+        for (int status = 0; status <= GameField::WIN; ++status)
+            cout << "  " << STATUS_NAMES[status] << ": " << statistics.statuses[status] << endl;
+        cout << "Scanned in " << elapsed.count() << " s ("
+             << double(statistics.moves) / elapsed.count() / 1e6 << "M moves/s)" << endl;
+
+        if (options.verify) {
+            size_t verified = 0;
+            unique_ptr<GameField> first_field, second_field;
+            const auto verification_start = Clock::now();
+            for (const auto record : reader) {
+                const auto configuration = record.configuration();
+                if (!first_field || first_field->get_configuration().field_width != configuration.field_width
+                    || first_field->get_configuration().field_height != configuration.field_height) {
+                    first_field.reset(options.field_factory->create(configuration));
+                    second_field.reset(options.field_factory->create(configuration));
+                }
+
+                try {
+                    record.replay(first_field.get(), second_field.get());
+                } catch (const std::exception &exception) {
+                    cerr << "Game #" << verified << " (seed " << record.seed() << ") differs from its record: "
+                         << exception.what() << endl;
+                    return 1;
+                }
+                ++verified;
+            }
+            const std::chrono::duration<double> verification_elapsed = Clock::now() - verification_start;
+
+            cout << "Replayed and verified " << verified << " game(s) in " << verification_elapsed.count() << " s"
+                 << endl;
+        }
+    } catch (const std::runtime_error &error) {
+        cerr << error.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
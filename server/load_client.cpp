@@ -0,0 +1,486 @@
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "battleships/game_configuration.h"
+#include "battleships/random_engine.h"
+#include "server/protocol.h"
+
+using std::cerr;
+using std::cout;
+using std::deque;
+using std::endl;
+using std::runtime_error;
+using std::string;
+using std::string_view;
+using std::vector;
+
+using battleships::GameConfiguration;
+using battleships::GameField;
+using battleships::RandomEngine;
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Options of the load generation
+ */
+struct LoadOptions {
+    uint16_t port = protocol::DEFAULT_PORT;
+    /**
+     * @brief Path of the server's Unix socket to connect to instead of the TCP port if not empty
+     */
+    string socket_path;
+    /**
+     * @brief Number of the games played concurrently
+     */
+    size_t game_count = 10000;
+    /**
+     * @brief Number of the connections the games are spread over
+     */
+    size_t connection_count = 100;
+    /**
+     * @brief Name of the bot kind to play against, the server's default one if empty
+     */
+    string bot;
+    uint64_t seed = battleships::random_seed();
+};
+
+/**
+ * @brief Game played by the client, each game has at most one request in flight
+ */
+struct ClientGame {
+
+    enum Stage {
+        CREATING, PLACING, ATTACKING, DROPPING, FINISHED
+    };
+
+    Stage stage = CREATING;
+    string id;
+    /**
+     * @brief Cells of the bot's field not attacked yet (i.e. {@code y * width + x}) in random order
+     */
+    vector<uint16_t> targets;
+    bool won = false;
+};
+
+/**
+ * @brief Request sent over the connection whose answer has not been received yet
+ */
+struct PendingRequest {
+    size_t game;
+    Clock::time_point sent_at;
+};
+
+struct ClientConnection {
+    int fd = -1;
+    string input, output;
+    size_t output_offset = 0;
+    /**
+     * @brief Requests in the order of their sending which is the order of their answers
+     */
+    deque<PendingRequest> pending;
+};
+
+void print_usage() {
+    cerr << "Usage: battleships_load_client [--port N | --socket PATH] [--games N] [--connections N]"
+            " [--bot NAME] [--seed S]" << endl;
+}
+
+bool parse_options(const int argc, char **argv, LoadOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        const string option = argv[i];
+        if (i + 1 == argc) return false;
+        const string value = argv[++i];
+
+        if (option == "--port") {
+            const auto port = std::stoul(value);
+            if (port == 0 || port > 65535) return false;
+            options.port = uint16_t(port);
+        } else if (option == "--socket") options.socket_path = value;
+        else if (option == "--games") options.game_count = std::stoul(value);
+        else if (option == "--connections") options.connection_count = std::max<size_t>(1, std::stoul(value));
+        else if (option == "--bot") options.bot = value;
+        else if (option == "--seed") options.seed = std::stoull(value);
+        else return false;
+    }
+
+    return options.game_count != 0;
+}
+
+/**
+ * @brief Generator of the load which plays all the games concurrently making random moves
+ * and measures the latency of each move (i.e. the time between sending the attack and receiving its result).
+ */
+class LoadGenerator {
+
+    const LoadOptions &options_;
+
+    const GameConfiguration configuration_ = GameConfiguration::classic();
+
+    int epoll_fd_ = -1;
+
+    vector<ClientConnection> connections_;
+
+    vector<ClientGame> games_;
+
+    size_t games_finished_ = 0, games_won_ = 0, errors_ = 0;
+
+    /**
+     * @brief Latencies of the moves in microseconds
+     */
+    vector<uint32_t> latencies_;
+
+    vector<string_view> tokens_;
+
+    [[nodiscard]] int connect_to_server() const;
+
+    void send_request(const size_t &game_index);
+
+    void handle_answer(ClientConnection &connection, const string_view &line);
+
+    void read_from(ClientConnection &connection);
+
+    void write_to(ClientConnection &connection);
+
+    void watch_output(const size_t &connection_index, const bool &watch) const;
+
+public:
+
+    explicit LoadGenerator(const LoadOptions &options);
+
+    LoadGenerator(const LoadGenerator &) = delete;
+
+    LoadGenerator &operator=(const LoadGenerator &) = delete;
+
+    ~LoadGenerator();
+
+    /**
+     * @brief Plays all the games until those are finished.
+     *
+     * @throws runtime_error if the server cannot be reached or closes the connection
+     */
+    void run();
+
+    void print_report(const double &seconds);
+};
+
+namespace {
+
+    [[noreturn]] void throw_system_error(const string &action) {
+        throw runtime_error(action + ": " + std::strerror(errno));
+    }
+}
+
+LoadGenerator::LoadGenerator(const LoadOptions &options)
+        : options_(options), connections_(std::min(options.connection_count, options.game_count)),
+          games_(options.game_count) {
+    RandomEngine random(options.seed);
+    vector<uint16_t> cells(configuration_.field_width * configuration_.field_height);
+    std::iota(cells.begin(), cells.end(), 0);
+    for (auto &game : games_) {
+        std::shuffle(cells.begin(), cells.end(), random);
+        game.targets = cells;
+    }
+}
+
+LoadGenerator::~LoadGenerator() {
+    for (const auto &connection : connections_) if (connection.fd != -1) close(connection.fd);
+    if (epoll_fd_ != -1) close(epoll_fd_);
+}
+
+int LoadGenerator::connect_to_server() const {
+    int fd;
+    if (options_.socket_path.empty()) {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd == -1) throw_system_error("socket");
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options_.port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == -1) {
+            close(fd);
+            throw_system_error("connect");
+        }
+
+        const int enabled = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+    } else {
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd == -1) throw_system_error("socket");
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (options_.socket_path.size() >= sizeof(address.sun_path)) {
+            close(fd);
+            throw runtime_error("Socket path is too long");
+        }
+        std::memcpy(address.sun_path, options_.socket_path.c_str(), options_.socket_path.size() + 1);
+        if (connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == -1) {
+            close(fd);
+            throw_system_error("connect");
+        }
+    }
+
+    // connecting is blocking while the exchange is not
+    const auto flags = fcntl(fd, F_GETFL, 0);
+    if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+        close(fd);
+        throw_system_error("fcntl");
+    }
+
+    return fd;
+}
+
+void LoadGenerator::send_request(const size_t &game_index) {
+    auto &game = games_[game_index];
+    auto &connection = connections_[game_index % connections_.size()];
+    auto &output = connection.output;
+
+    switch (game.stage) {
+        case ClientGame::CREATING: {
+            output += "NEW";
+            if (!options_.bot.empty()) (output += ' ') += options_.bot;
+            break;
+        }
+        case ClientGame::PLACING: {
+            (output += "RANDOM ") += game.id;
+            break;
+        }
+        case ClientGame::ATTACKING: {
+            const auto cell = game.targets.back();
+            ((((output += "ATTACK ") += game.id) += ' ') += std::to_string(cell % configuration_.field_width)) += ' ';
+            output += std::to_string(cell / configuration_.field_width);
+            break;
+        }
+        case ClientGame::DROPPING: {
+            (output += "DROP ") += game.id;
+            break;
+        }
+        case ClientGame::FINISHED: return;
+    }
+    output += '\n';
+
+    connection.pending.push_back({game_index, Clock::now()});
+}
+
+void LoadGenerator::handle_answer(ClientConnection &connection, const string_view &line) {
+    if (connection.pending.empty()) throw runtime_error("Unexpected answer: " + string(line));
+    const auto request = connection.pending.front();
+    connection.pending.pop_front();
+
+    auto &game = games_[request.game];
+    protocol::split_tokens(line, tokens_);
+    if (tokens_.empty() || tokens_[0] == "ERROR") {
+        cerr << "Game " << (game.id.empty() ? "?" : game.id) << " failed: " << line << endl;
+        ++errors_;
+        game.stage = game.id.empty() ? ClientGame::FINISHED : ClientGame::DROPPING;
+        if (game.stage == ClientGame::FINISHED) ++games_finished_;
+        else send_request(request.game);
+        return;
+    }
+
+    switch (game.stage) {
+        case ClientGame::CREATING: {
+            if (tokens_.size() != 2 || tokens_[0] != "GAME") throw runtime_error("Unexpected answer: " + string(line));
+            game.id = string(tokens_[1]);
+            game.stage = ClientGame::PLACING;
+            break;
+        }
+        case ClientGame::PLACING: {
+            game.stage = ClientGame::ATTACKING;
+            break;
+        }
+        case ClientGame::ATTACKING: {
+            latencies_.push_back(uint32_t(std::chrono::duration_cast<std::chrono::microseconds>(
+                    Clock::now() - request.sent_at
+            ).count()));
+            game.targets.pop_back();
+
+            if (tokens_.size() < 2 || tokens_[0] != "RESULT") throw runtime_error("Unexpected answer: " + string(line));
+            const auto status = protocol::parse_status(tokens_[1]);
+            if (!status) throw runtime_error("Unexpected answer: " + string(line));
+
+            // the bot's last shot tells whether it has won
+            const auto bot_won = tokens_.size() > 2 && tokens_.back().size() > 4
+                                 && tokens_.back().substr(tokens_.back().size() - 4) == ",WIN";
+            if (status == GameField::WIN || bot_won || game.targets.empty()) {
+                game.won = status == GameField::WIN;
+                game.stage = ClientGame::DROPPING;
+            }
+            break;
+        }
+        case ClientGame::DROPPING: {
+            game.stage = ClientGame::FINISHED;
+            ++games_finished_;
+            if (game.won) ++games_won_;
+            return;
+        }
+        case ClientGame::FINISHED: return;
+    }
+
+    send_request(request.game);
+}
+
+void LoadGenerator::read_from(ClientConnection &connection) {
+    char buffer[1 << 16];
+    while (true) {
+        const auto count = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (count == 0) throw runtime_error("Server has closed the connection");
+        if (count == -1) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            throw_system_error("recv");
+        }
+        connection.input.append(buffer, size_t(count));
+        if (size_t(count) < sizeof(buffer)) break;
+    }
+
+    size_t offset = 0;
+    while (true) {
+        const auto line_end = connection.input.find('\n', offset);
+        if (line_end == string::npos) break;
+
+        handle_answer(connection, string_view(connection.input.data() + offset, line_end - offset));
+        offset = line_end + 1;
+    }
+    connection.input.erase(0, offset);
+}
+
+void LoadGenerator::write_to(ClientConnection &connection) {
+    while (connection.output_offset < connection.output.size()) {
+        const auto count = send(connection.fd, connection.output.data() + connection.output_offset,
+                                connection.output.size() - connection.output_offset, MSG_NOSIGNAL);
+        if (count == -1) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            throw_system_error("send");
+        }
+        connection.output_offset += size_t(count);
+    }
+
+    if (connection.output_offset == connection.output.size()) {
+        connection.output.clear();
+        connection.output_offset = 0;
+    }
+}
+
+void LoadGenerator::watch_output(const size_t &connection_index, const bool &watch) const {
+    epoll_event event{};
+    event.events = EPOLLIN | (watch ? EPOLLOUT : 0u);
+    event.data.u64 = connection_index;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connections_[connection_index].fd, &event) == -1)
+        throw_system_error("epoll_ctl");
+}
+
+void LoadGenerator::run() {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ == -1) throw_system_error("epoll_create1");
+
+    for (size_t i = 0; i < connections_.size(); ++i) {
+        connections_[i].fd = connect_to_server();
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, connections_[i].fd, &event) == -1) throw_system_error("epoll_ctl");
+    }
+
+    for (size_t i = 0; i < games_.size(); ++i) send_request(i);
+
+    latencies_.reserve(games_.size() * configuration_.field_width * configuration_.field_height / 2);
+    vector<bool> watching_output(connections_.size(), false);
+    constexpr int MAX_EVENTS = 256;
+    epoll_event events[MAX_EVENTS];
+    while (games_finished_ != games_.size()) {
+        for (size_t i = 0; i < connections_.size(); ++i) {
+            auto &connection = connections_[i];
+            write_to(connection);
+
+            const bool has_output = !connection.output.empty();
+            if (has_output != watching_output[i]) {
+                watch_output(i, has_output);
+                watching_output[i] = has_output;
+            }
+        }
+
+        const auto event_count = epoll_wait(epoll_fd_, events, MAX_EVENTS, -1);
+        if (event_count == -1) {
+            if (errno == EINTR) continue;
+            throw_system_error("epoll_wait");
+        }
+
+        for (int i = 0; i < event_count; ++i) {
+            auto &connection = connections_[events[i].data.u64];
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) read_from(connection);
+        }
+    }
+}
+
+void LoadGenerator::print_report(const double &seconds) {
+    cout << std::fixed << std::setprecision(2)
+         << "Games played: " << games_finished_ << " over " << connections_.size() << " connection(s), won "
+         << games_won_ << ", failed " << errors_ << endl
+         << "Elapsed: " << seconds << " s" << endl
+         << "Moves: " << latencies_.size() << " (" << double(latencies_.size()) / seconds << " moves/s)" << endl;
+    if (latencies_.empty()) return;
+
+    std::sort(latencies_.begin(), latencies_.end());
+    const auto percentile = [&](const double &fraction) {
+        return double(latencies_[size_t(fraction * double(latencies_.size() - 1))]) / 1000.0;
+    };
+    const auto total = std::accumulate(latencies_.begin(), latencies_.end(), 0.0);
+
+    cout << "Move latency (ms): mean " << total / double(latencies_.size()) / 1000.0
+         << ", p50 " << percentile(0.5) << ", p90 " << percentile(0.9) << ", p99 " << percentile(0.99)
+         << ", max " << double(latencies_.back()) / 1000.0 << endl;
+}
+
+int main(const int argc, char **argv) {
+    LoadOptions options;
+    try {
+        if (!parse_options(argc, argv, options)) {
+            print_usage();
+            return 1;
+        }
+    } catch (const std::logic_error &) {
+        print_usage();
+        return 1;
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+
+    try {
+        LoadGenerator generator(options);
+
+        const auto start = Clock::now();
+        generator.run();
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        generator.print_report(elapsed.count());
+    } catch (const std::exception &exception) {
+        cerr << "Load generation failure: " << exception.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
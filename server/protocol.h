@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "battleships/game_field.h"
+
+/*
+ * Line protocol of the game server.
+ *
+ * Each request is a single line answered by a single line, the answers on a connection following its requests' order:
+ *
+ *   NEW [BOT]                  -> GAME <id>                 creates a game against the bot (the default one if omitted)
+ *   PLACE <id> <x> <y> <H|V> <size>
+ *                              -> OK                        places the player's ship from its left or upper cell
+ *   RANDOM <id>                -> OK                        places the whole player's fleet randomly
+ *   ATTACK <id> <x> <y>        -> RESULT <status> [<x>,<y>,<status>]...
+ *                                                           attacks the bot's field, once the player misses
+ *                                                           the bot's attacks follow as the list of its shots
+ *   STATE <id>                 -> STATE <width> <height> <own> <rival>
+ *                                                           gets the private icons of the player's field
+ *                                                           and the public icons of the bot's one row by row:
+ *                                                           '.' not attacked, '~' missed, '#' hit,
+ *                                                           'O' not hit ship of the player
+ *   DROP <id>                  -> OK                        removes the game
+ *   METRICS                    -> METRICS <json>            gets the instrumentation counters of the server
+ *
+ * Any failed request is answered by {@code ERROR <message>}.
+ */
+namespace protocol {
+
+    constexpr uint16_t DEFAULT_PORT = 7373;
+
+    /**
+     * @brief Maximal length of a request line, the connections sending longer ones get closed
+     */
+    constexpr size_t MAX_LINE_LENGTH = 4096;
+
+    /**
+     * @brief Gets the name of the attack status as used by the protocol.
+     *
+     * @param status attack status
+     * @return name of the status
+     */
+    [[nodiscard]] inline const char *status_name(const battleships::GameField::AttackStatus &status) noexcept {
+        static const char *const STATUS_NAMES[] = {"EMPTY_ALREADY_ATTACKED", "SHIP_ALREADY_ATTACKED", "MISS",
+                                                   "DAMAGE_SHIP", "DESTROY_SHIP", "WIN"};
+        return STATUS_NAMES[status];
+    }
+
+    /**
+     * @brief Parses the name of the attack status.
+     *
+     * @param name name of the status as used by the protocol
+     * @return parsed status or an empty optional if the name is unknown
+     */
+    [[nodiscard]] inline std::optional<battleships::GameField::AttackStatus> parse_status(const std::string_view &name) {
+        for (int status = battleships::GameField::EMPTY_ALREADY_ATTACKED; status <= battleships::GameField::WIN; ++status)
+            if (name == status_name(battleships::GameField::AttackStatus(status)))
+                return battleships::GameField::AttackStatus(status);
+
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Splits the line into its space-separated tokens.
+     *
+     * @param line line to split
+     * @param tokens vector to store the tokens in, those refer to the line's characters
+     */
+    inline void split_tokens(const std::string_view &line, std::vector<std::string_view> &tokens) {
+        tokens.clear();
+        size_t start = 0;
+        while (start < line.size()) {
+            const auto end = std::min(line.find(' ', start), line.size());
+            if (end != start) tokens.push_back(line.substr(start, end - start));
+            start = end + 1;
+        }
+    }
+}
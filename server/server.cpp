@@ -0,0 +1,1007 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "battleships/bitboard_game_field.h"
+#include "battleships/game_configuration.h"
+#include "battleships/game_field_factory.h"
+#include "battleships/game_record.h"
+#include "battleships/instrumentation.h"
+#include "battleships/random_engine.h"
+#include "battleships/rival_bot_factory.h"
+#include "battleships/ship_placement.h"
+#include "battleships/simple_game.h"
+#include "battleships/simple_game_field.h"
+#include "battleships/thread_pool.h"
+#include "server/protocol.h"
+
+using std::atomic;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::map;
+using std::mutex;
+using std::runtime_error;
+using std::shared_ptr;
+using std::string;
+using std::string_view;
+using std::thread;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+using battleships::BitboardGameField;
+using battleships::Coordinate;
+using battleships::GameConfiguration;
+using battleships::GameField;
+using battleships::GameFieldFactory;
+using battleships::GameRecord;
+using battleships::GameRecordWriter;
+using battleships::RandomEngine;
+using battleships::RivalBot;
+using battleships::SimpleGame;
+using battleships::SimpleGameField;
+using battleships::ThreadPool;
+using battleships::TypedGameFieldFactory;
+
+/**
+ * @brief Options of the server
+ */
+struct ServerOptions {
+    uint16_t port = protocol::DEFAULT_PORT;
+    /**
+     * @brief Path of the Unix socket to listen at instead of the TCP port if not empty
+     */
+    string socket_path;
+    /**
+     * @brief Number of the workers making the bots' moves
+     */
+    size_t thread_count = std::max(1u, thread::hardware_concurrency());
+    const GameFieldFactory *field_factory = TypedGameFieldFactory<BitboardGameField>::instance();
+    /**
+     * @brief Name of the bot kind used by the games which do not specify it
+     */
+    string bot = "simple";
+    /**
+     * @brief Time in which the bots choose each shot while the workers keep up with the turns, it gets scaled down
+     * once more turns wait for the workers than there are workers, {@code 0} for no limit
+     */
+    std::chrono::microseconds shot_budget = std::chrono::microseconds::zero();
+    /**
+     * @brief Base seed from which the seeds of all games are derived
+     */
+    uint64_t seed = battleships::random_seed();
+    /**
+     * @brief Path of the file to append the records of the games to if those should be recorded
+     */
+    string record_path;
+    /**
+     * @brief Path of the file to keep the snapshot of the instrumentation counters in if not empty
+     */
+    string metrics_path;
+    battleships::instrumentation::SnapshotFormat metrics_format = battleships::instrumentation::PROMETHEUS;
+};
+
+/**
+ * @brief Game of the player against the bot hosted by the server.
+ *
+ * The game is only accessed by a single thread at a time: the event loop handles the player's requests
+ * and the bot's moves are made by a worker while the connection owning the game waits for them.
+ */
+struct HostedGame {
+    SimpleGame game;
+    unique_ptr<RivalBot> bot;
+    /**
+     * @brief Counts of the player's ships yet to be placed by their length
+     */
+    map<size_t, size_t> ships_to_place;
+    size_t ships_left = 0;
+    bool over = false;
+    RandomEngine random;
+    /**
+     * @brief Writer of the game's record or {@code nullptr} if the games are not recorded
+     */
+    GameRecordWriter *const record_writer;
+    /**
+     * @brief Record of the game in which the player is the first one
+     */
+    GameRecord record;
+    bool record_written = false;
+
+    HostedGame(const GameConfiguration &configuration, const GameFieldFactory *const field_factory,
+               const string &bot_name, const uint64_t &seed, GameRecordWriter *const record_writer)
+            : game(configuration, field_factory),
+              bot(battleships::create_rival_bot(bot_name, game.field_2(), game.field_1(),
+                                                battleships::derive_seed(seed, 1))),
+              ships_to_place(configuration.ships), random(battleships::derive_seed(seed, 2)),
+              record_writer(record_writer), record(configuration, seed) {
+        for (const auto &ship_count : ships_to_place) ships_left += ship_count.second;
+    }
+
+    HostedGame(const HostedGame &) = delete;
+
+    HostedGame &operator=(const HostedGame &) = delete;
+
+    /**
+     * @brief Writes the record of the game if it has been started but not finished.
+     */
+    ~HostedGame() {
+        if (!record.moves().empty()) write_record();
+    }
+
+    inline void record_move(const bool &by_bot, const Coordinate &coordinate, const GameField::AttackStatus &status) {
+        if (!record_writer) return;
+
+        // the fleets can't be changed once the first attack is made
+        if (record.moves().empty()) record.record_fleets(player_field(), bot_field());
+        record.add_move(by_bot, coordinate, status);
+    }
+
+    /**
+     * @brief Writes the record of the game unless it has already been written.
+     * The failure to write it is only logged as it should not affect the game.
+     */
+    void write_record() noexcept {
+        if (!record_writer || record_written) return;
+
+        record_written = true;
+        try {
+            record_writer->write(record);
+        } catch (const std::exception &exception) {
+            cerr << "Cannot record the game: " << exception.what() << endl;
+        }
+    }
+
+    [[nodiscard]] inline GameField *player_field() noexcept {
+        return game.field_1();
+    }
+
+    [[nodiscard]] inline GameField *bot_field() noexcept {
+        return game.field_2();
+    }
+};
+
+/**
+ * @brief Client connection with its non-blocking buffers and games
+ */
+struct Connection {
+    const uint64_t id;
+    const int fd;
+    string input, output;
+    /**
+     * @brief Offsets of the first not yet handled byte of the input and not yet sent byte of the output
+     */
+    size_t input_offset = 0, output_offset = 0;
+    /**
+     * @brief Flag indicating whether the connection waits for a worker to answer its request,
+     * its following requests are not handled until then so that the answers keep the order
+     */
+    bool busy = false;
+    /**
+     * @brief Flag indicating whether the client has shut its side of the connection down
+     */
+    bool input_closed = false;
+    /**
+     * @brief Events of the connection's socket watched by the event loop
+     */
+    uint32_t events = 0;
+    unordered_map<uint64_t, shared_ptr<HostedGame>> games;
+
+    Connection(const uint64_t &id, const int &fd) : id(id), fd(fd) {}
+
+    [[nodiscard]] inline size_t pending_output() const noexcept {
+        return output.size() - output_offset;
+    }
+};
+
+/**
+ * @brief Flag set by the signal handlers once the server should stop
+ */
+volatile std::sig_atomic_t stop_requested = 0;
+
+void request_stop(int) {
+    stop_requested = 1;
+}
+
+/**
+ * @brief Event loop serving all the connections and owning their games.
+ */
+class GameServer {
+
+    /**
+     * @brief Size of the chunks in which the sockets are read
+     */
+    constexpr static size_t READ_CHUNK_SIZE = 1 << 16;
+
+    /**
+     * @brief Amount of the unsent output above which the connection's requests are not handled until it is sent
+     */
+    constexpr static size_t MAX_PENDING_OUTPUT = 1 << 20;
+
+    /**
+     * @brief Epoll tags of the listening socket and the event descriptor, those of the connections are their ids
+     */
+    constexpr static uint64_t LISTENER_TAG = 0, COMPLETION_TAG = 1;
+
+    /**
+     * @brief Period in which the metrics file gets rewritten
+     */
+    constexpr static std::chrono::milliseconds METRICS_PERIOD{1000};
+
+    /**
+     * @brief Answer made by a worker to the connection's request
+     */
+    struct Completion {
+        uint64_t connection_id;
+        string answer;
+    };
+
+    const ServerOptions &options_;
+
+    const GameConfiguration configuration_ = GameConfiguration::classic();
+
+    int listener_fd_ = -1, epoll_fd_ = -1, completion_fd_ = -1;
+
+    /**
+     * @brief Writer of the games' records which outlives the connections owning those
+     */
+    unique_ptr<GameRecordWriter> record_writer_;
+
+    unordered_map<uint64_t, unique_ptr<Connection>> connections_;
+
+    uint64_t next_connection_id_ = COMPLETION_TAG + 1, next_game_id_ = 1;
+
+    size_t games_created_ = 0, requests_handled_ = 0;
+
+    /**
+     * @brief Number of the bots' turns submitted to the workers and not yet started by them
+     */
+    atomic<size_t> waiting_bot_turns_{0};
+
+    /**
+     * @brief Totals of the searches made by the bots choosing their shots within the budget
+     */
+    atomic<size_t> searched_shots_{0}, search_evaluations_{0}, interrupted_searches_{0};
+
+    mutex completions_mutex_;
+
+    vector<Completion> completions_;
+
+    vector<string_view> tokens_;
+
+    /**
+     * @brief Workers making the bots' moves, those are stopped first so that no task outlives the server
+     */
+    unique_ptr<ThreadPool> workers_;
+
+    void open_listener();
+
+    void watch(const int &fd, const uint64_t &tag, const uint32_t &events) const;
+
+    void accept_connections();
+
+    /**
+     * @brief Reads what the client has sent and handles its requests.
+     *
+     * @return {@code false} if the connection has been closed and {@code true} otherwise
+     */
+    bool read_from(Connection &connection);
+
+    /**
+     * @brief Sends as much of the pending output as the socket accepts.
+     *
+     * @return {@code false} if the connection has been closed and {@code true} otherwise
+     */
+    bool write_to(Connection &connection);
+
+    /**
+     * @brief Handles the buffered requests until the connection has to wait for a worker or its output to be sent.
+     */
+    void handle_input(Connection &connection);
+
+    void handle_request(Connection &connection, const string_view &line);
+
+    void handle_completions();
+
+    /**
+     * @brief Sends what can be sent and updates the watched events, closes the connection if it is done.
+     */
+    void update(Connection &connection);
+
+    void close(Connection &connection);
+
+    /**
+     * @brief Makes the worker answer the connection's request by the task's result or its exception's message.
+     */
+    void answer_by_worker(Connection &connection, shared_ptr<HostedGame> game, std::function<string()> task);
+
+    void complete(const uint64_t &connection_id, string answer);
+
+    /**
+     * @brief Takes the bot's turn off the waiting ones and gets the time budget of its shots.
+     *
+     * @return time in which each shot of the turn should be chosen, {@code 0} for no limit
+     */
+    [[nodiscard]] std::chrono::microseconds start_bot_turn() noexcept;
+
+    /**
+     * @brief Replaces the metrics file by the current snapshot of the instrumentation counters.
+     * The failure to write it is only logged as it should not affect the games.
+     */
+    void write_metrics() const noexcept;
+
+    /**
+     * @brief Finds the connection's game by the id token.
+     *
+     * @return game found or {@code nullptr} if there is none
+     */
+    [[nodiscard]] shared_ptr<HostedGame> find_game(const Connection &connection, const string_view &id) const;
+
+public:
+
+    /**
+     * @brief Creates a new server.
+     *
+     * @param options options of the server
+     * @throws runtime_error if the record file cannot be opened
+     */
+    explicit GameServer(const ServerOptions &options)
+            : options_(options),
+              record_writer_(options.record_path.empty() ? nullptr
+                                                         : std::make_unique<GameRecordWriter>(options.record_path)),
+              workers_(std::make_unique<ThreadPool>(options.thread_count)) {}
+
+    GameServer(const GameServer &) = delete;
+
+    GameServer &operator=(const GameServer &) = delete;
+
+    ~GameServer();
+
+    /**
+     * @brief Serves the connections until a stop is requested.
+     *
+     * @throws runtime_error if some system call fails
+     */
+    void run();
+};
+
+namespace {
+
+    [[noreturn]] void throw_system_error(const string &action) {
+        throw runtime_error(action + ": " + std::strerror(errno));
+    }
+
+    template<typename T>
+    [[nodiscard]] bool parse_number(const string_view &token, T &value) {
+        const auto end = token.data() + token.size();
+        const auto result = std::from_chars(token.data(), end, value);
+
+        return result.ec == std::errc() && result.ptr == end;
+    }
+
+    [[nodiscard]] bool parse_coordinate(const string_view &x_token, const string_view &y_token,
+                                        const GameField *const field, Coordinate &coordinate) {
+        int x, y;
+        if (!parse_number(x_token, x) || !parse_number(y_token, y)) return false;
+
+        coordinate = Coordinate(x, y);
+        return field->is_in_bounds(coordinate);
+    }
+}
+
+GameServer::~GameServer() {
+    workers_.reset();
+    for (const auto &connection : connections_) ::close(connection.second->fd);
+    if (completion_fd_ != -1) ::close(completion_fd_);
+    if (epoll_fd_ != -1) ::close(epoll_fd_);
+    if (listener_fd_ != -1) ::close(listener_fd_);
+    if (!options_.socket_path.empty()) unlink(options_.socket_path.c_str());
+}
+
+void GameServer::open_listener() {
+    if (options_.socket_path.empty()) {
+        listener_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listener_fd_ == -1) throw_system_error("socket");
+
+        const int enabled = 1;
+        setsockopt(listener_fd_, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options_.port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(listener_fd_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == -1)
+            throw_system_error("bind");
+    } else {
+        listener_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listener_fd_ == -1) throw_system_error("socket");
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (options_.socket_path.size() >= sizeof(address.sun_path))
+            throw runtime_error("Socket path is too long");
+        std::memcpy(address.sun_path, options_.socket_path.c_str(), options_.socket_path.size() + 1);
+        // the socket file is left by a previous server which has not been stopped gracefully
+        unlink(options_.socket_path.c_str());
+        if (bind(listener_fd_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == -1)
+            throw_system_error("bind");
+    }
+
+    if (listen(listener_fd_, SOMAXCONN) == -1) throw_system_error("listen");
+}
+
+void GameServer::watch(const int &fd, const uint64_t &tag, const uint32_t &events) const {
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = tag;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1) throw_system_error("epoll_ctl");
+}
+
+void GameServer::run() {
+    open_listener();
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ == -1) throw_system_error("epoll_create1");
+    completion_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (completion_fd_ == -1) throw_system_error("eventfd");
+
+    watch(listener_fd_, LISTENER_TAG, EPOLLIN);
+    watch(completion_fd_, COMPLETION_TAG, EPOLLIN);
+
+    if (options_.socket_path.empty()) cout << "Listening at 127.0.0.1:" << options_.port;
+    else cout << "Listening at " << options_.socket_path;
+    cout << " with " << options_.thread_count << " worker(s), seed " << options_.seed << endl;
+
+    constexpr int MAX_EVENTS = 256;
+    epoll_event events[MAX_EVENTS];
+    const auto writes_metrics = !options_.metrics_path.empty();
+    auto next_metrics_write = std::chrono::steady_clock::now();
+    while (!stop_requested) {
+        if (writes_metrics && std::chrono::steady_clock::now() >= next_metrics_write) {
+            write_metrics();
+            next_metrics_write += METRICS_PERIOD;
+        }
+
+        const auto event_count = epoll_wait(epoll_fd_, events, MAX_EVENTS,
+                                             writes_metrics ? int(METRICS_PERIOD.count()) : -1);
+        if (event_count == -1) {
+            if (errno == EINTR) continue;
+            throw_system_error("epoll_wait");
+        }
+
+        for (int i = 0; i < event_count; ++i) {
+            const auto &event = events[i];
+            if (event.data.u64 == LISTENER_TAG) accept_connections();
+            else if (event.data.u64 == COMPLETION_TAG) handle_completions();
+            else {
+                const auto found = connections_.find(event.data.u64);
+                // the connection might have been closed while handling the previous events
+                if (found == connections_.end()) continue;
+                auto &connection = *found->second;
+
+                if (event.events & (EPOLLERR | EPOLLHUP) && !(event.events & EPOLLIN)) {
+                    close(connection);
+                    continue;
+                }
+                if (event.events & EPOLLIN && !read_from(connection)) continue;
+                if (event.events & EPOLLOUT && !write_to(connection)) continue;
+                update(connection);
+            }
+        }
+    }
+
+    if (writes_metrics) write_metrics();
+    cout << "Created " << games_created_ << " game(s), handled " << requests_handled_ << " request(s)" << endl;
+    if (const auto searched_shots = searched_shots_.load(); searched_shots != 0)
+        cout << "Bots chose " << searched_shots << " shot(s) within the budget: "
+             << search_evaluations_.load() / searched_shots << " evaluation(s) per shot, "
+             << interrupted_searches_.load() << " cut short by the deadline" << endl;
+}
+
+void GameServer::write_metrics() const noexcept {
+    try {
+        // the file is replaced at once so that its readers never see a partial snapshot
+        const auto temporary_path = options_.metrics_path + ".tmp";
+        {
+            std::ofstream out(temporary_path);
+            out << battleships::instrumentation::format_snapshot(
+                    battleships::instrumentation::take_snapshot(), options_.metrics_format
+            ) << '\n';
+            if (!out) throw runtime_error("Cannot write " + temporary_path);
+        }
+        if (std::rename(temporary_path.c_str(), options_.metrics_path.c_str()) != 0)
+            throw_system_error("rename");
+    } catch (const std::exception &exception) {
+        cerr << "Cannot write the metrics: " << exception.what() << endl;
+    }
+}
+
+void GameServer::accept_connections() {
+    while (true) {
+        const auto fd = accept4(listener_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            // running out of descriptors should not stop the server, the pending clients are accepted later
+            if (errno == EMFILE || errno == ENFILE) {
+                cerr << "Cannot accept a connection: " << std::strerror(errno) << endl;
+                return;
+            }
+            throw_system_error("accept4");
+        }
+
+        if (options_.socket_path.empty()) {
+            const int enabled = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+        }
+
+        const auto id = next_connection_id_++;
+        auto &connection = *(connections_[id] = std::make_unique<Connection>(id, fd));
+        connection.events = EPOLLIN;
+        watch(fd, id, connection.events);
+    }
+}
+
+bool GameServer::read_from(Connection &connection) {
+    char buffer[READ_CHUNK_SIZE];
+    while (true) {
+        const auto count = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (count > 0) {
+            connection.input.append(buffer, size_t(count));
+            if (size_t(count) < sizeof(buffer)) break;
+        } else if (count == 0) {
+            connection.input_closed = true;
+            break;
+        } else {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                close(connection);
+                return false;
+            }
+            break;
+        }
+    }
+
+    handle_input(connection);
+    return true;
+}
+
+bool GameServer::write_to(Connection &connection) {
+    while (connection.pending_output() != 0) {
+        const auto count = send(connection.fd, connection.output.data() + connection.output_offset,
+                                connection.pending_output(), MSG_NOSIGNAL);
+        if (count == -1) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                close(connection);
+                return false;
+            }
+            break;
+        }
+        connection.output_offset += size_t(count);
+    }
+
+    if (connection.pending_output() == 0) {
+        connection.output.clear();
+        connection.output_offset = 0;
+    } else if (connection.output_offset > connection.output.size() / 2) {
+        connection.output.erase(0, connection.output_offset);
+        connection.output_offset = 0;
+    }
+
+    return true;
+}
+
+void GameServer::handle_input(Connection &connection) {
+    while (!connection.busy && connection.pending_output() < MAX_PENDING_OUTPUT) {
+        const auto line_end = connection.input.find('\n', connection.input_offset);
+        if (line_end == string::npos) break;
+
+        string_view line(connection.input.data() + connection.input_offset, line_end - connection.input_offset);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        connection.input_offset = line_end + 1;
+
+        try {
+            handle_request(connection, line);
+        } catch (const std::exception &exception) {
+            ((connection.output += "ERROR ") += exception.what()) += '\n';
+        }
+    }
+
+    if (connection.input_offset == connection.input.size()) {
+        connection.input.clear();
+        connection.input_offset = 0;
+    } else if (connection.input_offset != 0) {
+        connection.input.erase(0, connection.input_offset);
+        connection.input_offset = 0;
+    }
+
+    // the client which does not end its line in time is not going to follow the protocol
+    if (connection.input.size() - connection.input_offset > protocol::MAX_LINE_LENGTH
+        && connection.input.find('\n', connection.input_offset) == string::npos) {
+        connection.input_closed = true;
+        connection.input.clear();
+        connection.input_offset = 0;
+        (connection.output += "ERROR Request is too long") += '\n';
+    }
+}
+
+shared_ptr<HostedGame> GameServer::find_game(const Connection &connection, const string_view &id) const {
+    uint64_t game_id;
+    if (!parse_number(id, game_id)) return nullptr;
+
+    const auto found = connection.games.find(game_id);
+    return found == connection.games.end() ? nullptr : found->second;
+}
+
+void GameServer::handle_request(Connection &connection, const string_view &line) {
+    ++requests_handled_;
+    protocol::split_tokens(line, tokens_);
+    auto &output = connection.output;
+    if (tokens_.empty()) {
+        (output += "ERROR Empty request") += '\n';
+        return;
+    }
+
+    const auto command = tokens_[0];
+    if (command == "METRICS") {
+        if (tokens_.size() != 1) {
+            (output += "ERROR Usage: METRICS") += '\n';
+            return;
+        }
+        ((output += "METRICS ") += battleships::instrumentation::format_snapshot(
+                battleships::instrumentation::take_snapshot(), battleships::instrumentation::JSON
+        )) += '\n';
+        return;
+    }
+    if (command == "NEW") {
+        if (tokens_.size() > 2) {
+            (output += "ERROR Usage: NEW [BOT]") += '\n';
+            return;
+        }
+        const auto bot_name = tokens_.size() == 2 ? string(tokens_[1]) : options_.bot;
+        const auto game_id = next_game_id_++;
+        const auto game = std::make_shared<HostedGame>(
+                configuration_, options_.field_factory, bot_name, battleships::derive_seed(options_.seed, game_id),
+                record_writer_.get()
+        );
+        if (!game->bot) {
+            ((output += "ERROR Unknown bot ") += bot_name) += '\n';
+            return;
+        }
+
+        connection.games[game_id] = game;
+        ++games_created_;
+        answer_by_worker(connection, game, [game, game_id] {
+            game->bot->place_ships();
+            return "GAME " + std::to_string(game_id);
+        });
+        return;
+    }
+
+    if (tokens_.size() < 2) {
+        (output += "ERROR Game id is expected") += '\n';
+        return;
+    }
+    const auto game = find_game(connection, tokens_[1]);
+    if (!game) {
+        (output += "ERROR Unknown game") += '\n';
+        return;
+    }
+
+    if (command == "PLACE") {
+        Coordinate coordinate(0, 0);
+        size_t size;
+        if (tokens_.size() != 6 || (tokens_[4] != "H" && tokens_[4] != "V") || !parse_number(tokens_[5], size)
+            || !parse_coordinate(tokens_[2], tokens_[3], game->player_field(), coordinate)) {
+            (output += "ERROR Usage: PLACE <id> <x> <y> <H|V> <size>") += '\n';
+            return;
+        }
+        const auto ship_count = game->ships_to_place.find(size);
+        if (ship_count == game->ships_to_place.end() || ship_count->second == 0) {
+            (output += "ERROR No ship of such size is left to place") += '\n';
+            return;
+        }
+        // the second coordinate grows upwards so vertical ships follow their first cell in this direction
+        if (!game->player_field()->try_emplace_ship(coordinate, tokens_[4] == "H" ? battleships::RIGHT
+                                                                                 : battleships::UP, size)) {
+            (output += "ERROR Ship cannot be placed there") += '\n';
+            return;
+        }
+        --ship_count->second;
+        --game->ships_left;
+        (output += "OK") += '\n';
+    } else if (command == "RANDOM") {
+        if (tokens_.size() != 2) {
+            (output += "ERROR Usage: RANDOM <id>") += '\n';
+            return;
+        }
+        if (game->ships_left == 0) {
+            (output += "ERROR All the ships have already been placed") += '\n';
+            return;
+        }
+        answer_by_worker(connection, game, [game] {
+            game->player_field()->reset();
+            battleships::place_ships_randomly(game->player_field(), game->random);
+            for (auto &ship_count : game->ships_to_place) ship_count.second = 0;
+            game->ships_left = 0;
+            return string("OK");
+        });
+    } else if (command == "ATTACK") {
+        Coordinate coordinate(0, 0);
+        if (tokens_.size() != 4 || !parse_coordinate(tokens_[2], tokens_[3], game->bot_field(), coordinate)) {
+            (output += "ERROR Usage: ATTACK <id> <x> <y>") += '\n';
+            return;
+        }
+        if (game->ships_left != 0) {
+            (output += "ERROR Not all the ships have been placed") += '\n';
+            return;
+        }
+        if (game->over) {
+            (output += "ERROR The game is over") += '\n';
+            return;
+        }
+
+        const auto status = game->bot_field()->attack(coordinate);
+        game->record_move(false, coordinate, status);
+        if (status == GameField::WIN) {
+            game->over = true;
+            game->write_record();
+        }
+        if (status != GameField::MISS) {
+            ((output += "RESULT ") += protocol::status_name(status)) += '\n';
+            return;
+        }
+
+        waiting_bot_turns_.fetch_add(1, std::memory_order_relaxed);
+        answer_by_worker(connection, game, [this, game] {
+            class AnsweringAttackCallback : public RivalBot::AttackCallback {
+                HostedGame &game_;
+                string &answer_;
+            public:
+                size_t searches = 0, evaluations = 0, interruptions = 0;
+
+                AnsweringAttackCallback(HostedGame &game, string &answer) : game_(game), answer_(answer) {}
+
+                void on_search(const battleships::SearchEffort &effort) override {
+                    ++searches;
+                    evaluations += effort.evaluations;
+                    interruptions += effort.interrupted;
+                }
+
+                void on_attack(const Coordinate &coordinate, const GameField::AttackStatus &attack_status) override {
+                    game_.record_move(true, coordinate, attack_status);
+                    ((((answer_ += ' ') += std::to_string(coordinate.x)) += ',') += std::to_string(coordinate.y))
+                            += ',';
+                    answer_ += protocol::status_name(attack_status);
+                }
+            };
+
+            const auto shot_budget = start_bot_turn();
+            string answer = "RESULT MISS";
+            AnsweringAttackCallback callback(*game, answer);
+            game->over = shot_budget.count() > 0 ? game->bot->act_within(shot_budget, &callback)
+                                                 : game->bot->act(&callback);
+            if (game->over) game->write_record();
+
+            searched_shots_.fetch_add(callback.searches, std::memory_order_relaxed);
+            search_evaluations_.fetch_add(callback.evaluations, std::memory_order_relaxed);
+            interrupted_searches_.fetch_add(callback.interruptions, std::memory_order_relaxed);
+
+            return answer;
+        });
+    } else if (command == "STATE") {
+        if (tokens_.size() != 2) {
+            (output += "ERROR Usage: STATE <id>") += '\n';
+            return;
+        }
+        string icons;
+        (((output += "STATE ") += std::to_string(configuration_.field_width)) += ' ')
+                += std::to_string(configuration_.field_height);
+        game->player_field()->get_private_icons(icons);
+        (output += ' ') += icons;
+        game->bot_field()->get_public_icons(icons);
+        ((output += ' ') += icons) += '\n';
+    } else if (command == "DROP") {
+        if (tokens_.size() != 2) {
+            (output += "ERROR Usage: DROP <id>") += '\n';
+            return;
+        }
+        uint64_t game_id;
+        if (parse_number(tokens_[1], game_id)) connection.games.erase(game_id);
+        (output += "OK") += '\n';
+    } else (output += "ERROR Unknown command") += '\n';
+}
+
+void GameServer::answer_by_worker(Connection &connection, shared_ptr<HostedGame> game,
+                                  std::function<string()> task) {
+    connection.busy = true;
+    workers_->submit([this, connection_id = connection.id, game = std::move(game), task = std::move(task)] {
+        string answer;
+        try {
+            answer = task();
+        } catch (const std::exception &exception) {
+            game->over = true;
+            answer = string("ERROR ") + exception.what();
+        }
+        complete(connection_id, std::move(answer));
+    });
+}
+
+void GameServer::complete(const uint64_t &connection_id, string answer) {
+    {
+        std::lock_guard<mutex> lock(completions_mutex_);
+        completions_.push_back({connection_id, std::move(answer)});
+    }
+
+    const uint64_t increment = 1;
+    // the descriptor can't overflow as the loop keeps reading it so the result is of no interest
+    [[maybe_unused]] const auto written = write(completion_fd_, &increment, sizeof(increment));
+}
+
+std::chrono::microseconds GameServer::start_bot_turn() noexcept {
+    // the waiting turns include this one
+    const auto waiting_turns = waiting_bot_turns_.fetch_sub(1, std::memory_order_relaxed);
+    const auto worker_count = workers_->size();
+    if (options_.shot_budget.count() == 0 || waiting_turns <= worker_count) return options_.shot_budget;
+
+    // the shots get weaker rather than the latency growing with the backlog, a microsecond is left at least
+    return std::max(std::chrono::microseconds(1),
+                    options_.shot_budget * int64_t(worker_count) / int64_t(waiting_turns));
+}
+
+void GameServer::handle_completions() {
+    uint64_t counter;
+    [[maybe_unused]] const auto read_count = read(completion_fd_, &counter, sizeof(counter));
+
+    vector<Completion> completions;
+    {
+        std::lock_guard<mutex> lock(completions_mutex_);
+        completions.swap(completions_);
+    }
+
+    for (auto &completion : completions) {
+        const auto found = connections_.find(completion.connection_id);
+        if (found == connections_.end()) continue;
+        auto &connection = *found->second;
+
+        (connection.output += completion.answer) += '\n';
+        connection.busy = false;
+        handle_input(connection);
+        update(connection);
+    }
+}
+
+void GameServer::update(Connection &connection) {
+    if (connection.pending_output() != 0) {
+        if (!write_to(connection)) return;
+        // the requests held back by the unsent output can be handled now
+        if (!connection.busy && connection.pending_output() < MAX_PENDING_OUTPUT) handle_input(connection);
+    }
+
+    if (connection.input_closed && !connection.busy && connection.pending_output() == 0) {
+        close(connection);
+        return;
+    }
+
+    uint32_t events = 0;
+    if (!connection.input_closed && !connection.busy && connection.pending_output() < MAX_PENDING_OUTPUT)
+        events |= EPOLLIN;
+    if (connection.pending_output() != 0) events |= EPOLLOUT;
+
+    if (events != connection.events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = connection.id;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event) == -1) throw_system_error("epoll_ctl");
+        connection.events = events;
+    }
+}
+
+void GameServer::close(Connection &connection) {
+    // the workers still making the moves of its games hold those and their answers get dropped
+    ::close(connection.fd);
+    connections_.erase(connection.id);
+}
+
+void print_usage() {
+    cerr << "Usage: battleships_server [--port N | --socket PATH] [--threads N] [--field simple|bitboard]"
+            " [--bot NAME] [--shot-budget MICROSECONDS] [--seed S] [--record PATH]"
+            " [--metrics PATH] [--metrics-format json|prometheus]" << endl
+         << "Available bots:";
+    for (const auto &name : battleships::rival_bot_names()) cerr << ' ' << name;
+    cerr << endl;
+}
+
+[[nodiscard]] bool is_known_bot(const string &name) {
+    const auto &names = battleships::rival_bot_names();
+    return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+bool parse_options(const int argc, char **argv, ServerOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        const string option = argv[i];
+        if (i + 1 == argc) return false;
+        const string value = argv[++i];
+
+        if (option == "--port") {
+            const auto port = std::stoul(value);
+            if (port == 0 || port > 65535) return false;
+            options.port = uint16_t(port);
+        } else if (option == "--socket") options.socket_path = value;
+        else if (option == "--threads") options.thread_count = std::max<size_t>(1, std::stoul(value));
+        else if (option == "--field") {
+            if (value == "simple") options.field_factory = TypedGameFieldFactory<SimpleGameField>::instance();
+            else if (value == "bitboard") options.field_factory = TypedGameFieldFactory<BitboardGameField>::instance();
+            else return false;
+        } else if (option == "--bot" && is_known_bot(value)) options.bot = value;
+        else if (option == "--shot-budget") options.shot_budget = std::chrono::microseconds(std::stoul(value));
+        else if (option == "--seed") options.seed = std::stoull(value);
+        else if (option == "--record") options.record_path = value;
+        else if (option == "--metrics") options.metrics_path = value;
+        else if (option == "--metrics-format") {
+            const auto format = battleships::instrumentation::parse_snapshot_format(value);
+            if (!format) return false;
+            options.metrics_format = *format;
+        }
+        else return false;
+    }
+
+    return true;
+}
+
+int main(const int argc, char **argv) {
+    ServerOptions options;
+    try {
+        if (!parse_options(argc, argv, options)) {
+            print_usage();
+            return 1;
+        }
+    } catch (const std::logic_error &) {
+        print_usage();
+        return 1;
+    }
+
+    // no restart flag so that the event loop gets interrupted by the signals
+    struct sigaction action{};
+    action.sa_handler = request_stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    try {
+        GameServer server(options);
+        server.run();
+    } catch (const std::exception &exception) {
+        cerr << "Server failure: " << exception.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,502 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "battleships/bitboard_game_field.h"
+#include "battleships/bot_scheduler.h"
+#include "battleships/chunked_game_field.h"
+#include "battleships/fixed_game_field.h"
+#include "battleships/game_configuration.h"
+#include "battleships/game_field_factory.h"
+#include "battleships/game_record.h"
+#include "battleships/instrumentation.h"
+#include "battleships/random_engine.h"
+#include "battleships/rival_bot_factory.h"
+#include "battleships/self_play.h"
+#include "battleships/simple_game.h"
+#include "battleships/simple_game_field.h"
+#include "battleships/uniform_layout_sampler.h"
+
+using std::atomic;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::mutex;
+using std::optional;
+using std::string;
+using std::thread;
+using std::vector;
+
+using battleships::BitboardGameField;
+using battleships::BotScheduler;
+using battleships::ChunkedGameField;
+using battleships::ClassicGameField;
+using battleships::Coordinate;
+using battleships::CoroutineRivalBot;
+using battleships::GameConfiguration;
+using battleships::GameField;
+using battleships::GameFieldFactory;
+using battleships::GameRecord;
+using battleships::GameRecordWriter;
+using battleships::SimpleGame;
+using battleships::SimpleGameField;
+using battleships::RandomEngine;
+using battleships::RecordingAttackCallback;
+using battleships::RivalBot;
+using battleships::TypedGameFieldFactory;
+using battleships::UniformLayoutSampler;
+
+/**
+ * @brief Options of the simulation
+ */
+struct SimulationOptions {
+    size_t game_count = 10000;
+    size_t thread_count = std::max(1u, thread::hardware_concurrency());
+    const GameFieldFactory *field_factory = TypedGameFieldFactory<BitboardGameField>::instance();
+    /**
+     * @brief Base seed from which the seeds of all games are derived
+     */
+    uint64_t seed = battleships::random_seed();
+    /**
+     * @brief Whether the seed of each game should be logged
+     */
+    bool log_seeds = false;
+    /**
+     * @brief Seed of the single game to be replayed move by move
+     */
+    optional<uint64_t> replay_seed;
+    /**
+     * @brief Names of the bot kinds playing first and second
+     */
+    string first_bot = "simple", second_bot = "simple";
+    /**
+     * @brief Whether the fleets should be drawn uniformly instead of being placed by the bots
+     */
+    bool uniform_fleets = false;
+    /**
+     * @brief Number of shots fired by the bots per turn in the salvo mode or {@code 0} for the classic turns
+     */
+    size_t salvo_shots = 0;
+    /**
+     * @brief Number of games played at once by each worker through the coroutine bots or {@code 0} to play
+     * the games one by one through the blocking bots
+     */
+    size_t coroutine_games = 0;
+    /**
+     * @brief Sampler of the fleets created once the options are parsed if those should be uniform
+     */
+    const UniformLayoutSampler *fleet_sampler = nullptr;
+    /**
+     * @brief Path of the file to append the records of the played games to if those should be recorded
+     */
+    string record_path;
+    /**
+     * @brief Writer of the records created once the options are parsed if the games should be recorded
+     */
+    GameRecordWriter *record_writer = nullptr;
+    /**
+     * @brief Path of the file to write the instrumentation counters to once the games are played if not empty,
+     * {@code -} for the standard output
+     */
+    string metrics_path;
+    battleships::instrumentation::SnapshotFormat metrics_format = battleships::instrumentation::JSON;
+};
+
+/**
+ * @brief Statistics of the games played by a single worker
+ */
+struct SimulationStatistics {
+    size_t first_wins = 0, second_wins = 0;
+    /**
+     * @brief Number of games won by the given number of shots (used as the index)
+     */
+    vector<size_t> shots_to_win;
+
+    explicit SimulationStatistics(const size_t &max_shots) : shots_to_win(max_shots + 1, 0) {}
+
+    void merge(const SimulationStatistics &other) {
+        first_wins += other.first_wins;
+        second_wins += other.second_wins;
+        for (size_t i = 0; i < shots_to_win.size(); ++i) shots_to_win[i] += other.shots_to_win[i];
+    }
+};
+
+void print_usage() {
+    cerr << "Usage: battleships_simulator [--games N] [--threads N] [--field simple|bitboard|fixed|chunked]"
+             " [--bot1 NAME] [--bot2 NAME] [--seed S] [--log-seeds] [--uniform-fleets] [--replay GAME_SEED]"
+            " [--salvo SHOTS] [--coroutines GAMES] [--record PATH] [--metrics PATH]"
+            " [--metrics-format json|prometheus]" << endl
+         << "Available bots:";
+    for (const auto &name : battleships::rival_bot_names()) cerr << ' ' << name;
+    cerr << endl;
+}
+
+[[nodiscard]] bool is_known_bot(const string &name) {
+    const auto &names = battleships::rival_bot_names();
+    return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+bool parse_options(const int argc, char **argv, SimulationOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        const string option = argv[i];
+        if (option == "--log-seeds") {
+            options.log_seeds = true;
+            continue;
+        }
+        if (option == "--uniform-fleets") {
+            options.uniform_fleets = true;
+            continue;
+        }
+        if (i + 1 == argc) return false;
+        const string value = argv[++i];
+
+        if (option == "--games") options.game_count = std::stoul(value);
+        else if (option == "--threads") options.thread_count = std::max<size_t>(1, std::stoul(value));
+        else if (option == "--field") {
+            if (value == "simple") options.field_factory = TypedGameFieldFactory<SimpleGameField>::instance();
+            else if (value == "bitboard") options.field_factory = TypedGameFieldFactory<BitboardGameField>::instance();
+            else if (value == "fixed") options.field_factory = TypedGameFieldFactory<ClassicGameField>::instance();
+            else if (value == "chunked") options.field_factory = TypedGameFieldFactory<ChunkedGameField>::instance();
+            else return false;
+        } else if (option == "--seed") options.seed = std::stoull(value);
+        else if (option == "--replay") options.replay_seed = std::stoull(value);
+        else if (option == "--salvo") options.salvo_shots = std::stoul(value);
+        else if (option == "--coroutines") options.coroutine_games = std::stoul(value);
+        else if (option == "--record") options.record_path = value;
+        else if (option == "--metrics") options.metrics_path = value;
+        else if (option == "--metrics-format") {
+            const auto format = battleships::instrumentation::parse_snapshot_format(value);
+            if (!format) return false;
+            options.metrics_format = *format;
+        }
+        else if (option == "--bot1" && is_known_bot(value)) options.first_bot = value;
+        else if (option == "--bot2" && is_known_bot(value)) options.second_bot = value;
+        else return false;
+    }
+
+    // the coroutine bots learn the result of each shot before aiming the next
+    return options.salvo_shots == 0 || options.coroutine_games == 0;
+}
+
+/**
+ * @brief Lock guarding the output of the seeds logged by the workers
+ */
+mutex seed_log_mutex;
+
+[[nodiscard]] size_t turn_limit_of(const GameConfiguration &configuration) {
+    // each bot shoots at least once per turn so the game can't take more turns than there are cells on both fields
+    return configuration.field_width * configuration.field_height * 2 + 2;
+}
+
+[[nodiscard]] uint64_t log_game_seed(const SimulationOptions &options, const size_t &game_index) {
+    const auto game_seed = battleships::derive_seed(options.seed, game_index);
+    if (options.log_seeds) {
+        std::lock_guard<mutex> lock(seed_log_mutex);
+        cerr << "Game #" << game_index << " seed " << game_seed << endl;
+    }
+
+    return game_seed;
+}
+
+/**
+ * @brief Places the fleets of the game either drawn by the sampler or by the bots themselves.
+ */
+template<typename Bot>
+void place_fleets(const SimulationOptions &options, SimpleGame &game, const uint64_t &game_seed,
+                  Bot &first, Bot &second) {
+    if (options.fleet_sampler) {
+        RandomEngine first_random(battleships::derive_seed(game_seed, 3)),
+                second_random(battleships::derive_seed(game_seed, 4));
+        options.fleet_sampler->place_ships(game.field_1(), first_random);
+        options.fleet_sampler->place_ships(game.field_2(), second_random);
+    } else {
+        first.place_ships();
+        second.place_ships();
+    }
+}
+
+/**
+ * @brief Plays a single game whose bots are seeded from the given game seed.
+ */
+battleships::SelfPlayResult play_game(const SimulationOptions &options, SimpleGame &game, const uint64_t &game_seed,
+                                      RivalBot::AttackCallback *const first_observer = nullptr,
+                                      RivalBot::AttackCallback *const second_observer = nullptr) {
+    game.reset();
+
+    const auto first = battleships::create_rival_bot(
+            options.first_bot, game.field_1(), game.field_2(), battleships::derive_seed(game_seed, 1)
+    ), second = battleships::create_rival_bot(
+            options.second_bot, game.field_2(), game.field_1(), battleships::derive_seed(game_seed, 2)
+    );
+    place_fleets(options, game, game_seed, *first, *second);
+
+    return battleships::play_bots_against_each_other(
+            *first, *second, turn_limit_of(game.configuration()), first_observer, second_observer, options.salvo_shots
+    );
+}
+
+void simulate(const SimulationOptions &options, const GameConfiguration &configuration,
+              atomic<size_t> &next_game, SimulationStatistics &statistics) {
+    SimpleGame game(configuration, options.field_factory);
+    GameRecord record(configuration);
+    RecordingAttackCallback first_recorder(&record, false), second_recorder(&record, true);
+    while (true) {
+        const auto game_index = next_game.fetch_add(1, std::memory_order_relaxed);
+        if (game_index >= options.game_count) break;
+
+        const auto game_seed = log_game_seed(options, game_index);
+        const auto recording = options.record_writer != nullptr;
+        if (recording) record.clear(game_seed);
+        const auto result = recording ? play_game(options, game, game_seed, &first_recorder, &second_recorder)
+                                      : play_game(options, game, game_seed);
+        if (recording) {
+            // the ships stay registered at the fields once sunk so the fleets are taken after the game
+            record.record_fleets(game.field_1(), game.field_2());
+            options.record_writer->write(record);
+        }
+
+        ++(result.first_won ? statistics.first_wins : statistics.second_wins);
+        ++statistics.shots_to_win[result.winner_shots()];
+    }
+}
+
+/**
+ * @brief Plays the games in batches whose games are interleaved shot by shot by the coroutine bots.
+ */
+void simulate_coroutines(const SimulationOptions &options, const GameConfiguration &configuration,
+                         atomic<size_t> &next_game, SimulationStatistics &statistics) {
+    /**
+     * @brief Game of the batch whose address is kept as it is referred to by the scheduler
+     */
+    struct Slot {
+        SimpleGame game;
+        GameRecord record;
+        RecordingAttackCallback first_recorder, second_recorder;
+        std::unique_ptr<CoroutineRivalBot> first, second;
+
+        Slot(const GameConfiguration &configuration, const GameFieldFactory *const field_factory)
+                : game(configuration, field_factory), record(configuration),
+                  first_recorder(&record, false), second_recorder(&record, true) {}
+    };
+
+    vector<std::unique_ptr<Slot>> slots;
+    BotScheduler scheduler;
+    const auto recording = options.record_writer != nullptr;
+    const auto turn_limit = turn_limit_of(configuration);
+    while (true) {
+        scheduler.clear();
+        while (scheduler.size() < options.coroutine_games) {
+            const auto game_index = next_game.fetch_add(1, std::memory_order_relaxed);
+            if (game_index >= options.game_count) break;
+
+            if (slots.size() == scheduler.size())
+                slots.push_back(std::make_unique<Slot>(configuration, options.field_factory));
+            auto &slot = *slots[scheduler.size()];
+
+            const auto game_seed = log_game_seed(options, game_index);
+            if (recording) slot.record.clear(game_seed);
+            slot.game.reset();
+            slot.first = battleships::create_coroutine_rival_bot(
+                    options.first_bot, slot.game.field_1(), slot.game.field_2(), battleships::derive_seed(game_seed, 1)
+            );
+            slot.second = battleships::create_coroutine_rival_bot(
+                    options.second_bot, slot.game.field_2(), slot.game.field_1(), battleships::derive_seed(game_seed, 2)
+            );
+            place_fleets(options, slot.game, game_seed, *slot.first, *slot.second);
+
+            scheduler.add_game(*slot.first, slot.game.field_2(), *slot.second, slot.game.field_1(), turn_limit,
+                               recording ? &slot.first_recorder : nullptr,
+                               recording ? &slot.second_recorder : nullptr);
+        }
+        if (scheduler.size() == 0) break;
+
+        scheduler.run();
+
+        for (size_t i = 0; i < scheduler.size(); ++i) {
+            const auto &result = scheduler.result(i).value();
+            if (recording) {
+                slots[i]->record.record_fleets(slots[i]->game.field_1(), slots[i]->game.field_2());
+                options.record_writer->write(slots[i]->record);
+            }
+
+            ++(result.first_won ? statistics.first_wins : statistics.second_wins);
+            ++statistics.shots_to_win[result.winner_shots()];
+        }
+    }
+}
+
+/**
+ * @brief Replays the single game printing all of its moves.
+ */
+void replay(const SimulationOptions &options, const GameConfiguration &configuration) {
+    class PrintingAttackCallback : public RivalBot::AttackCallback {
+        const char *const name_;
+    public:
+        explicit PrintingAttackCallback(const char *const name) : name_(name) {}
+
+        void on_attack(const Coordinate &coordinate, const GameField::AttackStatus &attack_status) override {
+            static const char *const STATUS_NAMES[] = {
+                    "empty already attacked", "ship already attacked", "miss", "damage", "destroy", "win"
+            };
+            cout << name_ << " attacks " << coordinate.to_string() << ": " << STATUS_NAMES[attack_status] << endl;
+        }
+    } first_observer("First"), second_observer("Second");
+
+    SimpleGame game(configuration, options.field_factory);
+    const auto seed = options.replay_seed.value();
+    const auto result = play_game(options, game, seed, &first_observer, &second_observer);
+
+    cout << "Game seed " << seed << ": " << (result.first_won ? "first" : "second")
+         << " bot has won in " << result.winner_shots() << " shots" << endl;
+    game.print_to_console();
+}
+
+void print_report(const SimulationOptions &options, const SimulationStatistics &statistics, const double &seconds) {
+    const auto games = statistics.first_wins + statistics.second_wins;
+
+    cout << std::fixed << std::setprecision(2)
+         << "Games played: " << games << " on " << options.thread_count << " thread(s)" << endl
+         << "Elapsed: " << seconds << " s" << endl
+         << "Throughput: " << double(games) / seconds << " games/s" << endl
+         << "Win rate: first " << 100.0 * double(statistics.first_wins) / double(games)
+         << "%, second " << 100.0 * double(statistics.second_wins) / double(games) << '%' << endl;
+
+    size_t total_shots = 0, min_shots = 0, max_shots = 0;
+    for (size_t shots = 0; shots < statistics.shots_to_win.size(); ++shots) {
+        const auto count = statistics.shots_to_win[shots];
+        if (count == 0) continue;
+
+        if (min_shots == 0) min_shots = shots;
+        max_shots = shots;
+        total_shots += shots * count;
+    }
+
+    const auto percentile = [&](const double &fraction) {
+        const auto threshold = size_t(fraction * double(games - 1));
+        size_t seen = 0;
+        for (size_t shots = 0; shots < statistics.shots_to_win.size(); ++shots)
+            if ((seen += statistics.shots_to_win[shots]) > threshold) return shots;
+        return max_shots;
+    };
+
+    cout << "Shots to win: mean " << double(total_shots) / double(games)
+         << ", min " << min_shots << ", p50 " << percentile(0.5) << ", p90 " << percentile(0.9)
+         << ", p99 " << percentile(0.99) << ", max " << max_shots << endl;
+
+    size_t peak = 0;
+    for (const auto count : statistics.shots_to_win) peak = std::max(peak, count);
+
+    cout << "Distribution of shots to win:" << endl;
+    for (auto shots = min_shots; shots <= max_shots; ++shots) {
+        const auto count = statistics.shots_to_win[shots];
+        cout << std::setw(5) << shots << ' ' << std::setw(8) << count << ' '
+             << string(peak == 0 ? 0 : count * 60 / peak, '#') << endl;
+    }
+}
+
+/**
+ * @brief Writes the snapshot of the instrumentation counters of the played games.
+ *
+ * @return {@code false} if the file could not be written and {@code true} otherwise
+ */
+bool write_metrics(const SimulationOptions &options) {
+    if (!battleships::instrumentation::ENABLED)
+        cerr << "The operations are not instrumented in this build, configure it with BATTLESHIPS_INSTRUMENTATION=ON"
+             << endl;
+
+    const auto metrics = battleships::instrumentation::format_snapshot(
+            battleships::instrumentation::take_snapshot(), options.metrics_format
+    );
+    if (options.metrics_path == "-") {
+        cout << metrics << endl;
+        return true;
+    }
+
+    std::ofstream out(options.metrics_path);
+    if (!(out << metrics << '\n')) {
+        cerr << "Cannot write the metrics to " << options.metrics_path << endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(const int argc, char **argv) {
+    SimulationOptions options;
+    try {
+        if (!parse_options(argc, argv, options)) {
+            print_usage();
+            return 1;
+        }
+    } catch (const std::logic_error &) {
+        print_usage();
+        return 1;
+    }
+    const auto configuration = GameConfiguration::classic();
+
+    std::unique_ptr<UniformLayoutSampler> fleet_sampler;
+    if (options.uniform_fleets) {
+        fleet_sampler = std::make_unique<UniformLayoutSampler>(configuration);
+        options.fleet_sampler = fleet_sampler.get();
+    }
+
+    std::unique_ptr<GameRecordWriter> record_writer;
+    if (!options.record_path.empty()) {
+        try {
+            record_writer = std::make_unique<GameRecordWriter>(options.record_path);
+        } catch (const std::runtime_error &error) {
+            cerr << error.what() << endl;
+            return 1;
+        }
+        options.record_writer = record_writer.get();
+    }
+
+    if (options.replay_seed) {
+        replay(options, configuration);
+        return 0;
+    }
+    if (options.game_count == 0) {
+        cerr << "No games to play" << endl;
+        return 1;
+    }
+
+    cout << "Seed: " << options.seed << endl
+         << "Bots: " << options.first_bot << " (first) vs " << options.second_bot << " (second)" << endl
+         << "Fleets: " << (options.uniform_fleets ? "uniform" : "placed by the bots") << endl;
+    if (options.salvo_shots != 0) cout << "Salvo: " << options.salvo_shots << " shots per turn" << endl;
+    if (options.coroutine_games != 0)
+        cout << "Coroutines: " << options.coroutine_games << " games at once per thread" << endl;
+
+    const auto max_shots = configuration.field_width * configuration.field_height;
+
+    atomic<size_t> next_game(0);
+    vector<SimulationStatistics> statistics(options.thread_count, SimulationStatistics(max_shots));
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        vector<thread> workers;
+        workers.reserve(options.thread_count);
+        const auto worker = options.coroutine_games == 0 ? simulate : simulate_coroutines;
+        for (size_t i = 0; i < options.thread_count; ++i) workers.emplace_back(
+                worker, std::cref(options), std::cref(configuration), std::ref(next_game), std::ref(statistics[i])
+        );
+        for (auto &worker : workers) worker.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    for (size_t i = 1; i < statistics.size(); ++i) statistics[0].merge(statistics[i]);
+    print_report(options, statistics[0], elapsed.count());
+
+    if (!options.metrics_path.empty() && !write_metrics(options)) return 1;
+
+    return 0;
+}
@@ -0,0 +1,463 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "battleships/bitboard_game_field.h"
+#include "battleships/chunked_game_field.h"
+#include "battleships/game_configuration.h"
+#include "battleships/game_field_factory.h"
+#include "battleships/random_engine.h"
+#include "battleships/rival_bot_factory.h"
+#include "battleships/self_play.h"
+#include "battleships/simple_game_pool.h"
+#include "battleships/simple_game_field.h"
+#include "battleships/thread_pool.h"
+
+using std::atomic;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::mutex;
+using std::runtime_error;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+using battleships::BitboardGameField;
+using battleships::ChunkedGameField;
+using battleships::GameConfiguration;
+using battleships::GameFieldFactory;
+using battleships::SimpleGameField;
+using battleships::SimpleGamePool;
+using battleships::ThreadPool;
+using battleships::TypedGameFieldFactory;
+
+/**
+ * @brief Outcome of a single game of the tournament as stored in the results and the journal
+ */
+enum GameOutcome : uint8_t {
+    FIRST_WON, SECOND_WON, FAILED, NOT_PLAYED
+};
+
+/**
+ * @brief Options of the tournament
+ */
+struct TournamentOptions {
+    /**
+     * @brief Names of the bot kinds taking part in the tournament
+     */
+    vector<string> bots = battleships::rival_bot_names();
+    /**
+     * @brief Specifications of the configurations at which the pairings are played
+     */
+    vector<string> configuration_specs;
+    /**
+     * @brief Number of the games played by each ordered pair of the bots at each configuration
+     */
+    size_t game_count = 100;
+    string field = "bitboard";
+    const GameFieldFactory *field_factory = TypedGameFieldFactory<BitboardGameField>::instance();
+    /**
+     * @brief Base seed from which the seeds of all games are derived
+     */
+    uint64_t seed = battleships::random_seed();
+    /**
+     * @brief Path of the journal of the played games which allows to resume the tournament
+     */
+    string journal_path;
+};
+
+/**
+ * @brief Games played by the ordered pair of the bots at a configuration
+ */
+struct Pairing {
+    size_t configuration, first, second;
+    vector<GameOutcome> outcomes;
+};
+
+void print_usage() {
+    cerr << "Usage: battleships_tournament [--bots NAME,NAME...] [--configuration SPEC]... [--games N]"
+            " [--field simple|bitboard|chunked] [--seed S] [--journal PATH]" << endl
+         << "The configuration is either 'classic' or 'WIDTHxHEIGHT:LENGTH*COUNT,...' (e.g. '8x8:1*3,2*2,3*1')"
+         << endl << "Available bots:";
+    for (const auto &name : battleships::rival_bot_names()) cerr << ' ' << name;
+    cerr << endl;
+}
+
+[[nodiscard]] vector<string> split(const string &text, const char &separator) {
+    vector<string> parts;
+    std::stringstream stream(text);
+    string part;
+    while (std::getline(stream, part, separator)) parts.push_back(part);
+
+    return parts;
+}
+
+bool parse_options(const int argc, char **argv, TournamentOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        const string option = argv[i];
+        if (i + 1 == argc) return false;
+        const string value = argv[++i];
+
+        if (option == "--bots") {
+            options.bots = split(value, ',');
+            const auto &names = battleships::rival_bot_names();
+            for (const auto &bot : options.bots)
+                if (std::find(names.begin(), names.end(), bot) == names.end()) return false;
+        } else if (option == "--configuration") options.configuration_specs.push_back(value);
+        else if (option == "--games") options.game_count = std::stoul(value);
+        else if (option == "--field") {
+            if (value == "simple") options.field_factory = TypedGameFieldFactory<SimpleGameField>::instance();
+            else if (value == "bitboard") options.field_factory = TypedGameFieldFactory<BitboardGameField>::instance();
+            else if (value == "chunked") options.field_factory = TypedGameFieldFactory<ChunkedGameField>::instance();
+            else return false;
+            options.field = value;
+        } else if (option == "--seed") options.seed = std::stoull(value);
+        else if (option == "--journal") options.journal_path = value;
+        else return false;
+    }
+    if (options.configuration_specs.empty()) options.configuration_specs.emplace_back("classic");
+
+    return options.bots.size() >= 2 && options.game_count != 0;
+}
+
+/**
+ * @brief Flag set by the signal handler once the tournament should be interrupted
+ */
+volatile std::sig_atomic_t interrupted = 0;
+
+void interrupt(int) {
+    interrupted = 1;
+}
+
+/**
+ * @brief Journal of the played games appended by the workers so that an interrupted tournament can be resumed.
+ *
+ * The journal starts with the line describing the tournament followed by a line per played game
+ * made of the indices of its configuration, first bot, second bot and game and its outcome.
+ */
+class TournamentJournal {
+
+    /**
+     * @brief Number of the entries buffered before those get written
+     */
+    constexpr static size_t FLUSH_PERIOD = 64;
+
+    std::ofstream out_;
+
+    mutex mutex_;
+
+    string buffer_;
+
+    size_t buffered_entries_ = 0;
+
+public:
+
+    /**
+     * @brief Opens the journal loading the outcomes of the games already played in it.
+     *
+     * @param path path of the journal
+     * @param description line describing the tournament
+     * @param pairings pairings of the tournament whose outcomes get loaded
+     * @param pairing_index function getting the index of the pairing by its configuration and bots
+     * @return number of the loaded outcomes
+     * @throws runtime_error if the journal belongs to another tournament
+     */
+    size_t open(const string &path, const string &description, vector<Pairing> &pairings,
+                const std::function<size_t(size_t, size_t, size_t)> &pairing_index) {
+        size_t loaded = 0;
+        std::error_code error;
+        if (std::filesystem::exists(path, error)) {
+            std::ifstream in(path, std::ios::binary);
+            string line;
+            if (!std::getline(in, line) || line != description)
+                throw runtime_error("Journal " + path + " belongs to another tournament");
+
+            // the line cut off by an interrupted write is dropped
+            auto valid_size = uint64_t(in.tellg());
+            while (std::getline(in, line)) {
+                if (in.eof()) break;
+
+                std::istringstream entry(line);
+                size_t configuration, first, second, game, outcome;
+                if (!(entry >> configuration >> first >> second >> game >> outcome)) break;
+
+                const auto index = pairing_index(configuration, first, second);
+                if (index >= pairings.size() || game >= pairings[index].outcomes.size() || outcome >= NOT_PLAYED)
+                    throw runtime_error("Journal " + path + " is corrupted");
+
+                auto &slot = pairings[index].outcomes[game];
+                if (slot == NOT_PLAYED) ++loaded;
+                slot = GameOutcome(outcome);
+                valid_size = uint64_t(in.tellg());
+            }
+            in.close();
+            std::filesystem::resize_file(path, valid_size);
+
+            out_.open(path, std::ios::binary | std::ios::app);
+        } else {
+            out_.open(path, std::ios::binary);
+            out_ << description << '\n';
+        }
+        if (!out_) throw runtime_error("Cannot open the journal " + path);
+
+        return loaded;
+    }
+
+    void append(const Pairing &pairing, const size_t &game, const GameOutcome &outcome) {
+        std::lock_guard<mutex> lock(mutex_);
+        buffer_ += std::to_string(pairing.configuration) + ' ' + std::to_string(pairing.first) + ' '
+                   + std::to_string(pairing.second) + ' ' + std::to_string(game) + ' ' + std::to_string(outcome)
+                   + '\n';
+        if (++buffered_entries_ == FLUSH_PERIOD) {
+            out_ << buffer_ << std::flush;
+            buffer_.clear();
+            buffered_entries_ = 0;
+        }
+    }
+
+    void flush() {
+        std::lock_guard<mutex> lock(mutex_);
+        out_ << buffer_ << std::flush;
+        buffer_.clear();
+        buffered_entries_ = 0;
+    }
+};
+
+[[nodiscard]] size_t turn_limit_of(const GameConfiguration &configuration) {
+    // each bot shoots at least once per turn so the game can't take more turns than there are cells on both fields
+    return configuration.field_width * configuration.field_height * 2 + 2;
+}
+
+/**
+ * @brief Plays a single game of the pairing.
+ */
+[[nodiscard]] GameOutcome play_game(const TournamentOptions &options, SimpleGamePool &games,
+                                    const Pairing &pairing, const uint64_t &game_seed) {
+    const auto game = games.acquire();
+    const auto first = battleships::create_rival_bot(
+            options.bots[pairing.first], game->field_1(), game->field_2(), battleships::derive_seed(game_seed, 1)
+    ), second = battleships::create_rival_bot(
+            options.bots[pairing.second], game->field_2(), game->field_1(), battleships::derive_seed(game_seed, 2)
+    );
+
+    try {
+        first->place_ships();
+        second->place_ships();
+
+        return battleships::play_bots_against_each_other(*first, *second, turn_limit_of(game->configuration())).first_won
+               ? FIRST_WON : SECOND_WON;
+    } catch (const std::exception &exception) {
+        cerr << "Game of " << options.bots[pairing.first] << " against " << options.bots[pairing.second]
+             << " with seed " << game_seed << " has failed: " << exception.what() << endl;
+        return FAILED;
+    }
+}
+
+/**
+ * @brief Fits the Bradley-Terry model to the scores by the minorization-maximization algorithm
+ * and converts its strengths to the Elo scale whose mean rating is 1500.
+ *
+ * @param wins number of the wins of the row bot against the column one
+ * @return ratings of the bots
+ */
+[[nodiscard]] vector<double> fit_ratings(const vector<vector<double>> &wins) {
+    const auto bot_count = wins.size();
+    // each pair is given a virtual draw so that the strengths of the bots without wins or losses stay finite
+    constexpr double PRIOR_GAMES = 1;
+
+    vector<double> strengths(bot_count, 1), next_strengths(bot_count);
+    for (size_t iteration = 0; iteration < 10000; ++iteration) {
+        double change = 0;
+        for (size_t i = 0; i < bot_count; ++i) {
+            double score = 0, weight = 0;
+            for (size_t j = 0; j < bot_count; ++j) if (i != j) {
+                const auto games = wins[i][j] + wins[j][i] + PRIOR_GAMES;
+                score += wins[i][j] + PRIOR_GAMES / 2;
+                weight += games / (strengths[i] + strengths[j]);
+            }
+            next_strengths[i] = score / weight;
+        }
+
+        double log_mean = 0;
+        for (const auto strength : next_strengths) log_mean += std::log(strength) / double(bot_count);
+        for (size_t i = 0; i < bot_count; ++i) {
+            const auto strength = next_strengths[i] / std::exp(log_mean);
+            change = std::max(change, std::abs(strength - strengths[i]) / strengths[i]);
+            strengths[i] = strength;
+        }
+        if (change < 1e-10) break;
+    }
+
+    vector<double> ratings(bot_count);
+    for (size_t i = 0; i < bot_count; ++i) ratings[i] = 1500 + 400 * std::log10(strengths[i]);
+
+    return ratings;
+}
+
+void print_ratings(const vector<string> &bots, const vector<double> &ratings) {
+    vector<size_t> order(bots.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](const size_t &a, const size_t &b) { return ratings[a] > ratings[b]; });
+
+    for (size_t place = 0; place < order.size(); ++place)
+        cout << std::setw(4) << place + 1 << ". " << std::left << std::setw(14) << bots[order[place]] << std::right
+             << std::setw(7) << std::setprecision(0) << ratings[order[place]] << endl;
+}
+
+void print_report(const TournamentOptions &options, const vector<Pairing> &pairings) {
+    const auto bot_count = options.bots.size();
+    vector<vector<double>> total_wins(bot_count, vector<double>(bot_count, 0));
+
+    for (size_t configuration = 0; configuration < options.configuration_specs.size(); ++configuration) {
+        vector<vector<double>> wins(bot_count, vector<double>(bot_count, 0));
+        size_t failed = 0, not_played = 0;
+        for (const auto &pairing : pairings) if (pairing.configuration == configuration)
+            for (const auto outcome : pairing.outcomes) switch (outcome) {
+                case FIRST_WON: ++wins[pairing.first][pairing.second]; break;
+                case SECOND_WON: ++wins[pairing.second][pairing.first]; break;
+                case FAILED: ++failed; break;
+                case NOT_PLAYED: ++not_played; break;
+            }
+
+        cout << endl << "Configuration " << options.configuration_specs[configuration] << endl
+             << "Win rates of the rows against the columns:" << endl << std::setw(14) << "";
+        for (const auto &bot : options.bots) cout << std::setw(13) << bot;
+        cout << endl << std::fixed;
+        for (size_t i = 0; i < bot_count; ++i) {
+            cout << std::left << std::setw(14) << options.bots[i] << std::right;
+            for (size_t j = 0; j < bot_count; ++j) {
+                const auto games = wins[i][j] + wins[j][i];
+                if (i == j || games == 0) cout << std::setw(13) << '-';
+                else cout << std::setw(12) << std::setprecision(1) << 100 * wins[i][j] / games << '%';
+            }
+            cout << endl;
+        }
+        if (failed != 0 || not_played != 0)
+            cout << "Failed games: " << failed << ", not played games: " << not_played << endl;
+
+        cout << "Ratings:" << endl;
+        print_ratings(options.bots, fit_ratings(wins));
+
+        for (size_t i = 0; i < bot_count; ++i) for (size_t j = 0; j < bot_count; ++j) total_wins[i][j] += wins[i][j];
+    }
+
+    if (options.configuration_specs.size() > 1) {
+        cout << endl << "Ratings over all the configurations:" << endl;
+        print_ratings(options.bots, fit_ratings(total_wins));
+    }
+}
+
+int main(const int argc, char **argv) {
+    TournamentOptions options;
+    vector<GameConfiguration> configurations;
+    // the games of each configuration are reused by the games played one after another on the same thread
+    vector<unique_ptr<SimpleGamePool>> game_pools;
+    try {
+        if (!parse_options(argc, argv, options)) {
+            print_usage();
+            return 1;
+        }
+        for (const auto &spec : options.configuration_specs) {
+            configurations.push_back(GameConfiguration::parse(spec));
+            game_pools.push_back(std::make_unique<SimpleGamePool>(configurations.back(), options.field_factory));
+        }
+    } catch (const std::logic_error &error) {
+        cerr << error.what() << endl;
+        print_usage();
+        return 1;
+    }
+
+    const auto bot_count = options.bots.size();
+    const auto pairing_index = [&](const size_t &configuration, const size_t &first, const size_t &second) {
+        if (configuration >= configurations.size() || first >= bot_count || second >= bot_count || first == second)
+            return size_t(-1);
+        return (configuration * bot_count + first) * (bot_count - 1) + second - (second > first);
+    };
+
+    vector<Pairing> pairings;
+    for (size_t configuration = 0; configuration < configurations.size(); ++configuration)
+        for (size_t first = 0; first < bot_count; ++first) for (size_t second = 0; second < bot_count; ++second)
+            if (first != second) pairings.push_back(
+                    {configuration, first, second, vector<GameOutcome>(options.game_count, NOT_PLAYED)}
+            );
+
+    TournamentJournal journal;
+    size_t games_loaded = 0;
+    if (!options.journal_path.empty()) {
+        std::ostringstream description;
+        description << "battleships-tournament 1 seed=" << options.seed << " games=" << options.game_count
+                    << " field=" << options.field << " bots=";
+        for (size_t i = 0; i < bot_count; ++i) description << (i == 0 ? "" : ",") << options.bots[i];
+        description << " configurations=";
+        for (size_t i = 0; i < configurations.size(); ++i)
+            description << (i == 0 ? "" : ";") << options.configuration_specs[i];
+
+        try {
+            games_loaded = journal.open(options.journal_path, description.str(), pairings, pairing_index);
+        } catch (const std::exception &error) {
+            cerr << error.what() << endl;
+            return 1;
+        }
+    }
+
+    const auto total_games = pairings.size() * options.game_count;
+    cout << "Seed: " << options.seed << endl
+         << "Pairings: " << pairings.size() << " of " << options.game_count << " game(s) each, "
+         << total_games - games_loaded << " game(s) to play";
+    if (games_loaded != 0) cout << " (" << games_loaded << " resumed from the journal)";
+    cout << endl;
+
+    std::signal(SIGINT, interrupt);
+    std::signal(SIGTERM, interrupt);
+
+    // each pairing's games become tasks of the worker playing the pairing which get stolen by the idle workers
+    // so that the pairings of long games do not keep the others waiting
+    auto &pool = ThreadPool::shared();
+    atomic<size_t> games_played(0);
+    const auto start = std::chrono::steady_clock::now();
+    pool.run_batch(pairings.size(), [&](const size_t &pairing_number) {
+        auto &pairing = pairings[pairing_number];
+        const auto pairing_seed = battleships::derive_seed(
+                options.seed, pairing_index(pairing.configuration, pairing.first, pairing.second)
+        );
+        pool.run_batch(options.game_count, [&](const size_t &game) {
+            if (interrupted || pairing.outcomes[game] != NOT_PLAYED) return;
+
+            const auto outcome = play_game(
+                    options, *game_pools[pairing.configuration], pairing, battleships::derive_seed(pairing_seed, game)
+            );
+            pairing.outcomes[game] = outcome;
+            games_played.fetch_add(1, std::memory_order_relaxed);
+            if (!options.journal_path.empty()) journal.append(pairing, game, outcome);
+        });
+    });
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (!options.journal_path.empty()) journal.flush();
+
+    cout << std::fixed << std::setprecision(2) << "Played " << games_played << " game(s) in " << elapsed.count()
+         << " s on " << pool.size() << " thread(s)" << endl;
+    print_report(options, pairings);
+
+    if (interrupted) {
+        cerr << endl << "The tournament has been interrupted";
+        if (options.journal_path.empty()) cerr << endl;
+        else cerr << ", run it with the same options to resume" << endl;
+        return 2;
+    }
+
+    return 0;
+}